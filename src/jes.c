@@ -1,3 +1,4 @@
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,15 +12,48 @@
 #include "jes_parser.h"
 #include "jes_serializer.h"
 
+/* Size of the node pool partition. The rest of the buffer holds the hash table. */
+static size_t jes_get_node_pool_size(struct jes_context* ctx, size_t buffer_size)
+{
+  size_t node_pool_size = (JES_SEARCH_HASHED == ctx->mode)
+                        ? buffer_size * JES_WORKSPACE_NODE_POOL_PERCENT / 100
+                        : buffer_size;
+
+#ifdef JES_ENABLE_ADAPTIVE_WORKSPACE
+  if (JES_SEARCH_HASHED == ctx->mode) {
+    /* The hash table starts with a single group, or a single slot in a small
+       workspace, and grows into the pool on demand. */
+    size_t hash_table_size = jes_hash_table_required_size(JES_HASH_TABLE_INITIAL_KEYS) + JES_ALIGNMENT - 1;
+    if (hash_table_size > buffer_size - node_pool_size) {
+      hash_table_size = jes_hash_table_required_size(1) + JES_ALIGNMENT - 1;
+    }
+    if (hash_table_size < buffer_size) {
+      node_pool_size = buffer_size - hash_table_size;
+    }
+  }
+#endif
+
+  return node_pool_size;
+}
+
 static jes_status jes_partition_workspace(struct jes_context* ctx)
 {
   jes_status status = JES_NO_ERROR;
   uint8_t* node_pool = (uint8_t*)ctx->workspace + sizeof(*ctx);
+  size_t buffer_size = ctx->workspace_size - sizeof(*ctx);
   size_t node_pool_size;
 
+#ifdef JES_ENABLE_WORKSPACE_GROW
+  if (ctx->grown_workspace != NULL) {
+    node_pool = ctx->grown_workspace;
+    buffer_size = ctx->grown_workspace_size;
+  }
+#endif
+
+  node_pool_size = jes_get_node_pool_size(ctx, buffer_size);
+
   switch (ctx->mode) {
     case JES_SEARCH_LINEAR:
-      node_pool_size = ctx->workspace_size - sizeof(*ctx);
       status = jes_tree_init(ctx, node_pool, node_pool_size);
       break;
 
@@ -28,10 +62,10 @@ static jes_status jes_partition_workspace(struct jes_context* ctx)
         size_t hash_table_size;
         uint8_t* hash_table;
 
-        node_pool_size = (ctx->workspace_size - sizeof(*ctx)) * JES_WORKSPACE_NODE_POOL_PERCENT / 100;
-        hash_table = JES_ALIGN_PTR((uint8_t*)ctx->workspace + sizeof(*ctx) + node_pool_size);
-        assert(hash_table < ((uint8_t*)ctx->workspace + ctx->workspace_size));
-        hash_table_size = (size_t)((uint8_t*)ctx->workspace + ctx->workspace_size - hash_table);
+        /* The table aligns its entries at the end of the buffer */
+        hash_table = node_pool + node_pool_size;
+        assert(hash_table < (node_pool + buffer_size));
+        hash_table_size = (size_t)(node_pool + buffer_size - hash_table);
 
         status = jes_tree_init(ctx, node_pool, node_pool_size);
         if (status == JES_NO_ERROR) {
@@ -48,12 +82,103 @@ static jes_status jes_partition_workspace(struct jes_context* ctx)
   return status;
 }
 
+#ifdef JES_ENABLE_WORKSPACE_GROW
+#if JES_WORKSPACE_NODE_POOL_PERCENT < 50
+  /* The hash table of a grown buffer must not overlap the previous buffer content. */
+  #error "JES_ENABLE_WORKSPACE_GROW requires JES_WORKSPACE_NODE_POOL_PERCENT >= 50"
+#endif
+
+jes_status jes_workspace_grow(struct jes_context* ctx)
+{
+  struct jes_node_mng_context* mng_ctx = &ctx->node_mng;
+  struct jes_hash_table_context* table = &ctx->hash_table;
+  /* Addresses of the current partitions. They are only used to rebase pointers. */
+  uintptr_t old_buffer = (uintptr_t)ctx->grown_workspace;
+  uintptr_t old_pool = (uintptr_t)mng_ctx->pool;
+  uintptr_t old_table = (uintptr_t)table->pool;
+  size_t old_table_capacity = table->capacity;
+  size_t buffer_size = (ctx->grown_workspace != NULL)
+                     ? ctx->grown_workspace_size
+                     : ctx->workspace_size - sizeof(*ctx);
+  size_t node_pool_size;
+  uint8_t* buffer = NULL;
+  uint8_t* hash_table = NULL;
+
+  if (ctx->grow_fn == NULL) {
+    return JES_OUT_OF_MEMORY;
+  }
+
+  if (JES_SEARCH_HASHED == ctx->mode) {
+    /* The old entries are moved by their control bytes */
+    jes_hash_table_renew(table);
+  }
+
+  buffer_size *= 2;
+  buffer = ctx->grow_fn(ctx->grown_workspace, buffer_size);
+  if (buffer == NULL) {
+    return JES_OUT_OF_MEMORY;
+  }
+  assert(JES_IS_ALIGNED(buffer));
+
+  if (ctx->grown_workspace == NULL) {
+    /* The pool leaves the workspace */
+    memcpy(buffer, mng_ctx->pool, mng_ctx->next_free * sizeof(struct jes_node));
+  }
+  else {
+    /* The grow callback preserved the buffer content. The pool stays in front,
+       the old hash table is read from its previous offset. */
+    old_table = (uintptr_t)buffer + (old_table - old_buffer);
+  }
+  ctx->grown_workspace = buffer;
+  ctx->grown_workspace_size = buffer_size;
+
+#define JES_REBASE(type_, ptr_) \
+  ((type_*)((uintptr_t)mng_ctx->pool + ((uintptr_t)(ptr_) - old_pool)))
+
+  node_pool_size = jes_get_node_pool_size(ctx, buffer_size);
+#ifdef JES_ENABLE_ADAPTIVE_WORKSPACE
+  if (JES_SEARCH_HASHED == ctx->mode) {
+    /* The hash table doubles. It gives memory back to the pool on demand. */
+    node_pool_size = buffer_size - ((table->size < buffer_size / 4) ? 2 * table->size : buffer_size / 2);
+  }
+#endif
+  jes_tree_resize(mng_ctx, buffer, node_pool_size);
+
+  if (mng_ctx->root != NULL) {
+    mng_ctx->root = JES_REBASE(struct jes_node, mng_ctx->root);
+  }
+  if (ctx->serdes.iter != NULL) {
+    ctx->serdes.iter = JES_REBASE(struct jes_node, ctx->serdes.iter);
+  }
+  if (mng_ctx->freed != NULL) {
+    mng_ctx->freed = JES_REBASE(struct jes_freed_node, mng_ctx->freed);
+  }
+
+  if (JES_SEARCH_HASHED == ctx->mode) {
+    /* The new hash table is placed behind the previous buffer content, so the
+       old entries can still be read while they are moved. */
+    hash_table = buffer + node_pool_size;
+    assert((uintptr_t)hash_table >= (uintptr_t)buffer + buffer_size / 2);
+    jes_hash_table_resize(table, hash_table, (size_t)(buffer + buffer_size - hash_table));
+    jes_hash_table_move_entries(ctx, (struct jes_hash_entry*)old_table, old_table_capacity, old_pool);
+  }
+#undef JES_REBASE
+
+  return JES_NO_ERROR;
+}
+#endif
+
 struct jes_context* jes_init(void* buffer, size_t buffer_size, enum jes_search_mode mode)
 {
   struct jes_context* ctx = buffer;
 
   static_assert(sizeof(struct jes_context) == JES_CONTEXT_SIZE);
   static_assert(sizeof(struct jes_node) == JES_NODE_SIZE);
+  static_assert(sizeof(struct jes_freed_node) <= sizeof(struct jes_node));
+#ifdef JES_USE_COMPACT_NODE
+  /* Holder nodes keep their descriptors intact for jes_compact(). */
+  static_assert(sizeof(struct jes_value_holder) <= sizeof(struct jes_element));
+#endif
 
   if ((buffer == NULL) || buffer_size < sizeof(struct jes_context)) {
     return NULL;
@@ -78,17 +203,106 @@ struct jes_context* jes_init(void* buffer, size_t buffer_size, enum jes_search_m
   return ctx;
 }
 
-jes_status jes_reset(struct jes_context* ctx)
+#ifdef JES_ENABLE_WORKSPACE_GROW
+struct jes_context* jes_init_growable(void* buffer, size_t buffer_size,
+                                      enum jes_search_mode mode,
+                                      jes_workspace_grow_fn grow)
 {
-  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
-    return JES_INVALID_CONTEXT;
+  struct jes_context* ctx = jes_init(buffer, buffer_size, mode);
+
+  if (ctx != NULL) {
+    ctx->grow_fn = grow;
   }
+  return ctx;
+}
+#endif
 
+/* Clears the tree. A grown workspace is kept. */
+static jes_status jes_clear(struct jes_context* ctx)
+{
   ctx->serdes.tokenizer.json_data = NULL;
   ctx->serdes.tokenizer.json_length = 0;
   ctx->serdes.iter = NULL;
+#ifdef JES_ENABLE_FILE_MAPPING
+  jes_unmap_file(ctx);
+#endif
+
+  return jes_partition_workspace(ctx);
+}
+
+jes_status jes_reset(struct jes_context* ctx)
+{
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return JES_INVALID_CONTEXT;
+  }
+
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return ctx->status;
+  }
+
+#ifdef JES_ENABLE_WORKSPACE_GROW
+  if (ctx->grown_workspace != NULL) {
+    ctx->grow_fn(ctx->grown_workspace, 0);
+    ctx->grown_workspace = NULL;
+    ctx->grown_workspace_size = 0;
+  }
+#endif
+
+  ctx->status = jes_clear(ctx);
+
+  return ctx->status;
+}
+
+jes_status jes_freeze(struct jes_context* ctx)
+{
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return JES_INVALID_CONTEXT;
+  }
+
+  ctx->status = JES_NO_ERROR;
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+  /* Lookups of a frozen context do not build the index. */
+  if (!ctx->frozen) {
+    jes_hash_table_build(ctx, false);
+  }
+#endif
+  ctx->frozen = true;
+  return ctx->status;
+}
+
+jes_status jes_compact(struct jes_context* ctx)
+{
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return JES_INVALID_CONTEXT;
+  }
+
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return ctx->status;
+  }
+
+  return jes_tree_compact(ctx);
+}
+
+jes_status jes_set_hash_seed(struct jes_context* ctx, uint32_t seed)
+{
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return JES_INVALID_CONTEXT;
+  }
 
-  ctx->status = jes_partition_workspace(ctx);
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return ctx->status;
+  }
+
+  ctx->status = JES_NO_ERROR;
+  if (ctx->hash_table.seed != seed) {
+    ctx->hash_table.seed = seed;
+    if (JES_SEARCH_HASHED == ctx->mode) {
+      ctx->status = jes_hash_table_rehash(ctx);
+    }
+  }
 
   return ctx->status;
 }
@@ -107,7 +321,7 @@ enum jes_type jes_get_parent_type(struct jes_context* ctx, struct jes_element* e
     return JES_UNKNOWN;
   }
 
-  if ((element == NULL) || !jes_validate_node(ctx, (struct jes_node*)element)) {
+  if (jes_tree_get_element_node(ctx, element) == NULL) {
     ctx->status = JES_INVALID_PARAMETER;
     return JES_UNKNOWN;
   }
@@ -122,18 +336,26 @@ enum jes_type jes_get_parent_type(struct jes_context* ctx, struct jes_element* e
 
 struct jes_element* jes_get_parent(struct jes_context* ctx, struct jes_element* element)
 {
+  struct jes_node* node = NULL;
+
   if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
     return NULL;
   }
 
-  if ((element == NULL) || !jes_validate_node(ctx, (struct jes_node*)element)) {
+  node = jes_tree_get_element_node(ctx, element);
+  if (node == NULL) {
     ctx->status = JES_INVALID_PARAMETER;
     return NULL;
   }
 
-  struct jes_node* parent = jes_tree_get_parent_node(ctx, (struct jes_node*)element);
+  if (IS_VALUE_ELEMENT(node, element)) {
+    /* The value of a merged member belongs to its key. */
+    return &node->json_tlv;
+  }
+
+  struct jes_node* parent = jes_tree_get_parent_node(ctx, node);
   if (parent) {
-    return (struct jes_element*)parent;
+    return NODE_VALUE_ELEMENT(parent);
   }
 
   return NULL;
@@ -145,14 +367,20 @@ struct jes_element* jes_get_sibling(struct jes_context* ctx, struct jes_element*
     return NULL;
   }
 
-  if ((element == NULL) || !jes_validate_node(ctx, (struct jes_node*)element)) {
+  struct jes_node* node = jes_tree_get_element_node(ctx, element);
+  if (node == NULL) {
     ctx->status = JES_INVALID_PARAMETER;
     return NULL;
   }
 
-  struct jes_node* sibling = jes_tree_get_sibling_node(ctx, (struct jes_node*)element);
+  if (IS_VALUE_ELEMENT(node, element)) {
+    /* The value of a merged member has no siblings. */
+    return NULL;
+  }
+
+  struct jes_node* sibling = jes_tree_get_sibling_node(ctx, node);
   if (sibling) {
-    return (struct jes_element*)sibling;
+    return &sibling->json_tlv;
   }
 
   return NULL;
@@ -164,32 +392,293 @@ struct jes_element* jes_get_child(struct jes_context* ctx, struct jes_element* e
     return NULL;
   }
 
-  if ((element == NULL) || !jes_validate_node(ctx, (struct jes_node*)element)) {
+  struct jes_node* node = jes_tree_get_element_node(ctx, element);
+  if (node == NULL) {
     ctx->status = JES_INVALID_PARAMETER;
     return NULL;
   }
 
-  struct jes_node* child = jes_tree_get_child_node(ctx, (struct jes_node*)element);
+  if (element->type == JES_KEY) {
+    struct jes_node* value = GET_KEY_VALUE_NODE(ctx->node_mng, node);
+    return (value != NULL) ? NODE_VALUE_ELEMENT(value) : NULL;
+  }
+
+  struct jes_node* child = jes_tree_get_child_node(ctx, node);
   if (child) {
-    return (struct jes_element*)child;
+    return &child->json_tlv;
   }
 
   return NULL;
 }
 
+const char* jes_get_element_value(struct jes_context* ctx, struct jes_element* element)
+{
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return NULL;
+  }
+
+  if (jes_tree_get_element_node(ctx, element) == NULL) {
+    ctx->status = JES_INVALID_PARAMETER;
+    return NULL;
+  }
+
+  return JES_ELEMENT_VALUE(ctx, element);
+}
+
+jes_status jes_iterator_init(struct jes_context* ctx, struct jes_iterator* iterator, struct jes_element* element)
+{
+  struct jes_node* node = NULL;
+
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return JES_INVALID_CONTEXT;
+  }
+
+  if (iterator == NULL) {
+    return JES_INVALID_PARAMETER;
+  }
+
+  iterator->ctx = ctx;
+  iterator->start = NULL;
+  iterator->element = NULL;
+  iterator->event = JES_ITERATOR_END;
+  iterator->is_value = false;
+
+  node = jes_tree_get_element_node(ctx, element);
+  if (node == NULL) {
+    return JES_INVALID_PARAMETER;
+  }
+
+  /* The start element with the END event marks a traversal that has not begun */
+  iterator->start = element;
+  iterator->element = element;
+  iterator->is_value = IS_VALUE_ELEMENT(node, element);
+  return JES_NO_ERROR;
+}
+
+enum jes_iterator_event jes_iterator_next_unchecked(struct jes_iterator* iterator)
+{
+  struct jes_node* node = NULL;
+  struct jes_node* next = NULL;
+
+  assert(iterator != NULL);
+
+  if (iterator->element == NULL) {
+    return JES_ITERATOR_END;
+  }
+
+  if (iterator->event == JES_ITERATOR_END) {
+    iterator->event = JES_ITERATOR_ENTER;
+    return JES_ITERATOR_ENTER;
+  }
+
+  node = (struct jes_node*)iterator->element;
+#ifdef JES_USE_MERGED_KEY_NODE
+  if (iterator->is_value) {
+    node = (struct jes_node*)((uintptr_t)iterator->element - offsetof(struct jes_node, value_tlv));
+  }
+#endif
+
+  if (iterator->event == JES_ITERATOR_ENTER) {
+#ifdef JES_USE_MERGED_KEY_NODE
+    if ((NODE_TYPE(node) == JES_KEY) && !iterator->is_value) {
+      /* The value of a member is embedded in the key node */
+      if (node->value_tlv.type != JES_UNKNOWN) {
+        iterator->element = &node->value_tlv;
+        iterator->is_value = true;
+        return JES_ITERATOR_ENTER;
+      }
+      iterator->event = JES_ITERATOR_LEAVE;
+      return JES_ITERATOR_LEAVE;
+    }
+#endif
+    next = GET_FIRST_CHILD(iterator->ctx->node_mng, node);
+    if (next != NULL) {
+      iterator->element = &next->json_tlv;
+      iterator->is_value = false;
+      return JES_ITERATOR_ENTER;
+    }
+    iterator->event = JES_ITERATOR_LEAVE;
+    return JES_ITERATOR_LEAVE;
+  }
+
+  /* Leaving the current element */
+  if (iterator->element == iterator->start) {
+    iterator->element = NULL;
+    iterator->event = JES_ITERATOR_END;
+    return JES_ITERATOR_END;
+  }
+
+#ifdef JES_USE_MERGED_KEY_NODE
+  if (iterator->is_value) {
+    iterator->element = &node->json_tlv;
+    iterator->is_value = false;
+    return JES_ITERATOR_LEAVE;
+  }
+#endif
+
+  next = GET_SIBLING(iterator->ctx->node_mng, node);
+  if (next != NULL) {
+    iterator->element = &next->json_tlv;
+    iterator->event = JES_ITERATOR_ENTER;
+    return JES_ITERATOR_ENTER;
+  }
+
+  next = GET_PARENT(iterator->ctx->node_mng, node);
+  assert(next != NULL);
+  iterator->element = NODE_VALUE_ELEMENT(next);
+  iterator->is_value = IS_VALUE_ELEMENT(next, iterator->element);
+  return JES_ITERATOR_LEAVE;
+}
+
+enum jes_iterator_event jes_iterator_next(struct jes_iterator* iterator)
+{
+  if ((iterator == NULL) || (iterator->ctx == NULL) || !JES_IS_INITIATED(iterator->ctx)) {
+    return JES_ITERATOR_END;
+  }
+
+  if ((iterator->element != NULL) &&
+      ((jes_tree_get_element_node(iterator->ctx, iterator->element) == NULL) || (iterator->element->type == JES_UNKNOWN))) {
+    /* The current element has been deleted or the workspace has moved */
+    iterator->ctx->status = JES_INVALID_PARAMETER;
+    iterator->element = NULL;
+    iterator->event = JES_ITERATOR_END;
+    return JES_ITERATOR_END;
+  }
+
+  return jes_iterator_next_unchecked(iterator);
+}
+
+/* Handles are only checked in debug builds */
+#define JES_ASSERT_HANDLE(ctx_, handle_) \
+  assert(((ctx_) != NULL) && JES_IS_INITIATED(ctx_) && \
+         (JES_HANDLE_INDEX(handle_) < (ctx_)->node_mng.capacity) && \
+         (jes_get_handle_element(ctx_, handle_)->type != JES_UNKNOWN))
+
+jes_handle jes_get_element_handle(struct jes_context* ctx, struct jes_element* element)
+{
+  struct jes_node* node = NULL;
+
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return JES_INVALID_HANDLE;
+  }
+
+  node = jes_tree_get_element_node(ctx, element);
+  if (node == NULL) {
+    ctx->status = JES_INVALID_PARAMETER;
+    return JES_INVALID_HANDLE;
+  }
+
+#ifdef JES_USE_MERGED_KEY_NODE
+  if (IS_VALUE_ELEMENT(node, element)) {
+    return JES_VALUE_HANDLE(JES_NODE_INDEX(ctx->node_mng, node));
+  }
+#endif
+  return JES_NODE_HANDLE(JES_NODE_INDEX(ctx->node_mng, node));
+}
+
+struct jes_element* jes_get_handle_element(struct jes_context* ctx, jes_handle handle)
+{
+  assert(ctx != NULL);
+
+  if (handle == JES_INVALID_HANDLE) {
+    return NULL;
+  }
+#ifdef JES_USE_MERGED_KEY_NODE
+  if (JES_HANDLE_IS_VALUE(handle)) {
+    return &ctx->node_mng.pool[JES_HANDLE_INDEX(handle)].value_tlv;
+  }
+#endif
+  return &ctx->node_mng.pool[JES_HANDLE_INDEX(handle)].json_tlv;
+}
+
+jes_handle jes_get_root_handle(struct jes_context* ctx)
+{
+  assert((ctx != NULL) && JES_IS_INITIATED(ctx));
+
+  if (ctx->node_mng.root == NULL) {
+    return JES_INVALID_HANDLE;
+  }
+  return JES_NODE_HANDLE(JES_NODE_INDEX(ctx->node_mng, ctx->node_mng.root));
+}
+
+jes_handle jes_get_parent_handle(struct jes_context* ctx, jes_handle handle)
+{
+  struct jes_node* node = NULL;
+
+  JES_ASSERT_HANDLE(ctx, handle);
+
+  node = &ctx->node_mng.pool[JES_HANDLE_INDEX(handle)];
+  if (JES_HANDLE_IS_VALUE(handle)) {
+    /* The value of a merged member belongs to its key. */
+    return JES_NODE_HANDLE(JES_HANDLE_INDEX(handle));
+  }
+
+  if (!HAS_PARENT(node)) {
+    return JES_INVALID_HANDLE;
+  }
+#ifdef JES_USE_MERGED_KEY_NODE
+  if (NODE_TYPE(&ctx->node_mng.pool[node->parent]) == JES_KEY) {
+    /* Children of a member value are linked to the key node */
+    return JES_VALUE_HANDLE(node->parent);
+  }
+#endif
+  return JES_NODE_HANDLE(node->parent);
+}
+
+jes_handle jes_get_child_handle(struct jes_context* ctx, jes_handle handle)
+{
+  struct jes_node* node = NULL;
+
+  JES_ASSERT_HANDLE(ctx, handle);
+
+  node = &ctx->node_mng.pool[JES_HANDLE_INDEX(handle)];
+#ifdef JES_USE_MERGED_KEY_NODE
+  if (!JES_HANDLE_IS_VALUE(handle) && (NODE_TYPE(node) == JES_KEY)) {
+    return (node->value_tlv.type != JES_UNKNOWN) ? JES_VALUE_HANDLE(JES_HANDLE_INDEX(handle)) : JES_INVALID_HANDLE;
+  }
+#endif
+  return HAS_CHILD(node) ? JES_NODE_HANDLE(node->first_child) : JES_INVALID_HANDLE;
+}
+
+jes_handle jes_get_sibling_handle(struct jes_context* ctx, jes_handle handle)
+{
+  struct jes_node* node = NULL;
+
+  JES_ASSERT_HANDLE(ctx, handle);
+
+  if (JES_HANDLE_IS_VALUE(handle)) {
+    /* The value of a merged member has no siblings. */
+    return JES_INVALID_HANDLE;
+  }
+
+  node = &ctx->node_mng.pool[JES_HANDLE_INDEX(handle)];
+  return HAS_SIBLING(node) ? JES_NODE_HANDLE(node->sibling) : JES_INVALID_HANDLE;
+}
+
 jes_status jes_delete_element(struct jes_context* ctx, struct jes_element* element)
 {
+  struct jes_node* node = NULL;
+
   if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
     return JES_INVALID_CONTEXT;
   }
 
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return ctx->status;
+  }
+
   ctx->status = JES_NO_ERROR;
 
-  if ((element == NULL) || (!jes_validate_node(ctx, (struct jes_node*)element))) {
+  node = jes_tree_get_element_node(ctx, element);
+  if (node == NULL) {
       ctx->status = JES_INVALID_PARAMETER;
   }
+  else if (IS_VALUE_ELEMENT(node, element)) {
+    jes_tree_delete_key_value(ctx, node);
+  }
   else {
-    jes_tree_delete_node(ctx, (struct jes_node*)element);
+    jes_tree_delete_node(ctx, node);
   }
 
   return ctx->status;
@@ -197,12 +686,24 @@ jes_status jes_delete_element(struct jes_context* ctx, struct jes_element* eleme
 
 struct jes_element* jes_get_value(struct jes_context* ctx, struct jes_element* parent, const char* path)
 {
-  struct jes_element* key = jes_get_key(ctx, parent, path);
+  if (!ctx || !JES_IS_INITIATED(ctx)) {
+    return NULL;
+  }
+
+  return jes_get_value_r(ctx, parent, path, &ctx->status);
+}
+
+struct jes_element* jes_get_value_r(struct jes_context* ctx, struct jes_element* parent, const char* path, jes_status* status)
+{
+  struct jes_element* key = jes_get_key_r(ctx, parent, path, status);
   struct jes_element* value = NULL;
+  struct jes_node* value_node = NULL;
 
   if (NULL != key) {
-    value = (struct jes_element*)GET_FIRST_CHILD(ctx->node_mng,
-                                                 (struct jes_node*)key);
+    value_node = GET_KEY_VALUE_NODE(ctx->node_mng, (struct jes_node*)key);
+    if (value_node != NULL) {
+      value = NODE_VALUE_ELEMENT(value_node);
+    }
   }
 
   return value;
@@ -227,34 +728,53 @@ static inline size_t jes_get_key_len_before_char(const char* path, char symbol)
 }
 
 struct jes_element* jes_get_key(struct jes_context* ctx, struct jes_element* parent, const char* path)
+{
+  if (!ctx || !JES_IS_INITIATED(ctx)) {
+    return NULL;
+  }
+
+  return jes_get_key_r(ctx, parent, path, &ctx->status);
+}
+
+struct jes_element* jes_get_key_r(struct jes_context* ctx, struct jes_element* parent, const char* path, jes_status* status)
 {
   struct jes_element* target_key = NULL;
-  struct jes_node* iter = (struct jes_node*)parent;
+  struct jes_node* iter = NULL;
   size_t key_len;
   const char* key_name;
-  char* separator;
+  jes_status local_status;
+
+  if (status == NULL) {
+    status = &local_status;
+  }
 
   if (!ctx || !JES_IS_INITIATED(ctx)) {
+    *status = JES_INVALID_CONTEXT;
     return NULL;
   }
 
-  if ((parent == NULL) || (!jes_validate_node(ctx, (struct jes_node*)parent)) || (path == NULL)) {
-    ctx->status = JES_INVALID_PARAMETER;
+  iter = jes_tree_get_element_node(ctx, parent);
+  if ((iter == NULL) || (path == NULL)) {
+    *status = JES_INVALID_PARAMETER;
     return NULL;
   }
 
   key_len = strnlen(path, JES_MAX_PATH_LENGTH);
   if (key_len == JES_MAX_PATH_LENGTH) {
-    ctx->status = JES_PATH_TOO_LONG;
+    *status = JES_PATH_TOO_LONG;
     return NULL;
   }
 
   if ((parent->type != JES_OBJECT) && (parent->type != JES_KEY)) {
-    ctx->status = JES_INVALID_PARAMETER;
+    *status = JES_INVALID_PARAMETER;
     return NULL;
   }
 
-  ctx->status = JES_NO_ERROR;
+  *status = JES_NO_ERROR;
+
+  if (parent->type == JES_KEY) {
+    iter = GET_KEY_VALUE_NODE(ctx->node_mng, iter);
+  }
 
   /* The path will be break into several keywords separated by a predefined separator symbol.
      The search is only successful When all keys in the path are found. */
@@ -263,10 +783,6 @@ struct jes_element* jes_get_key(struct jes_context* ctx, struct jes_element* par
     key_len = jes_get_key_len_before_char(path, ctx->path_separator);
     path += key_len; /* This set the path to the NUL terminator or the separator. */
 
-    if (NODE_TYPE(iter) == JES_KEY) {
-      iter = GET_FIRST_CHILD(ctx->node_mng, iter);
-    }
-
     iter = ctx->node_mng.find_key_fn(ctx, iter, key_name, key_len);
 
     /* This was the last element to find. */
@@ -275,15 +791,154 @@ struct jes_element* jes_get_key(struct jes_context* ctx, struct jes_element* par
       break;
     }
 
-    /* The path points to a separator move it on char forward to get the next key. */
-    path += sizeof(char); /* +1 byte for the size of separator symbol */
+    /* The path points to a separator move it on char forward to get the next key. */
+    path += sizeof(char); /* +1 byte for the size of separator symbol */
+
+    if (iter != NULL) {
+      /* Continue the search in the value of the found key. */
+      iter = GET_KEY_VALUE_NODE(ctx->node_mng, iter);
+    }
+  }
+
+  if (target_key == NULL) {
+    *status = JES_ELEMENT_NOT_FOUND;
+  }
+
+  return target_key;
+}
+
+jes_status jes_compile_path(struct jes_context* ctx, const char* path, struct jes_path* compiled)
+{
+  size_t path_len;
+  size_t key_len;
+  struct jes_path_key* key;
+
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return JES_INVALID_CONTEXT;
+  }
+
+  if ((path == NULL) || (compiled == NULL)) {
+    return JES_INVALID_PARAMETER;
+  }
+
+  compiled->key_count = 0;
+  compiled->seed = ctx->hash_table.seed;
+
+  path_len = strnlen(path, JES_MAX_PATH_LENGTH);
+  if (path_len == JES_MAX_PATH_LENGTH) {
+    return JES_PATH_TOO_LONG;
+  }
+
+  for (;;) {
+    if (compiled->key_count == JES_MAX_PATH_KEYS) {
+      compiled->key_count = 0;
+      return JES_PATH_TOO_LONG;
+    }
+    key_len = jes_get_key_len_before_char(path, ctx->path_separator);
+    key = &compiled->keys[compiled->key_count++];
+    key->keyword = path;
+    key->length = key_len;
+    key->hash = jes_hash_table_hash_keyword(compiled->seed, path, key_len);
+
+    path += key_len;
+    if (*path == '\0') {
+      break;
+    }
+    /* Skip the separator */
+    path += sizeof(char);
+  }
+
+  return JES_NO_ERROR;
+}
+
+struct jes_element* jes_get_key_compiled(struct jes_context* ctx, struct jes_element* parent, const struct jes_path* compiled)
+{
+  if (!ctx || !JES_IS_INITIATED(ctx)) {
+    return NULL;
+  }
+
+  return jes_get_key_compiled_r(ctx, parent, compiled, &ctx->status);
+}
+
+struct jes_element* jes_get_key_compiled_r(struct jes_context* ctx, struct jes_element* parent, const struct jes_path* compiled, jes_status* status)
+{
+  struct jes_node* iter = NULL;
+  const struct jes_path_key* key;
+  size_t index;
+  bool hashed;
+  jes_status local_status;
+
+  if (status == NULL) {
+    status = &local_status;
+  }
+
+  if (!ctx || !JES_IS_INITIATED(ctx)) {
+    *status = JES_INVALID_CONTEXT;
+    return NULL;
+  }
+
+  iter = jes_tree_get_element_node(ctx, parent);
+  if ((iter == NULL) || (compiled == NULL) || (compiled->key_count == 0) ||
+      (compiled->key_count > JES_MAX_PATH_KEYS)) {
+    *status = JES_INVALID_PARAMETER;
+    return NULL;
+  }
+
+  if ((parent->type != JES_OBJECT) && (parent->type != JES_KEY)) {
+    *status = JES_INVALID_PARAMETER;
+    return NULL;
+  }
+
+  *status = JES_NO_ERROR;
+
+  if (parent->type == JES_KEY) {
+    iter = GET_KEY_VALUE_NODE(ctx->node_mng, iter);
+  }
+
+  /* Keys hashed with another seed are hashed again by the lookup. */
+  hashed = (JES_SEARCH_HASHED == ctx->mode) && (compiled->seed == ctx->hash_table.seed);
+
+  for (index = 0; (index < compiled->key_count) && (iter != NULL); index++) {
+    key = &compiled->keys[index];
+    if (hashed) {
+      iter = jes_hash_table_find_hashed_key(ctx, iter, key->keyword, key->length, key->hash);
+    }
+    else {
+      iter = ctx->node_mng.find_key_fn(ctx, iter, key->keyword, key->length);
+    }
+
+    if ((iter != NULL) && (index + 1 < compiled->key_count)) {
+      /* Continue the search in the value of the found key. */
+      iter = GET_KEY_VALUE_NODE(ctx->node_mng, iter);
+    }
+  }
+
+  if (iter == NULL) {
+    *status = JES_ELEMENT_NOT_FOUND;
   }
 
-  if (target_key == NULL) {
-    ctx->status = JES_ELEMENT_NOT_FOUND;
+  return (struct jes_element*)iter;
+}
+
+struct jes_element* jes_get_value_compiled(struct jes_context* ctx, struct jes_element* parent, const struct jes_path* compiled)
+{
+  if (!ctx || !JES_IS_INITIATED(ctx)) {
+    return NULL;
   }
 
-  return target_key;
+  return jes_get_value_compiled_r(ctx, parent, compiled, &ctx->status);
+}
+
+struct jes_element* jes_get_value_compiled_r(struct jes_context* ctx, struct jes_element* parent, const struct jes_path* compiled, jes_status* status)
+{
+  struct jes_element* key = jes_get_key_compiled_r(ctx, parent, compiled, status);
+  struct jes_node* value_node = NULL;
+
+  if (NULL != key) {
+    value_node = GET_KEY_VALUE_NODE(ctx->node_mng, (struct jes_node*)key);
+  }
+
+  return (value_node != NULL) ? NODE_VALUE_ELEMENT(value_node) : NULL;
 }
 
 struct jes_element* jes_get_key_value(struct jes_context* ctx, struct jes_element* key)
@@ -294,53 +949,71 @@ struct jes_element* jes_get_key_value(struct jes_context* ctx, struct jes_elemen
     return NULL;
   }
 
-  if ((key == NULL) || (!jes_validate_node(ctx, (struct jes_node*)key)) || (key->type != JES_KEY)) {
+  if ((jes_tree_get_element_node(ctx, key) == NULL) || (key->type != JES_KEY)) {
     ctx->status = JES_INVALID_PARAMETER;
     return NULL;
   }
 
-  node = GET_FIRST_CHILD(ctx->node_mng, (struct jes_node*)key);
-  return (struct jes_element*)node;
+  node = GET_KEY_VALUE_NODE(ctx->node_mng, (struct jes_node*)key);
+  return (node != NULL) ? NODE_VALUE_ELEMENT(node) : NULL;
 }
 
 size_t jes_get_array_size(struct jes_context* ctx, struct jes_element* array)
 {
-  size_t array_size = 0;
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return 0;
+  }
+
+  return jes_get_array_size_r(ctx, array, &ctx->status);
+}
+
+size_t jes_get_array_size_r(struct jes_context* ctx, struct jes_element* array, jes_status* status)
+{
   struct jes_node* iter = NULL;
+  jes_status local_status;
+
+  if (status == NULL) {
+    status = &local_status;
+  }
 
   if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    *status = JES_INVALID_CONTEXT;
     return 0;
   }
 
-  ctx->status = JES_NO_ERROR;
+  *status = JES_NO_ERROR;
 
-  if ((array == NULL) || (!jes_validate_node(ctx, (struct jes_node*)array)) || (array->type != JES_ARRAY)) {
-    ctx->status = JES_INVALID_PARAMETER;
+  iter = jes_tree_get_element_node(ctx, array);
+  if ((iter == NULL) || (array->type != JES_ARRAY)) {
+    *status = JES_INVALID_PARAMETER;
     return 0;
   }
 
-  iter = GET_FIRST_CHILD(ctx->node_mng, (struct jes_node*)array);
-  if (iter) {
-    for (array_size = 0; iter != NULL; array_size++) {
-      iter = GET_SIBLING(ctx->node_mng, iter);
-    }
+  return jes_tree_get_child_count(ctx, iter);
+}
+
+struct jes_element* jes_get_array_value(struct jes_context* ctx, struct jes_element* array, int32_t index)
+{
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return NULL;
   }
 
-  return array_size;
+  return jes_get_array_value_r(ctx, array, index, &ctx->status);
 }
 
-struct jes_element* jes_get_array_value(struct jes_context* ctx, struct jes_element* array, int32_t index)
+struct jes_element* jes_get_array_value_r(struct jes_context* ctx, struct jes_element* array, int32_t index, jes_status* status)
 {
   struct jes_node* iter = NULL;
   size_t array_size;
+  jes_status local_status;
 
-  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
-    return NULL;
+  if (status == NULL) {
+    status = &local_status;
   }
 
-  array_size = jes_get_array_size(ctx, array);
+  array_size = jes_get_array_size_r(ctx, array, status);
 
-  if (ctx->status != JES_NO_ERROR) {
+  if (*status != JES_NO_ERROR) {
     return NULL;
   }
 
@@ -351,33 +1024,36 @@ struct jes_element* jes_get_array_value(struct jes_context* ctx, struct jes_elem
   }
 
   if ((index < 0) || (index >= array_size)) {
-    ctx->status = JES_ELEMENT_NOT_FOUND;
+    *status = JES_ELEMENT_NOT_FOUND;
     return NULL;
   }
 
-  iter = GET_FIRST_CHILD(ctx->node_mng, (struct jes_node*)array);
-  for (; iter && index > 0; index--) {
-    iter = GET_SIBLING(ctx->node_mng, iter);
-  }
+  iter = jes_tree_get_child_node_at(ctx, jes_tree_get_element_node(ctx, array), (size_t)index);
 
   if (iter) {
     return &iter->json_tlv;
   }
 
   /* We shouldn't land here. */
-  ctx->status = JES_BROKEN_TREE;
+  *status = JES_BROKEN_TREE;
   assert(0);
   return NULL;
 }
 
 struct jes_element* jes_add_element(struct jes_context* ctx, struct jes_element* parent, enum jes_type type, const char* value, size_t value_length)
 {
+  struct jes_node* parent_node = NULL;
   struct jes_node* new_node = NULL;
 
   if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
     return NULL;
   }
 
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return NULL;
+  }
+
   ctx->status = JES_NO_ERROR;
 
   if ((parent == NULL) && (ctx->node_mng.root != NULL)) {
@@ -386,9 +1062,12 @@ struct jes_element* jes_add_element(struct jes_context* ctx, struct jes_element*
     return NULL;
   }
 
-  if ((parent != NULL) && (!jes_validate_node(ctx, (struct jes_node*)parent))) {
-    ctx->status = JES_INVALID_PARAMETER;
-    return NULL;
+  if (parent != NULL) {
+    parent_node = jes_tree_get_element_node(ctx, parent);
+    if (parent_node == NULL) {
+      ctx->status = JES_INVALID_PARAMETER;
+      return NULL;
+    }
   }
 
   switch (type) {
@@ -417,10 +1096,14 @@ struct jes_element* jes_add_element(struct jes_context* ctx, struct jes_element*
       return NULL;
   }
 
+  if ((parent != NULL) && (parent->type == JES_KEY)) {
+    new_node = jes_tree_insert_key_value(ctx, parent_node, type, value_length, value);
+    return (new_node != NULL) ? NODE_VALUE_ELEMENT(new_node) : NULL;
+  }
+
   new_node = jes_tree_insert_node(ctx,
-                                  (struct jes_node*)parent,
-                                  GET_LAST_CHILD(ctx->node_mng,
-                                  (struct jes_node*)parent),
+                                  parent_node,
+                                  GET_LAST_CHILD(ctx->node_mng, parent_node),
                                   type, value_length, value);
 
   return (struct jes_element*)new_node;
@@ -435,9 +1118,15 @@ struct jes_element* jes_add_key(struct jes_context* ctx, struct jes_element* par
     return NULL;
   }
 
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return NULL;
+  }
+
   ctx->status = JES_NO_ERROR;
 
-  if ((parent == NULL) || (!jes_validate_node(ctx, (struct jes_node*)parent)) || (keyword == NULL)) {
+  object = jes_tree_get_element_node(ctx, parent);
+  if ((object == NULL) || (keyword == NULL)) {
     ctx->status = JES_INVALID_PARAMETER;
     return NULL;
   }
@@ -454,19 +1143,20 @@ struct jes_element* jes_add_key(struct jes_context* ctx, struct jes_element* par
 
   if (parent->type == JES_KEY) {
     /* The key must be added to an existing key and must be embedded in an OBJECT */
-    object = GET_FIRST_CHILD(ctx->node_mng, (struct jes_node*)parent);
+    struct jes_node* key = object;
+    object = GET_KEY_VALUE_NODE(ctx->node_mng, key);
     if (object == NULL) {
-      object = jes_tree_insert_node(ctx, (struct jes_node*)parent, GET_LAST_CHILD(ctx->node_mng, (struct jes_node*)parent), JES_OBJECT, 1, "{");
+      object = jes_tree_insert_key_value(ctx, key, JES_OBJECT, 1, "{");
+      if (object == NULL) {
+        return NULL;
+      }
     }
-    else if (NODE_TYPE(object) != JES_OBJECT) {
+    else if (NODE_VALUE_TYPE(object) != JES_OBJECT) {
       /* We should not land here */
       ctx->status = JES_UNEXPECTED_ELEMENT;
       return NULL;
     }
   }
-  else { /* parent is an OBJECT */
-    object = (struct jes_node*)parent;
-  }
 
   /* Append the key */
   new_node = jes_tree_insert_key_node(ctx, object, GET_LAST_CHILD(ctx->node_mng, object), keyword_length, keyword);
@@ -478,15 +1168,17 @@ struct jes_element* jes_add_key_before(struct jes_context* ctx, struct jes_eleme
 {
   struct jes_node* new_node = NULL;
   struct jes_node* parent = NULL;
-  struct jes_node* iter = NULL;
-  struct jes_node* before = NULL;
   struct jes_node* key_node = (struct jes_node*)key;
 
-
   if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
     return NULL;
   }
 
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return NULL;
+  }
+
   ctx->status = JES_NO_ERROR;
 
   if ((key == NULL) || !jes_validate_node(ctx, key_node) || (key->type != JES_KEY) || (keyword == NULL)) {
@@ -496,16 +1188,11 @@ struct jes_element* jes_add_key_before(struct jes_context* ctx, struct jes_eleme
 
   parent = GET_PARENT(ctx->node_mng, key_node);
   assert(parent != NULL);
-  assert(NODE_TYPE(parent) == JES_OBJECT);
+  assert(NODE_VALUE_TYPE(parent) == JES_OBJECT);
 
-  for (iter = GET_FIRST_CHILD(ctx->node_mng, parent); iter != NULL; iter = GET_SIBLING(ctx->node_mng, iter)) {
-    assert(NODE_TYPE(iter) == JES_KEY);
-    if (iter == key_node) {
-      new_node = jes_tree_insert_key_node(ctx, parent, before, keyword_length, keyword);
-      break;
-    }
-    before = iter;
-  }
+  /* Inserting before the key means inserting after its left sibling */
+  new_node = jes_tree_insert_key_node(ctx, parent, jes_tree_get_prev_sibling_node(ctx, key_node),
+                                      keyword_length, keyword);
 
   return (struct jes_element*)new_node;
 }
@@ -520,6 +1207,11 @@ struct jes_element* jes_add_key_after(struct jes_context* ctx, struct jes_elemen
     return NULL;
   }
 
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return NULL;
+  }
+
   ctx->status = JES_NO_ERROR;
 
   if ((key == NULL) || !jes_validate_node(ctx, key_node) || (key->type != JES_KEY) || (keyword == NULL)) {
@@ -529,7 +1221,7 @@ struct jes_element* jes_add_key_after(struct jes_context* ctx, struct jes_elemen
 
   parent = GET_PARENT(ctx->node_mng, key_node);
   assert(parent != NULL);
-  assert(NODE_TYPE(parent) == JES_OBJECT);
+  assert(NODE_VALUE_TYPE(parent) == JES_OBJECT);
 
   new_node = jes_tree_insert_key_node(ctx, parent, (struct jes_node*)key, keyword_length, keyword);
 
@@ -544,13 +1236,18 @@ struct jes_element* jes_update_key_value(struct jes_context* ctx, struct jes_ele
     return NULL;
   }
 
-  if ((key == NULL) || !jes_validate_node(ctx, (struct jes_node*)key) || (value == NULL) || (value_length == 0)) {
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return NULL;
+  }
+
+  if ((jes_tree_get_element_node(ctx, key) == NULL) || (key->type != JES_KEY) || (value == NULL) || (value_length == 0)) {
     ctx->status = JES_INVALID_PARAMETER;
     return NULL;
   }
 
   /* First delete the old value of the key if exists. */
-  jes_tree_delete_node(ctx, GET_FIRST_CHILD(ctx->node_mng, (struct jes_node*)key));
+  jes_tree_delete_key_value(ctx, (struct jes_node*)key);
   key_value = jes_add_element(ctx, key, type, value, value_length);
 
   return key_value;
@@ -590,9 +1287,14 @@ struct jes_element* jes_update_array_value(struct jes_context* ctx, struct jes_e
     return NULL;
   }
 
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return NULL;
+  }
+
   ctx->status = JES_NO_ERROR;
 
-  if ((array == NULL) || !jes_validate_node(ctx, (struct jes_node*)array) || (array->type != JES_ARRAY) || (value == NULL)) {
+  if ((jes_tree_get_element_node(ctx, array) == NULL) || (array->type != JES_ARRAY) || (value == NULL)) {
     ctx->status = JES_INVALID_PARAMETER;
     return NULL;
   }
@@ -607,19 +1309,19 @@ struct jes_element* jes_update_array_value(struct jes_context* ctx, struct jes_e
     return NULL;
   }
 
-  for(target_node = GET_FIRST_CHILD(ctx->node_mng, (struct jes_node*)array); target_node != NULL; target_node = GET_SIBLING(ctx->node_mng, target_node)) {
-    if (index-- == 0) {
-      break;
-    }
-  }
+  target_node = jes_tree_get_child_node_at(ctx, jes_tree_get_element_node(ctx, array), (size_t)index);
 
   if (target_node) {
     /* We'll not delete the target_node to keep the original array order. Just update its JSON TLV.
      * The rest of the branch however must be removed. */
+    jes_node_descriptor target_index = JES_NODE_INDEX(ctx->node_mng, target_node);
     jes_tree_delete_node(ctx, GET_FIRST_CHILD(ctx->node_mng, target_node));
+    if (!jes_tree_set_element_value(ctx, &target_node->json_tlv, value)) {
+      return NULL;
+    }
+    target_node = GET_NODE(ctx->node_mng, target_index);
     target_node->json_tlv.type = type;
     target_node->json_tlv.length = value_length;
-    target_node->json_tlv.value = value;
   }
   else {
     ctx->status = JES_BROKEN_TREE;
@@ -631,27 +1333,34 @@ struct jes_element* jes_update_array_value(struct jes_context* ctx, struct jes_e
 
 struct jes_element* jes_append_array_value(struct jes_context* ctx, struct jes_element* array, enum jes_type type, const char* value, size_t value_length)
 {
+  struct jes_node* array_node = NULL;
   struct jes_node* new_node = NULL;
 
   if (!ctx || !JES_IS_INITIATED(ctx)) {
     return NULL;
   }
 
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return NULL;
+  }
+
   ctx->status = JES_NO_ERROR;
 
-  if ((array == NULL) || !jes_validate_node(ctx, (struct jes_node*)array) || (array->type != JES_ARRAY) || (value == NULL)) {
+  array_node = jes_tree_get_element_node(ctx, array);
+  if ((array_node == NULL) || (array->type != JES_ARRAY) || (value == NULL)) {
     ctx->status = JES_INVALID_PARAMETER;
     return NULL;
   }
 
-  new_node = jes_tree_insert_node(ctx, (struct jes_node*)array, GET_LAST_CHILD(ctx->node_mng, (struct jes_node*)array), type, value_length, value);
+  new_node = jes_tree_insert_node(ctx, array_node, GET_LAST_CHILD(ctx->node_mng, array_node), type, value_length, value);
 
   return (struct jes_element*)new_node;
 }
 
 struct jes_element* jes_add_array_value(struct jes_context* ctx, struct jes_element* array, int32_t index, enum jes_type type, const char* value, size_t value_length)
 {
-  struct jes_node* anchor_node = NULL;
+  struct jes_node* array_node = NULL;
   struct jes_node* prev_node = NULL;
   struct jes_node* new_node = NULL;
   int32_t array_size;
@@ -660,9 +1369,15 @@ struct jes_element* jes_add_array_value(struct jes_context* ctx, struct jes_elem
     return NULL;
   }
 
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return NULL;
+  }
+
   ctx->status = JES_NO_ERROR;
 
-  if ((array == NULL) || !jes_validate_node(ctx, (struct jes_node*)array) || (array->type != JES_ARRAY) || (value == NULL)) {
+  array_node = jes_tree_get_element_node(ctx, array);
+  if ((array_node == NULL) || (array->type != JES_ARRAY) || (value == NULL)) {
     ctx->status = JES_INVALID_PARAMETER;
     return NULL;
   }
@@ -678,21 +1393,17 @@ struct jes_element* jes_add_array_value(struct jes_context* ctx, struct jes_elem
     return jes_append_array_value(ctx, array, type, value, value_length);
   }
 
-  for (anchor_node = GET_FIRST_CHILD(ctx->node_mng, (struct jes_node*)array); anchor_node != NULL; anchor_node = GET_SIBLING(ctx->node_mng, anchor_node)) {
-    if (index == 0) {
-      break;
+  /* The new value takes the place of the value at index, so it follows the previous value. */
+  if (index > 0) {
+    prev_node = jes_tree_get_child_node_at(ctx, array_node, (size_t)index - 1);
+    if (prev_node == NULL) {
+      ctx->status = JES_BROKEN_TREE;
+      assert(0);
+      return NULL;
     }
-    prev_node = anchor_node;
-    index--;
-  }
-
-  if ((anchor_node == NULL) && (array_size != 0)) {
-    ctx->status = JES_BROKEN_TREE;
-    assert(0);
-    return NULL;
   }
 
-  new_node = jes_tree_insert_node(ctx, (struct jes_node*)array, anchor_node, type, value_length, value);
+  new_node = jes_tree_insert_node(ctx, array_node, prev_node, type, value_length, value);
 
   return (struct jes_element*)new_node;
 }
@@ -700,7 +1411,7 @@ struct jes_element* jes_add_array_value(struct jes_context* ctx, struct jes_elem
 size_t jes_get_element_count(struct jes_context* ctx)
 {
   if ((ctx != NULL) && JES_IS_INITIATED(ctx)) {
-    return ctx->node_mng.node_count;
+    return ctx->node_mng.node_count - ctx->node_mng.value_holder_count;
   }
   return 0;
 }
@@ -727,12 +1438,30 @@ jes_status jes_load(struct jes_context* ctx, const char* json_data, size_t json_
     return JES_INVALID_CONTEXT;
   }
 
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return ctx->status;
+  }
+
   if ((json_data == NULL) || (json_length == 0)) {
     ctx->status = JES_INVALID_PARAMETER;
     return ctx->status;
   }
 
-  jes_reset(ctx);
+#ifdef JES_USE_COMPACT_NODE
+  /* Element offsets can only address the first 2 GiB of the JSON data. */
+  if (json_length >= JES_EXTERNAL_VALUE) {
+    ctx->status = JES_INVALID_PARAMETER;
+    return ctx->status;
+  }
+#endif
+
+  ctx->status = jes_clear(ctx);
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+  if (JES_SEARCH_HASHED == ctx->mode) {
+    jes_hash_table_defer(ctx);
+  }
+#endif
 
   ctx->serdes.tokenizer.json_data = json_data;
   ctx->serdes.tokenizer.json_length = json_length;
@@ -741,9 +1470,378 @@ jes_status jes_load(struct jes_context* ctx, const char* json_data, size_t json_
   return ctx->status;
 }
 
+/* Bits of the build configuration that change the layout of the workspace. */
+static uint32_t jes_image_config(void)
+{
+  uint32_t config = (uint32_t)sizeof(void*) | ((uint32_t)sizeof(size_t) << 8);
+
+#ifdef JES_USE_32BIT_NODE_DESCRIPTOR
+  config |= 1UL << 16;
+#endif
+#ifdef JES_USE_COMPACT_NODE
+  config |= 1UL << 17;
+#endif
+#ifdef JES_USE_MERGED_KEY_NODE
+  config |= 1UL << 18;
+#endif
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+  config |= 1UL << 19;
+#endif
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+  config |= 1UL << 20;
+#endif
+#ifdef JES_USE_CHILD_COUNT
+  config |= 1UL << 21;
+#endif
+#ifdef JES_USE_COMPACT_HASH_ENTRY
+  config |= 1UL << 22;
+#endif
+  return config;
+}
+
+/* Offsets of the image sections behind the header */
+static size_t jes_image_entries_offset(size_t pool_node_count)
+{
+  return JES_ALIGN_SIZE(JES_ALIGN_SIZE(sizeof(struct jes_image_header)) +
+                        pool_node_count * sizeof(struct jes_node));
+}
+
+static size_t jes_image_text_offset(size_t pool_node_count, size_t hash_entry_count)
+{
+  return jes_image_entries_offset(pool_node_count) + hash_entry_count * sizeof(struct jes_hash_entry);
+}
+
+/* Next node of the tree in pre-order */
+static struct jes_node* jes_image_next_node(struct jes_context* ctx, struct jes_node* node)
+{
+  return HAS_CHILD(node) ? GET_FIRST_CHILD(ctx->node_mng, node)
+                         : jes_tree_get_subtree_end_node(ctx, node);
+}
+
+/* Converts a value pointer to a biased offset into the text section. Values
+   outside the JSON data are appended to the text section. */
+static uintptr_t jes_image_save_value(struct jes_context* ctx, const char* value, size_t length,
+                                      uint8_t* text, size_t* text_length)
+{
+  const char* json_data = ctx->serdes.tokenizer.json_data;
+  size_t offset = *text_length;
+
+  if (value == NULL) {
+    return 0;
+  }
+
+  if ((json_data != NULL) &&
+      ((uintptr_t)value >= (uintptr_t)json_data) &&
+      (((uintptr_t)value + length) <= ((uintptr_t)json_data + ctx->serdes.tokenizer.json_length))) {
+    return (uintptr_t)(value - json_data) + 1;
+  }
+
+  if (text != NULL) {
+    memcpy(text + offset, value, length);
+  }
+  *text_length += length;
+  return (uintptr_t)offset + 1;
+}
+
+/* Stores the value of an element into its copy in the image. */
+static void jes_image_save_element(struct jes_context* ctx, struct jes_element* element,
+                                   struct jes_node* nodes, uint8_t* text, size_t* text_length)
+{
+#ifdef JES_USE_COMPACT_NODE
+  /* Offsets into the JSON data stay valid. Only the holders of external values keep pointers. */
+  if (JES_HAS_EXTERNAL_VALUE(element)) {
+    size_t holder = element->offset & ~JES_EXTERNAL_VALUE;
+    uintptr_t value = jes_image_save_value(ctx, JES_ELEMENT_VALUE(ctx, element), element->length, text, text_length);
+    if (nodes != NULL) {
+      jes_set_holder_value(&nodes[holder], (const char*)value);
+    }
+  }
+#else
+  uintptr_t value = jes_image_save_value(ctx, element->value, element->length, text, text_length);
+  if (nodes != NULL) {
+    ((struct jes_element*)((uint8_t*)nodes + ((uint8_t*)element - (uint8_t*)ctx->node_mng.pool)))->value = (const char*)value;
+  }
+#endif
+}
+
+/* Walks the tree and converts the values of the copied nodes. Returns the size
+   of the text section. Only measures the text section if nodes is NULL. */
+static size_t jes_image_save_nodes(struct jes_context* ctx, struct jes_node* nodes, uint8_t* text)
+{
+  struct jes_node* node = NULL;
+  size_t text_length = ctx->serdes.tokenizer.json_length;
+
+  if ((text != NULL) && (text_length != 0)) {
+    memcpy(text, ctx->serdes.tokenizer.json_data, text_length);
+  }
+
+  for (node = ctx->node_mng.root; node != NULL; node = jes_image_next_node(ctx, node)) {
+    jes_image_save_element(ctx, &node->json_tlv, nodes, text, &text_length);
+#ifdef JES_USE_MERGED_KEY_NODE
+    if (NODE_TYPE(node) == JES_KEY) {
+      jes_image_save_element(ctx, &node->value_tlv, nodes, text, &text_length);
+    }
+#endif
+  }
+
+  return text_length;
+}
+
+size_t jes_save_image(struct jes_context* ctx, void* buffer, size_t buffer_size)
+{
+  struct jes_image_header* header = buffer;
+  enum jes_search_mode mode;
+  size_t pool_node_count;
+  size_t hash_entry_count = 0;
+  size_t text_offset;
+  size_t text_length;
+
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return 0;
+  }
+
+  if ((buffer != NULL) && !JES_IS_ALIGNED(buffer)) {
+    ctx->status = JES_INVALID_PARAMETER;
+    return 0;
+  }
+
+  pool_node_count = ctx->node_mng.next_free;
+  mode = ctx->mode;
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+  if (ctx->hash_index_deferred) {
+    /* The image has no hash table, like one of a linear context */
+    mode = JES_SEARCH_LINEAR;
+  }
+#endif
+  if (JES_SEARCH_HASHED == mode) {
+    hash_entry_count = jes_hash_table_save_entries(ctx, NULL);
+  }
+  text_offset = jes_image_text_offset(pool_node_count, hash_entry_count);
+  text_length = jes_image_save_nodes(ctx, NULL, NULL);
+
+  if ((text_length > UINT32_MAX) || (text_offset + text_length > UINT32_MAX)) {
+    ctx->status = JES_OUT_OF_MEMORY;
+    return 0;
+  }
+
+  ctx->status = JES_NO_ERROR;
+  if (buffer == NULL) {
+    return text_offset + text_length;
+  }
+
+  if (buffer_size < text_offset + text_length) {
+    ctx->status = JES_BUFFER_TOO_SMALL;
+    return 0;
+  }
+
+  memset(header, 0, JES_ALIGN_SIZE(sizeof(*header)));
+  header->magic = JES_IMAGE_MAGIC;
+  header->version = JES_IMAGE_VERSION;
+  header->node_size = (uint16_t)sizeof(struct jes_node);
+  header->config = jes_image_config();
+  header->mode = (uint32_t)mode;
+  header->pool_node_count = (uint32_t)pool_node_count;
+  header->node_count = (uint32_t)ctx->node_mng.node_count;
+  header->value_holder_count = (uint32_t)ctx->node_mng.value_holder_count;
+  header->root = (ctx->node_mng.root != NULL) ? (uint32_t)JES_NODE_INDEX(ctx->node_mng, ctx->node_mng.root) + 1 : 0;
+  header->freed = (ctx->node_mng.freed != NULL)
+                ? (uint32_t)JES_NODE_INDEX(ctx->node_mng, (struct jes_node*)ctx->node_mng.freed) + 1
+                : 0;
+  header->hash_entry_count = (uint32_t)hash_entry_count;
+  header->hash_function = JES_HASH_FUNCTION_ID;
+  header->hash_seed = ctx->hash_table.seed;
+  header->hash_min_keys = JES_HASH_TABLE_MIN_KEYS;
+  header->json_length = (uint32_t)ctx->serdes.tokenizer.json_length;
+  header->text_length = (uint32_t)text_length;
+
+  memcpy((uint8_t*)buffer + JES_ALIGN_SIZE(sizeof(*header)), ctx->node_mng.pool,
+         pool_node_count * sizeof(struct jes_node));
+  /* Nodes of a size that is not a multiple of JES_ALIGNMENT leave padding in
+     front of the entries. It must not keep old bytes of the buffer. */
+  memset((uint8_t*)buffer + JES_ALIGN_SIZE(sizeof(*header)) + pool_node_count * sizeof(struct jes_node), 0,
+         jes_image_entries_offset(pool_node_count) - JES_ALIGN_SIZE(sizeof(*header)) -
+         pool_node_count * sizeof(struct jes_node));
+  jes_image_save_nodes(ctx, (struct jes_node*)((uint8_t*)buffer + JES_ALIGN_SIZE(sizeof(*header))),
+                       (uint8_t*)buffer + text_offset);
+  if (hash_entry_count != 0) {
+    jes_hash_table_save_entries(ctx, (struct jes_hash_entry*)((uint8_t*)buffer + jes_image_entries_offset(pool_node_count)));
+  }
+
+  return text_offset + text_length;
+}
+
+/* Resolves a biased offset of the image to a pointer into the text section. */
+static bool jes_image_load_value(const char** value, uintptr_t offset, size_t length,
+                                 const char* text, size_t text_length)
+{
+  if (offset == 0) {
+    *value = NULL;
+    return true;
+  }
+  if ((offset - 1 > text_length) || (length > text_length - (offset - 1))) {
+    return false;
+  }
+  *value = text + (offset - 1);
+  return true;
+}
+
+static bool jes_image_load_element(struct jes_context* ctx, struct jes_element* element, size_t text_length)
+{
+  const char* text = ctx->serdes.tokenizer.json_data;
+#ifdef JES_USE_COMPACT_NODE
+  if (JES_HAS_EXTERNAL_VALUE(element)) {
+    size_t holder = element->offset & ~JES_EXTERNAL_VALUE;
+    const char* value = NULL;
+    bool valid;
+    if (holder >= ctx->node_mng.next_free) {
+      return false;
+    }
+    value = jes_get_holder_value(&ctx->node_mng.pool[holder]);
+    valid = jes_image_load_value(&value, (uintptr_t)value, element->length, text, text_length);
+    jes_set_holder_value(&ctx->node_mng.pool[holder], value);
+    return valid;
+  }
+  return ((size_t)element->offset <= text_length) && (element->length <= text_length - element->offset);
+#else
+  return jes_image_load_value(&element->value, (uintptr_t)element->value,
+                              element->length, text, text_length);
+#endif
+}
+
+/* Restores the pointers of the copied nodes and the lookup table. */
+static jes_status jes_image_load_nodes(struct jes_context* ctx, const struct jes_image_header* header,
+                                       const struct jes_hash_entry* entries)
+{
+  struct jes_node_mng_context* mng_ctx = &ctx->node_mng;
+  struct jes_node* node = NULL;
+  struct jes_freed_node* freed = NULL;
+  size_t count;
+
+  if ((header->root > header->pool_node_count) || (header->freed > header->pool_node_count)) {
+    return JES_BROKEN_TREE;
+  }
+
+  mng_ctx->root = (header->root != 0) ? &mng_ctx->pool[header->root - 1] : NULL;
+  for (node = mng_ctx->root, count = 0; node != NULL; node = jes_image_next_node(ctx, node), count++) {
+    if ((count >= header->pool_node_count) ||
+        !jes_image_load_element(ctx, &node->json_tlv, header->text_length)) {
+      return JES_BROKEN_TREE;
+    }
+#ifdef JES_USE_MERGED_KEY_NODE
+    if ((NODE_TYPE(node) == JES_KEY) &&
+        !jes_image_load_element(ctx, &node->value_tlv, header->text_length)) {
+      return JES_BROKEN_TREE;
+    }
+#endif
+  }
+
+  mng_ctx->freed = (header->freed != 0) ? (struct jes_freed_node*)&mng_ctx->pool[header->freed - 1] : NULL;
+  /* Released nodes are linked by descriptors */
+  for (freed = mng_ctx->freed, count = 0; freed != NULL;
+       freed = (struct jes_freed_node*)GET_NODE((*mng_ctx), freed->next), count++) {
+    if ((count >= header->pool_node_count) ||
+        ((freed->next < JES_INVALID_INDEX) && (freed->next >= header->pool_node_count))) {
+      return JES_BROKEN_TREE;
+    }
+  }
+
+  if (JES_SEARCH_HASHED == ctx->mode) {
+    if ((JES_SEARCH_HASHED == header->mode) &&
+        (JES_HASH_FUNCTION_ID == header->hash_function) &&
+        (ctx->hash_table.seed == header->hash_seed) &&
+        (JES_HASH_TABLE_MIN_KEYS == header->hash_min_keys)) {
+      jes_hash_table_load_entries(ctx, entries, header->hash_entry_count);
+    }
+    else {
+      /* The image has no hash table or its hashes do not match. Hash the keys of the tree. */
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+      jes_hash_table_defer(ctx);
+#else
+      return jes_hash_table_rehash(ctx);
+#endif
+    }
+  }
+
+  return JES_NO_ERROR;
+}
+
+jes_status jes_load_image(struct jes_context* ctx, const void* image, size_t image_size)
+{
+  const struct jes_image_header* header = image;
+  size_t text_offset;
+
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return JES_INVALID_CONTEXT;
+  }
+
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return ctx->status;
+  }
+
+  if ((image == NULL) || !JES_IS_ALIGNED(image) || (image_size < sizeof(*header)) ||
+      (header->magic != JES_IMAGE_MAGIC) || (header->version != JES_IMAGE_VERSION) ||
+      (header->node_size != sizeof(struct jes_node)) || (header->config != jes_image_config()) ||
+      (header->json_length > header->text_length) ||
+      (header->pool_node_count >= JES_INVALID_INDEX)) {
+    ctx->status = JES_INVALID_PARAMETER;
+    return ctx->status;
+  }
+
+  text_offset = jes_image_text_offset(header->pool_node_count, header->hash_entry_count);
+  if ((text_offset > image_size) || (header->text_length > image_size - text_offset)) {
+    ctx->status = JES_INVALID_PARAMETER;
+    return ctx->status;
+  }
+
+  ctx->status = jes_clear(ctx);
+  if (ctx->status != JES_NO_ERROR) {
+    return ctx->status;
+  }
+
+#ifdef JES_ENABLE_ADAPTIVE_WORKSPACE
+  if ((JES_SEARCH_HASHED == ctx->mode) && (JES_SEARCH_HASHED == header->mode)) {
+    /* The table takes what the entries need, the nodes get the rest. */
+    jes_hash_table_reserve(ctx, header->hash_entry_count);
+  }
+#endif
+
+  while ((header->pool_node_count > ctx->node_mng.capacity) ||
+         ((JES_SEARCH_HASHED == ctx->mode) && (JES_SEARCH_HASHED == header->mode) &&
+          (header->hash_entry_count > ctx->hash_table.capacity))) {
+#ifdef JES_ENABLE_WORKSPACE_GROW
+    if (jes_workspace_grow(ctx) == JES_NO_ERROR) {
+      continue;
+    }
+#endif
+    ctx->status = JES_OUT_OF_MEMORY;
+    return ctx->status;
+  }
+
+  memcpy(ctx->node_mng.pool, (const uint8_t*)image + JES_ALIGN_SIZE(sizeof(*header)),
+         header->pool_node_count * sizeof(struct jes_node));
+  ctx->node_mng.next_free = (jes_node_descriptor)header->pool_node_count;
+  ctx->node_mng.node_count = header->node_count;
+  ctx->node_mng.value_holder_count = (jes_node_descriptor)header->value_holder_count;
+  /* Values reference the text section of the image like they reference the JSON data after jes_load(). */
+  ctx->serdes.tokenizer.json_data = (const char*)image + text_offset;
+  ctx->serdes.tokenizer.json_length = header->json_length;
+
+  ctx->status = jes_image_load_nodes(ctx, header,
+                  (const struct jes_hash_entry*)((const uint8_t*)image + jes_image_entries_offset(header->pool_node_count)));
+  if (ctx->status != JES_NO_ERROR) {
+    /* Do not leave a half restored tree behind */
+    jes_status status = ctx->status;
+    jes_clear(ctx);
+    ctx->status = status;
+  }
+
+  return ctx->status;
+}
+
 void jes_set_path_separator(struct jes_context* ctx, char delimiter)
 {
-  if ((ctx != NULL) && JES_IS_INITIATED(ctx)) {
+  if ((ctx != NULL) && JES_IS_INITIATED(ctx) && !ctx->frozen) {
     ctx->path_separator = delimiter;
   }
 }
@@ -758,6 +1856,87 @@ size_t jes_node_size(void)
   return sizeof(struct jes_node);
 }
 
+struct jes_workspace_estimate jes_estimate(const char* json_data, size_t json_length,
+                                           enum jes_search_mode mode)
+{
+  struct jes_workspace_estimate estimate = { 0 };
+  size_t value_count = 0;
+  size_t key_count = 0;
+  size_t node_pool_size;
+  size_t buffer_size;
+
+  if (json_data != NULL) {
+    jes_tokenizer_count_elements(json_data, json_length, &value_count, &key_count);
+  }
+
+#ifdef JES_USE_MERGED_KEY_NODE
+  /* Each key node embeds its value. */
+  estimate.node_count = value_count;
+#else
+  estimate.node_count = value_count + key_count;
+#endif
+  estimate.key_count = key_count;
+
+  if ((estimate.node_count >= JES_INVALID_INDEX) || (estimate.key_count >= JES_INVALID_INDEX)) {
+    return estimate;
+  }
+
+  /* An empty pool or hash table is rejected by jes_init. */
+  node_pool_size = (estimate.node_count > 0 ? estimate.node_count : 1) * sizeof(struct jes_node);
+
+  if (JES_SEARCH_HASHED == mode) {
+    size_t hash_table_size = jes_hash_table_required_size(estimate.key_count);
+#ifdef JES_ENABLE_ADAPTIVE_WORKSPACE
+    /* The hash table takes the memory the nodes leave. A full pool shrinks
+       the table down to its keys, so neither the initial table nor the room
+       it takes to grow counts. Its entries end at an aligned address. */
+    buffer_size = node_pool_size + hash_table_size + JES_ALIGNMENT - 1;
+#else
+    size_t hash_buffer_size;
+    /* Smallest buffers whose node pool share and whose remaining share (after
+       aligning the hash table) are large enough. */
+    buffer_size = (node_pool_size * 100 + JES_WORKSPACE_NODE_POOL_PERCENT - 1)
+                / JES_WORKSPACE_NODE_POOL_PERCENT;
+    hash_buffer_size = ((hash_table_size + JES_ALIGNMENT - 1) * 100 + (100 - JES_WORKSPACE_NODE_POOL_PERCENT) - 1)
+                     / (100 - JES_WORKSPACE_NODE_POOL_PERCENT);
+    if (hash_buffer_size > buffer_size) {
+      buffer_size = hash_buffer_size;
+    }
+#endif
+  }
+  else {
+    buffer_size = node_pool_size;
+  }
+
+  estimate.workspace_size = sizeof(struct jes_context) + buffer_size;
+  return estimate;
+}
+
+static void jes_stat_count(struct jes_stat* stat, enum jes_type type)
+{
+  switch (type) {
+    case JES_OBJECT:
+      stat->objects++;
+      break;
+    case JES_KEY:
+      stat->keys++;
+      break;
+    case JES_ARRAY:
+      stat->arrays++;
+      break;
+    case JES_STRING:
+    case JES_NUMBER:
+    case JES_TRUE:
+    case JES_FALSE:
+    case JES_NULL:
+      stat->values++;
+      break;
+    default:
+      assert(0);
+      break;
+  }
+}
+
 struct jes_stat jes_get_stat(struct jes_context* ctx)
 {
   struct jes_stat stat = { 0 };
@@ -766,29 +1945,11 @@ struct jes_stat jes_get_stat(struct jes_context* ctx)
     return stat;
   }
 
-  ctx->serdes.iter = NULL;
-
-  while (NULL != jes_serializer_get_node(ctx)) {
-    switch (ctx->serdes.iter->json_tlv.type) {
-      case JES_OBJECT:
-        stat.objects++;
-        break;
-      case JES_KEY:
-        stat.keys++;
-        break;
-      case JES_ARRAY:
-        stat.arrays++;
-        break;
-      case JES_STRING:
-      case JES_NUMBER:
-      case JES_TRUE:
-      case JES_FALSE:
-      case JES_NULL:
-        stat.values++;
-        break;
-      default:
-        assert(0);
-        break;
+  if (ctx->node_mng.root != NULL) {
+    struct jes_iterator iterator;
+    /* A private iterator leaves the serializer state untouched */
+    JES_ITERATOR_FOR_EACH(ctx, &ctx->node_mng.root->json_tlv, iterator) {
+      jes_stat_count(&stat, iterator.element->type);
     }
   }
   return stat;
@@ -800,6 +1961,9 @@ size_t jes_get_workspace_size(struct jes_context *ctx)
 
   if ((ctx != NULL) && JES_IS_INITIATED(ctx)) {
     workspace_size = ctx->workspace_size;
+#ifdef JES_ENABLE_WORKSPACE_GROW
+    workspace_size += ctx->grown_workspace_size;
+#endif
   }
 
   return workspace_size;
@@ -810,11 +1974,13 @@ struct jes_workspace_stat jes_get_workspace_stat(struct jes_context* ctx)
   struct jes_workspace_stat stat = { 0 };
 
   if ((ctx != NULL) && JES_IS_INITIATED(ctx)) {
-    stat.workspace_size = ctx->workspace_size;
+    stat.workspace_size = jes_get_workspace_size(ctx);
     stat.context_size = jes_context_size();
     stat.node_mng_size = ctx->node_mng.size;
     stat.node_mng_capacity = ctx->node_mng.capacity;
     stat.node_mng_node_count = ctx->node_mng.node_count;
+    stat.node_size = sizeof(struct jes_node);
+    stat.node_link_size = JES_NODE_LINK_COUNT * sizeof(jes_node_descriptor);
     if (JES_SEARCH_HASHED == ctx->mode) {
       stat.hash_table_size = ctx->hash_table.size;
       stat.hash_table_capacity = ctx->hash_table.capacity;
@@ -22,6 +22,252 @@
  */
 //#define JES_USE_32BIT_NODE_DESCRIPTOR
 
+/**
+ * JES_USE_COMPACT_NODE
+ *
+ * Stores element values as 32-bit offsets from the start of the loaded JSON
+ * data instead of full pointers.
+ *
+ * Memory impact:
+ * - 64-bit targets: a node shrinks from 24 to 16 bytes (16-bit descriptors),
+ *   so the same workspace holds 50% more elements.
+ * - 32-bit targets: no change in node size.
+ *
+ * Limitations:
+ * - jes_element has no value pointer. Use jes_get_element_value() to access
+ *   the value of an element.
+ * - The JSON data passed to jes_load() must be smaller than 2 GiB.
+ * - Values added or updated through the editing API that are not part of the
+ *   loaded JSON data occupy one extra node of the pool to store their pointer.
+ */
+//#define JES_USE_COMPACT_NODE
+
+/**
+ * JES_USE_MERGED_KEY_NODE
+ *
+ * Stores an object member (key and value) in a single node. The key node
+ * embeds the value element and a container value links its children to the
+ * key node directly.
+ *
+ * Memory impact:
+ * - Every object member saves one node, but each node carries a second
+ *   element. Object-heavy documents need less memory, documents made mostly
+ *   of array values need more.
+ * - 64-bit targets: a member takes 40 bytes instead of 2 x 24 bytes
+ *   (24 instead of 2 x 16 bytes together with JES_USE_COMPACT_NODE).
+ *
+ * The representation is transparent to the API. jes_get_key_value() and
+ * jes_get_child() on a key return its value element, and jes_get_parent() on
+ * that value returns the key. jes_get_element_count() however reports nodes,
+ * so a member with a value counts as one.
+ */
+//#define JES_USE_MERGED_KEY_NODE
+
+/**
+ * JES_USE_SUBTREE_END_DESCRIPTOR
+ *
+ * Adds a fifth descriptor to each node that points to the first node after
+ * its subtree in pre-order. Tree traversals skip a finished branch with a
+ * single jump instead of climbing the parent chain.
+ *
+ * The descriptor is maintained on parse and on every edit. Appending or
+ * deleting a node updates the last descendants of its left sibling, which
+ * costs O(depth) of that branch.
+ *
+ * Memory impact: one extra descriptor per node (a node grows from 24 to 32
+ * bytes on 64-bit targets with 16-bit descriptors).
+ */
+//#define JES_USE_SUBTREE_END_DESCRIPTOR
+
+/**
+ * JES_USE_PREV_SIBLING_DESCRIPTOR
+ *
+ * Adds a descriptor to each node that links to its left sibling. Deleting a
+ * node and inserting before a node (jes_add_key_before()) no longer walk the
+ * branch from the first child, which makes them O(1) instead of O(n) in the
+ * number of siblings.
+ *
+ * Memory impact: one extra descriptor per node (a node grows from 24 to 32
+ * bytes on 64-bit targets with 16-bit descriptors). jes_get_workspace_stat()
+ * reports the node size and the share taken by links.
+ */
+//#define JES_USE_PREV_SIBLING_DESCRIPTOR
+
+/**
+ * JES_USE_CHILD_COUNT
+ *
+ * Keeps the number of children in each node. The count is set by the parser
+ * and updated by every insert and delete, so jes_get_array_size() and the
+ * index checks of the array API are O(1) instead of walking the array.
+ *
+ * Memory impact: one extra descriptor per node (a node grows from 24 to 32
+ * bytes on 64-bit targets with 16-bit descriptors).
+ */
+//#define JES_USE_CHILD_COUNT
+
+/**
+ * JES_ENABLE_WORKSPACE_GROW
+ *
+ * Enables jes_init_growable(), which takes a callback to request a bigger
+ * buffer when the node pool or the hash table is full. The pool and the hash
+ * table move to the new buffer and parsing or editing continues, so the
+ * workspace can be sized for the common case instead of the worst case.
+ *
+ * Element pointers obtained before an operation that adds elements are
+ * invalidated when the workspace grows during that operation.
+ *
+ * Memory impact: the context grows by three pointers.
+ */
+//#define JES_ENABLE_WORKSPACE_GROW
+
+/**
+ * JES_ENABLE_FILE_MAPPING
+ *
+ * Enables jes_load_file() and jes_load_image_file(), which map a file
+ * read-only into memory and parse or restore the tree directly from the
+ * mapping. The file is not copied into an application buffer and pages that
+ * are already in the page cache are not read again.
+ *
+ * Requires a POSIX system with mmap().
+ *
+ * Memory impact: the context grows by two pointers.
+ */
+//#define JES_ENABLE_FILE_MAPPING
+
+/**
+ * JES_ENABLE_ARRAY_INDEX
+ *
+ * Makes jes_get_array_value() O(1) for large arrays. On the first access
+ * beyond JES_ARRAY_INDEX_MIN_SIZE, the node descriptors of the array elements
+ * are collected in a table at the unused end of the node pool. Indexed loops
+ * over an array then cost O(n) in total instead of O(n^2).
+ *
+ * Up to JES_ARRAY_INDEX_SLOTS arrays are indexed at the same time, so
+ * interleaved loops over several arrays stay O(1) per access. Indexing one
+ * more array drops the oldest index. Deleting the last element of an indexed
+ * array updates its table, and so does appending to the most recently indexed
+ * array. Other edits of the array drop its index and it is rebuilt on the next
+ * access. Indexes are dropped as well when new nodes need their memory, in
+ * which case accesses fall back to walking the array.
+ *
+ * Memory impact: the context grows by two pointers and three pointers per
+ * slot. The tables use pool memory that is not allocated to nodes.
+ */
+//#define JES_ENABLE_ARRAY_INDEX
+
+/**
+ * JES_ARRAY_INDEX_MIN_SIZE
+ *
+ * Index position below which jes_get_array_value() walks the array instead of
+ * building an array index (requires JES_ENABLE_ARRAY_INDEX).
+ */
+#ifndef JES_ARRAY_INDEX_MIN_SIZE
+  #define JES_ARRAY_INDEX_MIN_SIZE 16
+#endif
+
+/**
+ * JES_ARRAY_INDEX_SLOTS
+ *
+ * Number of arrays that are indexed at the same time (requires
+ * JES_ENABLE_ARRAY_INDEX).
+ */
+#ifndef JES_ARRAY_INDEX_SLOTS
+  #define JES_ARRAY_INDEX_SLOTS 4
+#endif
+
+/**
+ * JES_USE_COMPACT_HASH_ENTRY
+ *
+ * Stores hash table entries in 8 bytes, a 32-bit hash and the descriptor of
+ * the key node, instead of a size_t hash and a pointer (16 bytes on 64-bit
+ * targets). The same hash table share of the workspace holds almost twice as
+ * many keys and a probe touches fewer cache lines. Keys are resolved through
+ * the node pool.
+ */
+//#define JES_USE_COMPACT_HASH_ENTRY
+
+/**
+ * JES_USE_WORD_HASH
+ *
+ * Hashes keys for JES_SEARCH_HASHED with a multiply-mix function in the style
+ * of wyhash, which reads the key eight bytes per step, instead of the default
+ * byte-wise FNV-1a. Faster for keys longer than a few bytes. Together with a
+ * random jes_set_hash_seed(), colliding keys can not be prepared in advance.
+ */
+//#define JES_USE_WORD_HASH
+
+/**
+ * JES_USE_CRC32C_HASH
+ *
+ * Hashes keys with the CRC32C instruction of the CPU, eight bytes per step.
+ * Requires SSE4.2 (e.g. -msse4.2) or the ARMv8 CRC extension
+ * (e.g. -march=armv8-a+crc); the word hash of JES_USE_WORD_HASH is used when
+ * the compiler does not target them. CRC32C is linear, so the seed of
+ * jes_set_hash_seed() does not protect it against crafted colliding keys.
+ */
+//#define JES_USE_CRC32C_HASH
+
+/**
+ * JES_ENABLE_HYBRID_SEARCH
+ *
+ * In JES_SEARCH_HASHED mode, only objects with at least
+ * JES_HYBRID_SEARCH_MIN_KEYS keys have their keys in the hash table. Smaller
+ * objects are searched linearly, which is faster for a handful of keys and
+ * saves their hash table entries. An object is promoted, all its keys are
+ * added to the table, when it reaches the threshold and demoted when a
+ * deletion takes it below.
+ *
+ * Documents with many small objects and a few large ones need a much smaller
+ * hash table. jes_estimate() still counts all keys.
+ */
+//#define JES_ENABLE_HYBRID_SEARCH
+
+/**
+ * JES_HYBRID_SEARCH_MIN_KEYS
+ *
+ * Key count from which the keys of an object are hashed (requires
+ * JES_ENABLE_HYBRID_SEARCH). Lookups in smaller objects compare up to this
+ * many keys.
+ */
+#ifndef JES_HYBRID_SEARCH_MIN_KEYS
+  #define JES_HYBRID_SEARCH_MIN_KEYS 8
+#endif
+
+/**
+ * JES_ENABLE_LAZY_HASH_INDEX
+ *
+ * In JES_SEARCH_HASHED mode, jes_load() does not hash the keys of the parsed
+ * document. The first key lookup, or jes_freeze(), builds the whole index in
+ * a single pass over the tree. Documents that are only rendered or iterated
+ * never pay for hashing.
+ *
+ * jes_load() does not reject duplicate keys in this mode, lookups find the
+ * first of them. If the hash table is too small for the keys, lookups search
+ * linearly and retry building the index. Lookups on a frozen context never
+ * build it. Only adding a key grows a growable workspace for the index.
+ */
+//#define JES_ENABLE_LAZY_HASH_INDEX
+
+/**
+ * JES_ENABLE_ADAPTIVE_WORKSPACE
+ *
+ * In JES_SEARCH_HASHED mode, the boundary between the node pool and the hash
+ * table is not fixed. The node pool fills the workspace from the front, the
+ * hash table is anchored at its end and starts with a single group of slots.
+ *
+ * The table doubles into the free end of the node pool when it is 7/8 full,
+ * and takes whatever is left when it is full. When the node pool is full, the
+ * table gives its unused slots back. Entries are moved by their stored hashes,
+ * no key is read.
+ *
+ * Documents with few keys get nearly the whole workspace for nodes, documents
+ * with many keys get a table sized by their key count. Released nodes are
+ * recycled by the pool, the table only takes them back after jes_compact().
+ * JES_WORKSPACE_NODE_POOL_PERCENT only bounds the initial table of small
+ * workspaces.
+ */
+//#define JES_ENABLE_ADAPTIVE_WORKSPACE
+
 /**
  * JES_WORKSPACE_NODE_POOL_PERCENT
  *
@@ -64,6 +310,16 @@
  */
 #define JES_DEFAULT_PATH_SEPARATOR '.'
 
+/**
+ * JES_MAX_PATH_KEYS
+ *
+ * Maximum number of keys in a path compiled by jes_compile_path().
+ * Default: 8 keys.
+ */
+#ifndef JES_MAX_PATH_KEYS
+  #define JES_MAX_PATH_KEYS 8
+#endif
+
 /**
  * JES_TAB_SIZE
  *
@@ -85,22 +341,81 @@
  * Internal size constants (platform-dependent)
  * ========================================================================= */
 
+#ifdef JES_USE_32BIT_NODE_DESCRIPTOR
+  #define JES_NODE_DESCRIPTOR_SIZE  4
+#else
+  #define JES_NODE_DESCRIPTOR_SIZE  2
+#endif
+
+/* A node holds one element and 4 node descriptors (parent, sibling, first_child, last_child).
+   Merged key nodes hold a second element for the member value and optional
+   descriptors add links to the left sibling and to the subtree end and a
+   child count. */
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+  #define JES_NODE_SUBTREE_LINK_COUNT 1
+#else
+  #define JES_NODE_SUBTREE_LINK_COUNT 0
+#endif
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+  #define JES_NODE_PREV_LINK_COUNT 1
+#else
+  #define JES_NODE_PREV_LINK_COUNT 0
+#endif
+#ifdef JES_USE_CHILD_COUNT
+  #define JES_NODE_CHILD_COUNT_LINK_COUNT 1
+#else
+  #define JES_NODE_CHILD_COUNT_LINK_COUNT 0
+#endif
+#define JES_NODE_LINK_COUNT (4 + JES_NODE_SUBTREE_LINK_COUNT + JES_NODE_PREV_LINK_COUNT + JES_NODE_CHILD_COUNT_LINK_COUNT)
+#ifdef JES_USE_MERGED_KEY_NODE
+  #define JES_NODE_ELEMENT_COUNT 2
+#else
+  #define JES_NODE_ELEMENT_COUNT 1
+#endif
+
+#ifdef JES_USE_COMPACT_NODE
+  #define JES_ELEMENT_SIZE    8
+  #define JES_NODE_ALIGNMENT  4
+#else
+  #define JES_ELEMENT_SIZE    (2 * __SIZEOF_POINTER__)
+  #define JES_NODE_ALIGNMENT  __SIZEOF_POINTER__
+#endif
+
+#define JES_NODE_SIZE \
+  ((((JES_NODE_ELEMENT_COUNT * JES_ELEMENT_SIZE) + (JES_NODE_LINK_COUNT * JES_NODE_DESCRIPTOR_SIZE)) \
+  + (JES_NODE_ALIGNMENT - 1)) / JES_NODE_ALIGNMENT * JES_NODE_ALIGNMENT)
+
+#ifdef JES_ENABLE_WORKSPACE_GROW
+  /* Grow callback, grown buffer and its size */
+  #define JES_CONTEXT_GROW_SIZE (3 * __SIZEOF_POINTER__)
+#else
+  #define JES_CONTEXT_GROW_SIZE 0
+#endif
+
+#ifdef JES_ENABLE_FILE_MAPPING
+  /* Mapped file and its size */
+  #define JES_CONTEXT_FILE_SIZE (2 * __SIZEOF_POINTER__)
+#else
+  #define JES_CONTEXT_FILE_SIZE 0
+#endif
+
+#ifdef JES_ENABLE_ARRAY_INDEX
+  /* Array index table, indexed array count and owner, offset and size per slot */
+  #define JES_CONTEXT_ARRAY_INDEX_SIZE ((2 + 3 * JES_ARRAY_INDEX_SLOTS) * __SIZEOF_POINTER__)
+#else
+  #define JES_CONTEXT_ARRAY_INDEX_SIZE 0
+#endif
+
 #if __SIZEOF_POINTER__ == 4
-  #define JES_CONTEXT_SIZE  128
   #ifdef JES_USE_32BIT_NODE_DESCRIPTOR
-    #define JES_NODE_SIZE   24
+    #define JES_CONTEXT_SIZE  (144 + JES_CONTEXT_GROW_SIZE + JES_CONTEXT_ARRAY_INDEX_SIZE + JES_CONTEXT_FILE_SIZE)
   #else
-    #define JES_NODE_SIZE   16
+    #define JES_CONTEXT_SIZE  (140 + JES_CONTEXT_GROW_SIZE + JES_CONTEXT_ARRAY_INDEX_SIZE + JES_CONTEXT_FILE_SIZE)
   #endif
   #define JES_STREAMING_SERIALIZER_CONTAINER_SIZE 4
   #define JES_STREAMING_SERIALIZER_CONTEXT_SIZE   28
 #else
-  #define JES_CONTEXT_SIZE  248
-  #ifdef JES_USE_32BIT_NODE_DESCRIPTOR
-    #define JES_NODE_SIZE   28
-  #else
-    #define JES_NODE_SIZE   24
-  #endif
+  #define JES_CONTEXT_SIZE  (264 + JES_CONTEXT_GROW_SIZE + JES_CONTEXT_ARRAY_INDEX_SIZE + JES_CONTEXT_FILE_SIZE)
   #define JES_STREAMING_SERIALIZER_CONTAINER_SIZE 4
   #define JES_STREAMING_SERIALIZER_CONTEXT_SIZE   48
 #endif
@@ -229,11 +544,21 @@ struct jes_streaming_serializer_context;
  * The value pointer references the original JSON buffer directly — it is
  * NOT null-terminated and NOT copied. The source buffer must remain valid
  * for the lifetime of the context.
+ *
+ * With JES_USE_COMPACT_NODE the pointer is replaced by an offset into the
+ * JSON buffer. Use jes_get_element_value() to resolve it.
+ *
+ * The length of a JES_ARRAY element is used internally and may drop to 0
+ * when the array is edited.
  */
 struct jes_element {
   uint16_t    type;    /* Element type (see jes_type) */
   uint16_t    length;  /* Length of value in bytes */
+#ifdef JES_USE_COMPACT_NODE
+  uint32_t    offset;  /* Offset into the original JSON buffer or a reference to an external value */
+#else
   const char* value;   /* Pointer into the original JSON buffer */
+#endif
 };
 
 /**
@@ -257,11 +582,25 @@ struct jes_workspace_stat {
     size_t node_mng_size;         /* Bytes used by the node management module */
     size_t node_mng_capacity;     /* Maximum number of nodes */
     size_t node_mng_node_count;   /* Currently allocated nodes */
+    size_t node_size;             /* Bytes per node */
+    size_t node_link_size;        /* Bytes per node spent on tree links. Optional links
+                                     (JES_USE_PREV_SIBLING_DESCRIPTOR, JES_USE_SUBTREE_END_DESCRIPTOR)
+                                     trade node capacity for faster edits and traversals. */
     size_t hash_table_size;       /* Bytes used by the hash table (0 if disabled) */
     size_t hash_table_capacity;   /* Maximum number of hash entries */
     size_t hash_table_entry_count;/* Currently allocated hash entries */
 };
 
+/**
+ * Workspace requirements of a JSON document.
+ * Returned by jes_estimate().
+ */
+struct jes_workspace_estimate {
+  size_t node_count;     /* Nodes the parser allocates for the document */
+  size_t key_count;      /* Object keys, each taking one hash table entry */
+  size_t workspace_size; /* Minimal workspace size in bytes for jes_load() */
+};
+
 /**
  * Detailed diagnostic snapshot from the last parser or serializer operation.
  * Returned by jes_get_status_block(). Useful when jes_get_status() alone
@@ -275,6 +614,67 @@ struct jes_status_block {
   size_t             cursor_pos;   /* Column position in the JSON document */
 };
 
+/**
+ * Descriptor of an element for the unchecked handle API (see
+ * jes_get_element_handle()). Handles stay valid as long as the element exists,
+ * also when the workspace grows, but not across jes_compact().
+ */
+typedef size_t jes_handle;
+
+#define JES_INVALID_HANDLE ((jes_handle)-1)
+
+/**
+ * Traversal events reported by jes_iterator_next().
+ */
+enum jes_iterator_event {
+  JES_ITERATOR_END = 0, /* Traversal is complete */
+  JES_ITERATOR_ENTER,   /* Pre-order: the element is visited before its children */
+  JES_ITERATOR_LEAVE,   /* Post-order: the element is visited after its children */
+};
+
+/**
+ * External depth-first iterator over a subtree. Set up by jes_iterator_init().
+ *
+ * The iterator keeps its own traversal state, so any number of iterators can
+ * walk the same context at the same time, independent of jes_render() and
+ * jes_get_stat(). Every element is reported twice: JES_ITERATOR_ENTER before
+ * and JES_ITERATOR_LEAVE after its children.
+ *
+ * Deleting the current element or one of its ancestors, or a workspace that
+ * grows, invalidates the iterator. Only element and event may be read by the
+ * application.
+ */
+struct jes_iterator {
+  struct jes_context*     ctx;      /* Context of the traversed tree */
+  struct jes_element*     start;    /* Root of the traversed subtree */
+  struct jes_element*     element;  /* Current element, NULL after the traversal */
+  enum jes_iterator_event event;    /* Event of the current element */
+  bool                    is_value; /* Current element is the value of a merged member */
+};
+
+/**
+ * A key of a compiled path.
+ */
+struct jes_path_key {
+  const char* keyword; /* Points into the compiled path string */
+  size_t      length;  /* Length of the keyword in bytes */
+  uint32_t    hash;    /* Hash of the keyword, independent of its object */
+};
+
+/**
+ * Key path split and hashed once by jes_compile_path(), for paths that are
+ * looked up repeatedly.
+ *
+ * The keywords point into the compiled string, which must outlive the path.
+ * The hashes are valid for every context with the same hash seed, lookups
+ * in other contexts hash the keywords again. Fields are internal.
+ */
+struct jes_path {
+  size_t              key_count;
+  uint32_t            seed;  /* Hash seed of the keys */
+  struct jes_path_key keys[JES_MAX_PATH_KEYS];
+};
+
 /* =========================================================================
  * Context setup
  * ========================================================================= */
@@ -300,6 +700,48 @@ struct jes_status_block {
  */
 struct jes_context* jes_init(void* buffer, size_t buffer_size, enum jes_search_mode mode);
 
+#ifdef JES_ENABLE_WORKSPACE_GROW
+/**
+ * Workspace grow callback. Follows the semantics of realloc(): returns a
+ * buffer of at least size bytes that holds the content of the given buffer,
+ * or NULL if the memory can not be provided (the given buffer stays valid).
+ * buffer is NULL on the first request. A size of 0 releases the buffer.
+ *
+ * @code
+ * static void* grow(void* buffer, size_t size)
+ * {
+ *   if (size == 0) {
+ *     free(buffer);
+ *     return NULL;
+ *   }
+ *   return realloc(buffer, size);
+ * }
+ * @endcode
+ */
+typedef void* (*jes_workspace_grow_fn)(void* buffer, size_t size);
+
+/**
+ * Initializes a JES context like jes_init() with a workspace that can grow.
+ *
+ * When the node pool or the hash table is full, the grow callback is asked for
+ * a buffer twice the size of the current one. The node pool and the hash table
+ * move to that buffer, while the context stays in the given workspace.
+ * jes_load() keeps a grown buffer for the next document. jes_reset() releases
+ * it and returns to the given workspace.
+ *
+ * @param buffer      Pointer to caller-owned workspace memory. Must be properly aligned.
+ * @param buffer_size Size of the buffer in bytes.
+ * @param mode        Key search strategy (see jes_init()).
+ * @param grow        Grow callback. NULL behaves like jes_init().
+ * @return Initialized context pointer on success, NULL on failure.
+ *
+ * @note Call jes_reset() before discarding the context to release a grown buffer.
+ */
+struct jes_context* jes_init_growable(void* buffer, size_t buffer_size,
+                                      enum jes_search_mode mode,
+                                      jes_workspace_grow_fn grow);
+#endif
+
 /**
  * Initializes a streaming serializer context.
  *
@@ -321,13 +763,63 @@ struct jes_streaming_serializer_context* jes_init_streaming(
 
 /**
  * Resets the context, clearing the JSON tree and internal state.
- * The workspace buffer is retained and can be reused immediately.
+ * The workspace buffer is retained and can be reused immediately. A buffer
+ * provided by the grow callback of jes_init_growable() is released.
  *
  * @param ctx JES context.
  * @return JES_NO_ERROR on success.
  */
 jes_status jes_reset(struct jes_context* ctx);
 
+/**
+ * Rewrites the node pool in document order and drops the list of released nodes.
+ *
+ * Deleting and adding elements recycles released nodes, so after many edits
+ * neighbouring elements are scattered across the pool. Compacting restores the
+ * memory layout of a freshly loaded document, which speeds up traversal,
+ * rendering and key lookups. Runs in place in linear time.
+ *
+ * All element pointers obtained before the call are invalidated.
+ *
+ * @param ctx JES context.
+ * @return JES_NO_ERROR on success.
+ */
+jes_status jes_compact(struct jes_context* ctx);
+
+/**
+ * Makes the context read-only, so a loaded document can be shared by several
+ * threads without locking.
+ *
+ * Functions that modify the tree, jes_load(), jes_load_image(), jes_reset(),
+ * jes_compact(), jes_set_hash_seed() and jes_set_path_separator() fail with
+ * JES_INVALID_OPERATION on a frozen context.
+ * The status of a frozen context is still written by all functions that
+ * report through jes_get_status(), so concurrent readers must use the _r
+ * lookups (jes_get_key_r(), jes_get_value_r(), jes_get_array_size_r(),
+ * jes_get_array_value_r()), iterators and handles, which never write to the
+ * context. Rendering is not reentrant. A frozen context stays frozen until it
+ * is initialized again with jes_init().
+ *
+ * @param ctx JES context.
+ * @return JES_NO_ERROR on success.
+ */
+jes_status jes_freeze(struct jes_context* ctx);
+
+/**
+ * Sets the seed of the key hashes in JES_SEARCH_HASHED mode.
+ *
+ * The seed is mixed into every key hash, so an application that parses
+ * untrusted documents can pick a random seed per context and keys that all
+ * collide in the hash table can not be prepared in advance. The keys of a
+ * loaded tree are hashed again. The seed is kept by jes_reset() and
+ * jes_load() and is 0 after jes_init().
+ *
+ * @param ctx JES context.
+ * @param seed Any value.
+ * @return JES_NO_ERROR on success. JES_INVALID_OPERATION on a frozen context.
+ */
+jes_status jes_set_hash_seed(struct jes_context* ctx, uint32_t seed);
+
 /* =========================================================================
  * Size queries
  * ========================================================================= */
@@ -355,6 +847,24 @@ size_t jes_node_size(void);
     (jes_context_size() + \
     (nodes_count) * jes_node_size() )
 
+/**
+ * Calculates the workspace needed to load a JSON document.
+ *
+ * A single pass over the document counts its values and keys without
+ * tokenizing or validating them. The result is exact for valid JSON in the
+ * current build configuration and includes the hash table share in
+ * JES_SEARCH_HASHED mode.
+ *
+ * @param json_data   Pointer to JSON text.(does not need to be null-terminated.)
+ * @param json_length Length of JSON text in bytes.
+ * @param mode        Search mode the workspace will be initialized with.
+ * @return Node count, key count and workspace size. workspace_size is 0 if
+ *         the document has more nodes or keys than a node descriptor can
+ *         address.
+ */
+struct jes_workspace_estimate jes_estimate(const char* json_data, size_t json_length,
+                                           enum jes_search_mode mode);
+
 /* =========================================================================
  * Parse & serialize
  * ========================================================================= */
@@ -399,6 +909,77 @@ size_t jes_evaluate(struct jes_context *ctx, bool compact);
  */
 size_t jes_render(struct jes_context* ctx, char* buffer, size_t buffer_length, bool compact);
 
+/**
+ * Writes the tree as a relocatable binary image.
+ *
+ * The image holds the used part of the node pool, the hash table entries and
+ * a copy of the JSON data and of all values added through the API. Pointers
+ * are replaced by offsets, so the image can be stored in a file or moved in
+ * memory and be restored with jes_load_image() without parsing.
+ *
+ * An image is only valid for a build with the same configuration options and
+ * the same pointer size.
+ *
+ * @param ctx         JES context.
+ * @param buffer      Output buffer aligned to JES_ALIGNMENT, or NULL to query
+ *                    the image size.
+ * @param buffer_size Size of the output buffer in bytes.
+ * @return Image size in bytes, or 0 on failure. Call jes_get_status() to
+ *         retrieve the error code on failure.
+ */
+size_t jes_save_image(struct jes_context* ctx, void* buffer, size_t buffer_size);
+
+/**
+ * Restores a tree from an image written by jes_save_image().
+ *
+ * The nodes are copied to the workspace and their pointers are rebased. The
+ * hash table is filled from the stored entries without hashing the keys again,
+ * unless the image was written in JES_SEARCH_LINEAR mode. Like the JSON data
+ * of jes_load(), the image is referenced by the values of the tree and must be
+ * valid and unchanged for the lifetime of the tree.
+ *
+ * The image layout is checked, the content is trusted. Only load images
+ * written by jes_save_image().
+ *
+ * @param ctx        JES context.
+ * @param image      Image aligned to JES_ALIGNMENT.
+ * @param image_size Size of the image in bytes.
+ * @return JES_NO_ERROR on success, JES_INVALID_PARAMETER if the image is not
+ *         valid for this build, JES_OUT_OF_MEMORY if the workspace is too small.
+ */
+jes_status jes_load_image(struct jes_context* ctx, const void* image, size_t image_size);
+
+#ifdef JES_ENABLE_FILE_MAPPING
+/**
+ * Parses a JSON file like jes_load(), directly from a read-only mapping of
+ * the file.
+ *
+ * The mapping is referenced by the tree and is released by jes_reset() or the
+ * next jes_load(), jes_load_image() or file load. The file must not be
+ * modified while it is mapped.
+ *
+ * @param ctx  JES context.
+ * @param path Path of the JSON file.
+ * @return JES_NO_ERROR on success, JES_INVALID_PARAMETER if the file can not
+ *         be opened or is empty, or a tokenizer/parser status code.
+ */
+jes_status jes_load_file(struct jes_context* ctx, const char* path);
+
+/**
+ * Restores a tree like jes_load_image(), directly from a read-only mapping of
+ * an image file written with jes_save_image().
+ *
+ * The mapping is released like the mapping of jes_load_file().
+ *
+ * @param ctx  JES context.
+ * @param path Path of the image file.
+ * @return JES_NO_ERROR on success, JES_INVALID_PARAMETER if the file can not
+ *         be opened or is not a valid image, JES_OUT_OF_MEMORY if the
+ *         workspace is too small.
+ */
+jes_status jes_load_image_file(struct jes_context* ctx, const char* path);
+#endif
+
 /* =========================================================================
  * Error handling
  * ========================================================================= */
@@ -531,6 +1112,122 @@ struct jes_element* jes_get_child(struct jes_context* ctx, struct jes_element* e
  */
 struct jes_element* jes_get_sibling(struct jes_context* ctx, struct jes_element* element);
 
+/**
+ * Returns a pointer to the value of the given element.
+ *
+ * The value is NOT null-terminated. Use element->length to get its size.
+ * This is the portable way to access a value and is required when
+ * JES_USE_COMPACT_NODE is enabled.
+ *
+ * @param ctx     JES context.
+ * @param element Target element.
+ * @return Pointer to the element value, or NULL if element is invalid.
+ */
+const char* jes_get_element_value(struct jes_context* ctx, struct jes_element* element);
+
+/**
+ * Sets up an iterator to traverse the subtree of the given element, including
+ * the element itself. The traversal starts with the first call of
+ * jes_iterator_next().
+ *
+ * @param ctx      JES context.
+ * @param iterator Caller-owned iterator.
+ * @param element  Root of the subtree to traverse, e.g. jes_get_root().
+ * @return JES_NO_ERROR on success, JES_INVALID_PARAMETER if element is invalid.
+ */
+jes_status jes_iterator_init(struct jes_context* ctx, struct jes_iterator* iterator, struct jes_element* element);
+
+/**
+ * Moves the iterator to the next event of a depth-first traversal.
+ * The current element is validated on every step.
+ *
+ * @param iterator Iterator set up by jes_iterator_init().
+ * @return JES_ITERATOR_ENTER or JES_ITERATOR_LEAVE with iterator->element set, or
+ *         JES_ITERATOR_END when the traversal is complete or the iterator is invalid.
+ */
+enum jes_iterator_event jes_iterator_next(struct jes_iterator* iterator);
+
+/**
+ * Same as jes_iterator_next() without any checks of the context or the current
+ * element. Meant for tight loops over a tree that is not modified during the
+ * traversal.
+ *
+ * @param iterator Iterator set up by jes_iterator_init().
+ * @return Next traversal event.
+ */
+enum jes_iterator_event jes_iterator_next_unchecked(struct jes_iterator* iterator);
+
+/* =========================================================================
+ * Handle-based navigation
+ *
+ * Parallel to the navigation functions above, for trusted hot loops. Handles
+ * are only checked by assertions in debug builds: passing an invalid handle
+ * or one of a deleted element is undefined behavior in release builds.
+ *
+ * Example — visit the children of the root:
+ * @code
+ * jes_handle iter;
+ * for (iter = jes_get_child_handle(ctx, jes_get_root_handle(ctx));
+ *      iter != JES_INVALID_HANDLE;
+ *      iter = jes_get_sibling_handle(ctx, iter)) {
+ *     struct jes_element* element = jes_get_handle_element(ctx, iter);
+ * }
+ * @endcode
+ * ========================================================================= */
+
+/**
+ * Returns the handle of an element. The element is validated.
+ *
+ * @param ctx     JES context.
+ * @param element Target element.
+ * @return Handle, or JES_INVALID_HANDLE if element is invalid.
+ */
+jes_handle jes_get_element_handle(struct jes_context* ctx, struct jes_element* element);
+
+/**
+ * Returns the element of a handle.
+ *
+ * @param ctx    JES context.
+ * @param handle Handle of an existing element, or JES_INVALID_HANDLE.
+ * @return Element, or NULL for JES_INVALID_HANDLE.
+ */
+struct jes_element* jes_get_handle_element(struct jes_context* ctx, jes_handle handle);
+
+/**
+ * Returns the handle of the root element.
+ *
+ * @param ctx JES context.
+ * @return Root handle, or JES_INVALID_HANDLE if the tree is empty.
+ */
+jes_handle jes_get_root_handle(struct jes_context* ctx);
+
+/**
+ * Same as jes_get_parent() on handles.
+ *
+ * @param ctx    JES context.
+ * @param handle Handle of an existing element.
+ * @return Parent handle, or JES_INVALID_HANDLE for the root.
+ */
+jes_handle jes_get_parent_handle(struct jes_context* ctx, jes_handle handle);
+
+/**
+ * Same as jes_get_child() on handles. The child of a key is its value.
+ *
+ * @param ctx    JES context.
+ * @param handle Handle of an existing element.
+ * @return First child handle, or JES_INVALID_HANDLE if none.
+ */
+jes_handle jes_get_child_handle(struct jes_context* ctx, jes_handle handle);
+
+/**
+ * Same as jes_get_sibling() on handles.
+ *
+ * @param ctx    JES context.
+ * @param handle Handle of an existing element.
+ * @return Next sibling handle, or JES_INVALID_HANDLE if none.
+ */
+jes_handle jes_get_sibling_handle(struct jes_context* ctx, jes_handle handle);
+
 /* =========================================================================
  * Key lookup
  * ========================================================================= */
@@ -558,6 +1255,46 @@ void jes_set_path_separator(struct jes_context* ctx, char separator);
  */
 struct jes_element* jes_get_key(struct jes_context* ctx, struct jes_element* parent, const char* path);
 
+/**
+ * Reentrant jes_get_key(). Reports the status through an out-parameter
+ * instead of the context, so it can run concurrently on a frozen context.
+ *
+ * @param status Receives the status of the lookup. May be NULL.
+ */
+struct jes_element* jes_get_key_r(struct jes_context* ctx, struct jes_element* parent, const char* path, jes_status* status);
+
+/**
+ * Splits a [dot]-separated path into its keys and hashes them once, for
+ * jes_get_key_compiled() and jes_get_value_compiled(). The separator of the
+ * context is used. The context is not modified.
+ *
+ * @param ctx      JES context.
+ * @param path     Null-terminated, separator-delimited key path (e.g. "a.b.c").
+ *                 Must outlive the compiled path.
+ * @param compiled Receives the compiled path.
+ * @return JES_NO_ERROR, or JES_PATH_TOO_LONG if the path exceeds
+ *         JES_MAX_PATH_LENGTH bytes or JES_MAX_PATH_KEYS keys.
+ */
+jes_status jes_compile_path(struct jes_context* ctx, const char* path, struct jes_path* compiled);
+
+/**
+ * Same as jes_get_key() with a path compiled by jes_compile_path(). No path
+ * string is scanned and no keyword is hashed.
+ *
+ * @param ctx      JES context.
+ * @param parent   Starting JES_OBJECT or JES_KEY element.
+ * @param compiled Compiled key path.
+ * @return Found JES_KEY element, or NULL if not found.
+ */
+struct jes_element* jes_get_key_compiled(struct jes_context* ctx, struct jes_element* parent, const struct jes_path* compiled);
+
+/**
+ * Reentrant jes_get_key_compiled(). See jes_get_key_r().
+ *
+ * @param status Receives the status of the lookup. May be NULL.
+ */
+struct jes_element* jes_get_key_compiled_r(struct jes_context* ctx, struct jes_element* parent, const struct jes_path* compiled, jes_status* status);
+
 /**
  * Returns the value element associated with a JES_KEY element.
  *
@@ -578,6 +1315,30 @@ struct jes_element* jes_get_key_value(struct jes_context* ctx, struct jes_elemen
  */
 struct jes_element* jes_get_value(struct jes_context* ctx, struct jes_element* parent, const char* path);
 
+/**
+ * Reentrant jes_get_value(). See jes_get_key_r().
+ *
+ * @param status Receives the status of the lookup. May be NULL.
+ */
+struct jes_element* jes_get_value_r(struct jes_context* ctx, struct jes_element* parent, const char* path, jes_status* status);
+
+/**
+ * Same as jes_get_value() with a path compiled by jes_compile_path().
+ *
+ * @param ctx      JES context.
+ * @param parent   Starting JES_OBJECT or JES_KEY element.
+ * @param compiled Compiled key path.
+ * @return Value element, or NULL if the path is not found.
+ */
+struct jes_element* jes_get_value_compiled(struct jes_context* ctx, struct jes_element* parent, const struct jes_path* compiled);
+
+/**
+ * Reentrant jes_get_value_compiled(). See jes_get_key_r().
+ *
+ * @param status Receives the status of the lookup. May be NULL.
+ */
+struct jes_element* jes_get_value_compiled_r(struct jes_context* ctx, struct jes_element* parent, const struct jes_path* compiled, jes_status* status);
+
 /* =========================================================================
  * Key operations
  * ========================================================================= */
@@ -684,6 +1445,8 @@ struct jes_element* jes_update_key_value_to_null(struct jes_context* ctx, struct
 /**
  * Returns the number of elements in an array.
  * The function iterates all array elements to count them and has a o(n) performance.
+ * With JES_USE_CHILD_COUNT, or for arrays still in their parsed layout, the
+ * size is read in O(1).
  *
  * @param ctx   JES context.
  * @param array A JES_ARRAY element.
@@ -691,8 +1454,19 @@ struct jes_element* jes_update_key_value_to_null(struct jes_context* ctx, struct
  */
 size_t jes_get_array_size(struct jes_context* ctx, struct jes_element* array);
 
+/**
+ * Reentrant jes_get_array_size(). See jes_get_key_r().
+ *
+ * @param status Receives the status of the call. May be NULL.
+ */
+size_t jes_get_array_size_r(struct jes_context* ctx, struct jes_element* array, jes_status* status);
+
 /**
  * Returns the element at the given index in an array (0-based).
+ * Arrays whose values are allocated back to back, as the parser and
+ * jes_compact() lay them out, are accessed in O(1). Inserting or deleting in
+ * the middle of an array breaks the layout; then the array is walked up to
+ * the index, or the array index is read in O(1) with JES_ENABLE_ARRAY_INDEX.
  *
  * @param ctx   JES context.
  * @param array A JES_ARRAY element.
@@ -701,6 +1475,14 @@ size_t jes_get_array_size(struct jes_context* ctx, struct jes_element* array);
  */
 struct jes_element* jes_get_array_value(struct jes_context* ctx, struct jes_element* array, int32_t index);
 
+/**
+ * Reentrant jes_get_array_value(). See jes_get_key_r().
+ * With JES_ENABLE_ARRAY_INDEX, no array index is built on a frozen context.
+ *
+ * @param status Receives the status of the lookup. May be NULL.
+ */
+struct jes_element* jes_get_array_value_r(struct jes_context* ctx, struct jes_element* array, int32_t index, jes_status* status);
+
 /**
  * Appends a new value at the end of an array.
  *
@@ -955,4 +1737,24 @@ jes_status jes_render_false(struct jes_streaming_serializer_context* ctx);
          iter_ != NULL && iter_->type == JES_KEY; \
          iter_ = jes_get_sibling(ctx_, iter_))
 
+/**
+ * JES_ITERATOR_FOR_EACH(ctx, elem, iterator)
+ *
+ * Visits elem and all its descendants in pre-order without validating each
+ * step. The tree must not be modified inside the loop.
+ *
+ * Example — count the strings of a document:
+ * @code
+ * struct jes_iterator iterator;
+ * size_t strings = 0;
+ * JES_ITERATOR_FOR_EACH(ctx, jes_get_root(ctx), iterator) {
+ *     if (iterator.element->type == JES_STRING) strings++;
+ * }
+ * @endcode
+ */
+#define JES_ITERATOR_FOR_EACH(ctx_, elem_, iterator_) \
+    for (jes_iterator_init(ctx_, &(iterator_), elem_); \
+         jes_iterator_next_unchecked(&(iterator_)) != JES_ITERATOR_END; ) \
+      if ((iterator_).event == JES_ITERATOR_ENTER)
+
 #endif /* JES_H */
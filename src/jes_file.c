@@ -0,0 +1,128 @@
+/* mmap() and posix_madvise() are POSIX extensions to C */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "jes.h"
+#include "jes_private.h"
+
+#ifdef JES_ENABLE_FILE_MAPPING
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+void jes_unmap_file(struct jes_context* ctx)
+{
+  if (ctx->mapping != NULL) {
+    munmap(ctx->mapping, ctx->mapping_size);
+    ctx->mapping = NULL;
+    ctx->mapping_size = 0;
+  }
+}
+
+static jes_status jes_map_file(const char* path, int advice, void** mapping, size_t* size)
+{
+  struct stat file_stat;
+  void* data;
+  int fd;
+
+  if (path == NULL) {
+    return JES_INVALID_PARAMETER;
+  }
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return JES_INVALID_PARAMETER;
+  }
+
+  if ((fstat(fd, &file_stat) != 0) || (file_stat.st_size <= 0)) {
+    close(fd);
+    return JES_INVALID_PARAMETER;
+  }
+
+  data = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  /* The mapping keeps its own reference to the file */
+  close(fd);
+  if (data == MAP_FAILED) {
+    return JES_OUT_OF_MEMORY;
+  }
+  /* Only a hint for the read-ahead. A failure does not matter. */
+  (void)posix_madvise(data, (size_t)file_stat.st_size, advice);
+
+  *mapping = data;
+  *size = (size_t)file_stat.st_size;
+  return JES_NO_ERROR;
+}
+
+/* Hands a new mapping over to the context if the tree references it. A load
+   that failed before clearing the previous tree does not. */
+static void jes_keep_mapping(struct jes_context* ctx, void* mapping, size_t size)
+{
+  uintptr_t json_data = (uintptr_t)ctx->serdes.tokenizer.json_data;
+
+  if ((json_data >= (uintptr_t)mapping) && (json_data <= (uintptr_t)mapping + size)) {
+    ctx->mapping = mapping;
+    ctx->mapping_size = size;
+  }
+  else {
+    munmap(mapping, size);
+  }
+}
+
+jes_status jes_load_file(struct jes_context* ctx, const char* path)
+{
+  void* mapping = NULL;
+  size_t size = 0;
+
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return JES_INVALID_CONTEXT;
+  }
+
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return ctx->status;
+  }
+
+  /* The tokenizer reads the document once from start to end */
+  ctx->status = jes_map_file(path, POSIX_MADV_SEQUENTIAL, &mapping, &size);
+  if (ctx->status != JES_NO_ERROR) {
+    return ctx->status;
+  }
+
+  jes_load(ctx, mapping, size);
+  jes_keep_mapping(ctx, mapping, size);
+
+  return ctx->status;
+}
+
+jes_status jes_load_image_file(struct jes_context* ctx, const char* path)
+{
+  void* mapping = NULL;
+  size_t size = 0;
+
+  if ((ctx == NULL) || !JES_IS_INITIATED(ctx)) {
+    return JES_INVALID_CONTEXT;
+  }
+
+  if (ctx->frozen) {
+    ctx->status = JES_INVALID_OPERATION;
+    return ctx->status;
+  }
+
+  /* The nodes are copied right away, the text section is read on demand */
+  ctx->status = jes_map_file(path, POSIX_MADV_WILLNEED, &mapping, &size);
+  if (ctx->status != JES_NO_ERROR) {
+    return ctx->status;
+  }
+
+  jes_load_image(ctx, mapping, size);
+  jes_keep_mapping(ctx, mapping, size);
+
+  return ctx->status;
+}
+
+#endif
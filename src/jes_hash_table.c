@@ -7,6 +7,7 @@
 #include "jes.h"
 #include "jes_private.h"
 #include "jes_hash_table.h"
+#include "jes_tree.h"
 
 /* Constants from FNV-1a (Fowler–Noll–Vo) algorithm */
 #define JES_FNV_PRIME_32BIT         16777619
@@ -18,41 +19,77 @@
   #define JES_LOG(...) //printf(__VA_ARGS__)
 #endif
 
- /* Reserve a specific address as Tombstone marker */
-static struct jes_element TOMBSTONE_SENTINEL;
-#define JES_HASH_TABLE_TOMBSTONE (&TOMBSTONE_SENTINEL)
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+/* Each slot has a control byte. A used slot keeps the low 7 bits of the key
+ * hash (tag), so probing compares 16 tags at a time and only reads the entries
+ * of matching slots. Free slots have the high bit set. */
+#define JES_HASH_CONTROL_EMPTY    0x80
+#define JES_HASH_CONTROL_DELETED  0xFE
+#define JES_HASH_CONTROL_IS_USED(control_) (((control_) & 0x80) == 0)
+
+#define JES_HASH_TAG(hash_) ((uint8_t)((hash_) & 0x7F))
+/* The group probing starts at. Maps the hash to [0, group_count) with a
+ * multiplication instead of a division, mostly by the high bits of the hash,
+ * so it is independent of the tag. */
+#define JES_HASH_GROUP(hash_, group_count_) \
+  ((size_t)(((uint64_t)(uint32_t)(hash_) * (group_count_)) >> 32))
+
+/* Number of deleted slots that triggers an in-place rehash of the table. A
+ * nearly full table is rehashed before its empty slots run out, they end the
+ * probing of missing keys. */
+#define JES_HASH_TABLE_REHASH_THRESHOLD(table_) \
+  (((table_).capacity - (table_).entry_count) / 2 < (table_).capacity / 8 \
+   ? ((table_).capacity - (table_).entry_count) / 2 : (table_).capacity / 8)
+
+/* Slots probed at a time. Tables smaller than a group are probed as a single
+ * group of capacity slots. */
+#define JES_HASH_GROUP_WIDTH 16
+
+/* Control bytes precede the entries of the table. The entries end at the end
+ * of the table buffer, so the table can grow and shrink at its start. */
+#define JES_HASH_TABLE_CONTROL(entries_, capacity_) ((uint8_t*)(entries_) - (capacity_))
+
+/* Each group has a generation byte, in front of the control bytes. The control
+ * bytes of a group whose generation differs from the one of the table are
+ * stale and the group is empty. Clearing the table starts a new generation,
+ * so it does not touch the slots. */
+#define JES_HASH_GROUP_COUNT(capacity_) (((capacity_) + JES_HASH_GROUP_WIDTH - 1) / JES_HASH_GROUP_WIDTH)
+#define JES_HASH_TABLE_GENERATIONS(entries_, capacity_) \
+  (JES_HASH_TABLE_CONTROL(entries_, capacity_) - JES_HASH_GROUP_COUNT(capacity_))
 
+/* Bytes of a slot: an entry and a control byte */
+#define JES_HASH_SLOT_SIZE (sizeof(struct jes_hash_entry) + 1)
+
+#if JES_HASH_FUNCTION_ID == JES_HASH_FNV1A
 /**
- * @brief Generates a compound hash using the FNV-1a algorithm.
- *
- * This function calculates a hash value based on two inputs:
- * 1. A parent ID (uint32_t)
- * 2. A keyword string
+ * @brief Generates a seeded keyword hash using the FNV-1a algorithm.
  *
  * The function implements the FNV-1a hashing algorithm, which first processes
- * the bytes of the parent ID and then the characters of the keyword string.
- * The resulting hash uniquely represents the combination of a parent node and a
- * key, allowing keys with identical names to be distinguished when stored in
- * separate objects or namespaces.
+ * the bytes of the seed and then the characters of the keyword string. The
+ * hash does not depend on the object of the key, it is combined with the
+ * parent ID by jes_hash_combine().
  *
  * NOTE: hash values are architecture-endian dependent by design
  *
- * @param parent_id The ID of the parent node (typically another hash value)
+ * @param seed Seed of the hash table
  * @param keyword Pointer to the keyword string to be hashed
  * @param keyword_length Length of the keyword string in bytes
  *
- * @return size_t The calculated hash value
+ * @return uint32_t The calculated hash value
  */
-static uint32_t jes_fnv1a_compound_hash(uint32_t parent_id, const char* keyword, size_t keyword_length) {
-  uint8_t* parent_id_bytes = (uint8_t*)&parent_id;
+static uint32_t jes_fnv1a_key_hash(uint32_t seed, const char* keyword, size_t keyword_length) {
+  uint8_t* seed_bytes = (uint8_t*)&seed;
   uint32_t hash = JES_FNV_OFFSET_BASIS_32BIT;
   size_t index;
 
   assert(keyword != NULL);
 
-  /* Process each byte of the parent ID */
-  for (index = 0; index < sizeof(parent_id); index++) {
-    hash ^= parent_id_bytes[index];
+  /* Process each byte of the seed */
+  for (index = 0; index < sizeof(seed); index++) {
+    hash ^= seed_bytes[index];
     hash *= JES_FNV_PRIME_32BIT;
   }
 
@@ -64,140 +101,1004 @@ static uint32_t jes_fnv1a_compound_hash(uint32_t parent_id, const char* keyword,
 
   return hash;
 }
+#endif
+
+#if JES_HASH_FUNCTION_ID != JES_HASH_FNV1A
+/* Secrets of the word hash, odd 64-bit constants with balanced bits */
+#define JES_WORD_HASH_SECRET0 0xA0761D6478BD642FULL
+#define JES_WORD_HASH_SECRET1 0xE7037ED1A0B428DBULL
+
+/* Unaligned little or big endian loads. Hash values are endian dependent, as
+ * they are for FNV-1a. */
+static inline uint64_t jes_hash_read64(const char* bytes)
+{
+  uint64_t value;
+  memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+static inline uint64_t jes_hash_read32(const char* bytes)
+{
+  uint32_t value;
+  memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+/* Reads 1 to 3 bytes into a word, all of them contribute. */
+static inline uint64_t jes_hash_read_short(const char* bytes, size_t length)
+{
+  return ((uint64_t)(unsigned char)bytes[0] << 16) |
+         ((uint64_t)(unsigned char)bytes[length >> 1] << 8) |
+         (uint64_t)(unsigned char)bytes[length - 1];
+}
+#endif
+
+#if JES_HASH_FUNCTION_ID == JES_HASH_WORD
+/* Multiplies two words to 128 bits and folds the halves. */
+static inline uint64_t jes_hash_mix(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+  __uint128_t product = (__uint128_t)a * b;
+  return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+  uint64_t a_high = a >> 32, a_low = (uint32_t)a;
+  uint64_t b_high = b >> 32, b_low = (uint32_t)b;
+  uint64_t high = a_high * b_high;
+  uint64_t middle0 = a_high * b_low;
+  uint64_t middle1 = a_low * b_high;
+  uint64_t low = a_low * b_low;
+  uint64_t carry = ((low >> 32) + (uint32_t)middle0 + (uint32_t)middle1) >> 32;
+
+  low += (middle0 << 32);
+  low += (middle1 << 32);
+  high += (middle0 >> 32) + (middle1 >> 32) + carry;
+  return low ^ high;
+#endif
+}
+
+/**
+ * @brief Generates a seeded keyword hash, reading the keyword eight bytes per
+ *        step.
+ *
+ * A multiply-mix hash in the style of wyhash. Keys of up to 16 bytes are read
+ * with two overlapping loads, longer keys are consumed 16 bytes per round.
+ *
+ * @param seed Seed of the hash table
+ * @param keyword Pointer to the keyword string to be hashed
+ * @param keyword_length Length of the keyword string in bytes
+ *
+ * @return uint32_t The calculated hash value
+ */
+static uint32_t jes_word_key_hash(uint32_t table_seed, const char* keyword, size_t keyword_length)
+{
+  uint64_t seed = jes_hash_mix((uint64_t)table_seed ^ JES_WORD_HASH_SECRET0, JES_WORD_HASH_SECRET1);
+  size_t remaining = keyword_length;
+  uint64_t a = 0;
+  uint64_t b = 0;
+
+  assert(keyword != NULL);
+
+  if (keyword_length <= 16) {
+    if (keyword_length >= 4) {
+      size_t shift = (keyword_length >> 3) << 2;
+      a = (jes_hash_read32(keyword) << 32) | jes_hash_read32(keyword + shift);
+      b = (jes_hash_read32(keyword + keyword_length - 4) << 32) |
+          jes_hash_read32(keyword + keyword_length - 4 - shift);
+    }
+    else if (keyword_length > 0) {
+      a = jes_hash_read_short(keyword, keyword_length);
+    }
+  }
+  else {
+    while (remaining > 16) {
+      seed = jes_hash_mix(jes_hash_read64(keyword) ^ JES_WORD_HASH_SECRET1,
+                          jes_hash_read64(keyword + 8) ^ seed);
+      keyword += 16;
+      remaining -= 16;
+    }
+    /* The last 16 bytes, overlapping the previous round if needed */
+    a = jes_hash_read64(keyword + remaining - 16);
+    b = jes_hash_read64(keyword + remaining - 8);
+  }
+
+  return (uint32_t)jes_hash_mix(JES_WORD_HASH_SECRET1 ^ keyword_length,
+                                jes_hash_mix(a ^ JES_WORD_HASH_SECRET1, b ^ seed));
+}
+#endif
+
+#if JES_HASH_FUNCTION_ID == JES_HASH_CRC32C
+#if defined(__SSE4_2__)
+  #include <nmmintrin.h>
+  #if defined(__x86_64__)
+    #define JES_CRC32C_U64(crc_, value_) ((uint32_t)_mm_crc32_u64((crc_), (value_)))
+  #else
+    #define JES_CRC32C_U64(crc_, value_) \
+      _mm_crc32_u32(_mm_crc32_u32((crc_), (uint32_t)(value_)), (uint32_t)((value_) >> 32))
+  #endif
+#else
+  #include <arm_acle.h>
+  #define JES_CRC32C_U64(crc_, value_) __crc32cd((crc_), (value_))
+#endif
+
+/**
+ * @brief Generates a seeded keyword hash with the CRC32C instruction of the
+ *        CPU, eight bytes per step.
+ *
+ * The CRC is seeded with the table seed and the keyword length. A final
+ * multiplication spreads the CRC over the high bits.
+ *
+ * CRC32C is linear: keys that collide for one seed collide for all of them,
+ * so a seed does not make collisions harder to find.
+ *
+ * @param seed Seed of the hash table
+ * @param keyword Pointer to the keyword string to be hashed
+ * @param keyword_length Length of the keyword string in bytes
+ *
+ * @return uint32_t The calculated hash value
+ */
+static uint32_t jes_crc32c_key_hash(uint32_t seed, const char* keyword, size_t keyword_length)
+{
+  uint32_t crc = JES_CRC32C_U64(seed, (uint64_t)keyword_length);
+  size_t remaining = keyword_length;
+  uint64_t tail;
+
+  assert(keyword != NULL);
+
+  while (remaining >= 8) {
+    crc = JES_CRC32C_U64(crc, jes_hash_read64(keyword));
+    keyword += 8;
+    remaining -= 8;
+  }
+
+  if (remaining >= 4) {
+    tail = (jes_hash_read32(keyword) << 32) | jes_hash_read32(keyword + remaining - 4);
+    crc = JES_CRC32C_U64(crc, tail);
+  }
+  else if (remaining > 0) {
+    crc = JES_CRC32C_U64(crc, jes_hash_read_short(keyword, remaining));
+  }
+
+  return (uint32_t)(((uint64_t)crc * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+#endif
+
+/**
+ * @brief Combines the hash of a keyword with the ID of its parent object, so
+ *        identical keys of different objects get unrelated hashes.
+ *
+ * The finalizer of MurmurHash3. It is a bijection, keys only collide if
+ * their keyword hashes do for the same object.
+ */
+static inline uint32_t jes_hash_combine(uint32_t key_hash, uint32_t parent_id)
+{
+  uint32_t hash = key_hash ^ (parent_id * 0x9E3779B1U);
+
+  hash ^= hash >> 16;
+  hash *= 0x85EBCA6BU;
+  hash ^= hash >> 13;
+  hash *= 0xC2B2AE35U;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+/* Hashes a key of a parent object with the hash function and the seed of the table */
+#define JES_HASH_KEY(table_, parent_id_, keyword_, keyword_length_) \
+  jes_hash_combine((table_)->hash_fn((table_)->seed, (keyword_), (keyword_length_)), (uint32_t)(parent_id_))
+
+/* Keeps the capacity below JES_INVALID_INDEX and a multiple of the group width */
+#define JES_HASH_TABLE_MAX_CAPACITY (((size_t)JES_INVALID_INDEX - 1) & ~(size_t)(JES_HASH_GROUP_WIDTH - 1))
+
+/**
+ * @brief Returns a bit mask of the slots in a group whose control byte matches.
+ *
+ * Full groups are compared with a single SSE2 instruction where available.
+ */
+static uint32_t jes_hash_group_match(const uint8_t* group, size_t width, uint8_t control)
+{
+  uint32_t mask = 0;
+  size_t index;
+
+#if defined(__SSE2__)
+  if (width == JES_HASH_GROUP_WIDTH) {
+    __m128i group_control = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group_control, _mm_set1_epi8((char)control)));
+  }
+#endif
+
+  for (index = 0; index < width; index++) {
+    mask |= (uint32_t)(group[index] == control) << index;
+  }
+  return mask;
+}
+
+/* Position of the lowest set bit of a non-zero mask */
+static size_t jes_hash_first_slot(uint32_t mask)
+{
+#if defined(__GNUC__)
+  return (size_t)__builtin_ctz(mask);
+#else
+  size_t index = 0;
+
+  while ((mask & 1) == 0) {
+    mask >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+static size_t jes_hash_group_width(const struct jes_hash_table_context* table)
+{
+  return (table->capacity < JES_HASH_GROUP_WIDTH) ? table->capacity : JES_HASH_GROUP_WIDTH;
+}
+
+/**
+ * @brief Finds the slot of a key. Returns the capacity if the key is not in the table.
+ *
+ * Groups are probed one after the other. A key is never placed behind a group
+ * that has an empty slot, so the search ends at the first such group.
+ */
+static size_t jes_hash_table_find_slot(struct jes_context* ctx, size_t hash,
+                                       const char* keyword, size_t keyword_length)
+{
+  struct jes_hash_table_context* table = &ctx->hash_table;
+  const uint8_t* control = JES_HASH_TABLE_CONTROL(table->pool, table->capacity);
+  const uint8_t* generations = JES_HASH_TABLE_GENERATIONS(table->pool, table->capacity);
+  size_t width = jes_hash_group_width(table);
+  size_t group_count = table->capacity / width;
+  size_t group = JES_HASH_GROUP(hash, group_count);
+  size_t probe;
+  size_t slot;
+  uint32_t match;
+  uint32_t empty;
+  struct jes_node* key;
+
+  for (probe = 0; probe < group_count; probe++) {
+    match = jes_hash_group_match(&control[group * width], width, JES_HASH_TAG(hash));
+    empty = jes_hash_group_match(&control[group * width], width, JES_HASH_CONTROL_EMPTY);
+    /* The generation is only read when the control bytes would lead to an
+       entry or to the next group. A stale group is empty. */
+    if (((match != 0) || (empty == 0)) && (generations[group] != table->generation)) {
+      break;
+    }
+    for (; match != 0; match &= match - 1) {
+      slot = group * width + jes_hash_first_slot(match);
+      /* Key bytes are only read on a tag match */
+      if (table->pool[slot].hash == hash) {
+        key = JES_HASH_ENTRY_KEY(ctx->node_mng, table->pool[slot]);
+        if ((key->json_tlv.length == keyword_length) &&
+            (memcmp(JES_ELEMENT_VALUE(ctx, &key->json_tlv), keyword, keyword_length) == 0)) {
+          return slot;
+        }
+      }
+    }
+
+    if (empty != 0) {
+      break;
+    }
+    group = (group + 1 < group_count) ? group + 1 : 0;
+  }
+
+  return table->capacity;
+}
+
+#ifdef JES_ENABLE_HYBRID_SEARCH
+/* Number of keys of an object, counted up to limit. */
+static size_t jes_hash_table_count_keys(struct jes_context* ctx, struct jes_node* object, size_t limit)
+{
+#ifdef JES_USE_CHILD_COUNT
+  return (object->child_count < limit) ? object->child_count : limit;
+#else
+  struct jes_node* iter = GET_FIRST_CHILD(ctx->node_mng, object);
+  size_t count = 0;
+
+  while ((iter != NULL) && (count < limit)) {
+    count++;
+    iter = GET_SIBLING(ctx->node_mng, iter);
+  }
+  return count;
+#endif
+}
+#endif
+
+#if defined(JES_ENABLE_HYBRID_SEARCH) || defined(JES_ENABLE_LAZY_HASH_INDEX)
+/* Compares up to limit keys of an object. *rest is set to the first key that
+ * was not compared, NULL if all keys were. */
+static struct jes_node* jes_hash_table_scan_keys(struct jes_context* ctx,
+                                                 struct jes_node* object,
+                                                 const char* keyword,
+                                                 size_t keyword_length,
+                                                 size_t limit,
+                                                 struct jes_node** rest)
+{
+  struct jes_node* iter = GET_FIRST_CHILD(ctx->node_mng, object);
+  size_t count;
+
+  for (count = 0; (iter != NULL) && (count < limit); count++) {
+    if ((iter->json_tlv.length == keyword_length) &&
+        (memcmp(JES_ELEMENT_VALUE(ctx, &iter->json_tlv), keyword, keyword_length) == 0)) {
+      return iter;
+    }
+    iter = GET_SIBLING(ctx->node_mng, iter);
+  }
+
+  *rest = iter;
+  return NULL;
+}
+#endif
 
 /**
  * @brief Searches for a specific key within the JES context's hash table, where keys are
  * indexed based on their parent object and the key string. It uses a compound hash
  * of the parent object's index and the key string to locate entries, and handles
- * hash collisions using linear probing.
+ * hash collisions by probing groups of slots.
+ *
+ * With JES_ENABLE_HYBRID_SEARCH, objects with fewer than JES_HYBRID_SEARCH_MIN_KEYS
+ * keys are not in the table and are searched linearly.
+ *
+ * The keyword is only hashed if key_hash is NULL.
  */
+static struct jes_node* jes_hash_table_find(struct jes_context* ctx,
+                                            struct jes_node* parent_object,
+                                            const char* keyword,
+                                            size_t keyword_length,
+                                            const uint32_t* key_hash)
+{
+  struct jes_hash_table_context* table = &ctx->hash_table;
+  size_t hash;
+  size_t slot;
+
+  assert(parent_object != NULL);
+
+  if (NODE_VALUE_TYPE(parent_object) != JES_OBJECT) {
+    /* Only objects have keys. Linear scans must not match array items. */
+    return NULL;
+  }
+
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+  if (ctx->hash_index_deferred) {
+    struct jes_node* rest;
+    jes_status status = ctx->status;
+    /* A frozen context is not modified by lookups. The nodes do not move, a
+       table that is too small is not built. */
+    if (ctx->frozen || (jes_hash_table_build(ctx, false) != JES_NO_ERROR)) {
+      ctx->status = status;
+      return jes_hash_table_scan_keys(ctx, parent_object, keyword, keyword_length, SIZE_MAX, &rest);
+    }
+    ctx->status = status;
+  }
+#endif
+
+#ifdef JES_ENABLE_HYBRID_SEARCH
+#ifdef JES_USE_CHILD_COUNT
+  if (parent_object->child_count < JES_HASH_TABLE_MIN_KEYS)
+#endif
+  {
+    /* Up to JES_HASH_TABLE_MIN_KEYS keys are compared. An object that has
+       more is indexed, one that has not been passed is not. */
+    struct jes_node* rest;
+    struct jes_node* key = jes_hash_table_scan_keys(ctx, parent_object, keyword, keyword_length,
+                                                    JES_HASH_TABLE_MIN_KEYS, &rest);
+    if ((key != NULL) || (rest == NULL)) {
+      return key;
+    }
+  }
+#endif
+
+  if (key_hash != NULL) {
+    hash = jes_hash_combine(*key_hash, (uint32_t)JES_NODE_INDEX(ctx->node_mng, parent_object));
+  }
+  else {
+    hash = JES_HASH_KEY(table, JES_NODE_INDEX(ctx->node_mng, parent_object), keyword, keyword_length);
+  }
+  slot = jes_hash_table_find_slot(ctx, hash, keyword, keyword_length);
+
+  return (slot < table->capacity) ? JES_HASH_ENTRY_KEY(ctx->node_mng, table->pool[slot]) : NULL;
+}
+
 struct jes_node* jes_hash_table_find_key(struct jes_context* ctx,
                                          struct jes_node* parent_object,
                                          const char* keyword,
                                          size_t keyword_length)
+{
+  return jes_hash_table_find(ctx, parent_object, keyword, keyword_length, NULL);
+}
+
+struct jes_node* jes_hash_table_find_hashed_key(struct jes_context* ctx,
+                                                struct jes_node* parent_object,
+                                                const char* keyword,
+                                                size_t keyword_length,
+                                                uint32_t key_hash)
+{
+  return jes_hash_table_find(ctx, parent_object, keyword, keyword_length, &key_hash);
+}
+
+uint32_t jes_hash_table_hash_keyword(uint32_t seed, const char* keyword, size_t keyword_length)
+{
+#if JES_HASH_FUNCTION_ID == JES_HASH_CRC32C
+  return jes_crc32c_key_hash(seed, keyword, keyword_length);
+#elif JES_HASH_FUNCTION_ID == JES_HASH_WORD
+  return jes_word_key_hash(seed, keyword, keyword_length);
+#else
+  return jes_fnv1a_key_hash(seed, keyword, keyword_length);
+#endif
+}
+
+/* Returns the first free slot on the probe sequence of a hash, a deleted one
+ * included, or the capacity if the table is full. */
+/* Empties a stale group before one of its slots is used. */
+static void jes_hash_table_renew_group(struct jes_hash_table_context* table, size_t group)
+{
+  uint8_t* generations = JES_HASH_TABLE_GENERATIONS(table->pool, table->capacity);
+  size_t width = jes_hash_group_width(table);
+
+  if (generations[group] != table->generation) {
+    memset(JES_HASH_TABLE_CONTROL(table->pool, table->capacity) + group * width, JES_HASH_CONTROL_EMPTY, width);
+    generations[group] = table->generation;
+  }
+}
+
+void jes_hash_table_renew(struct jes_hash_table_context* table)
+{
+  size_t group;
+
+  for (group = 0; group < JES_HASH_GROUP_COUNT(table->capacity); group++) {
+    jes_hash_table_renew_group(table, group);
+  }
+}
+
+static size_t jes_hash_table_find_free(struct jes_hash_table_context* table, size_t hash)
+{
+  const uint8_t* control = JES_HASH_TABLE_CONTROL(table->pool, table->capacity);
+  const uint8_t* generations = JES_HASH_TABLE_GENERATIONS(table->pool, table->capacity);
+  size_t width = jes_hash_group_width(table);
+  size_t group_count = table->capacity / width;
+  size_t group = JES_HASH_GROUP(hash, group_count);
+  size_t probe;
+  uint32_t match;
+
+  for (probe = 0; probe < group_count; probe++) {
+    if (generations[group] != table->generation) {
+      jes_hash_table_renew_group(table, group);
+      return group * width;
+    }
+    match = jes_hash_group_match(&control[group * width], width, JES_HASH_CONTROL_EMPTY) |
+            jes_hash_group_match(&control[group * width], width, JES_HASH_CONTROL_DELETED);
+    if (match != 0) {
+      return group * width + jes_hash_first_slot(match);
+    }
+    group = (group + 1 < group_count) ? group + 1 : 0;
+  }
+
+  return table->capacity;
+}
+
+/* Stores an entry in a free slot and marks the slot with the tag of the hash. */
+static void jes_hash_table_store(struct jes_context* ctx, size_t slot,
+                                 size_t hash, struct jes_node* key)
 {
   struct jes_hash_table_context* table = &ctx->hash_table;
-  struct jes_node* key = NULL;
-  size_t hash;
-  size_t index;
+  uint8_t* control = JES_HASH_TABLE_CONTROL(table->pool, table->capacity);
 
-  assert(parent_object != NULL);
+  if (control[slot] == JES_HASH_CONTROL_DELETED) {
+    assert(table->deleted_count > 0);
+    table->deleted_count--;
+  }
+  table->pool[slot].hash = hash;
+  table->pool[slot].key = JES_HASH_ENTRY_REF(ctx->node_mng, key);
+  control[slot] = JES_HASH_TAG(hash);
+  table->entry_count++;
+}
 
-  hash = table->hash_fn(JES_NODE_INDEX(ctx->node_mng, parent_object), keyword, keyword_length);
-  index = hash % table->capacity;
-
-  size_t start_index = index;
-  /* Linear probing */
-  while (table->pool[index].key_element != NULL) {
-    if ((table->pool[index].key_element != JES_HASH_TABLE_TOMBSTONE) &&
-        (table->pool[index].hash == hash) &&
-        (table->pool[index].key_element->length == keyword_length) &&
-        (memcmp(table->pool[index].key_element->value, keyword, keyword_length) == 0)) {
-      key = (struct jes_node*)table->pool[index].key_element;
-      break;
+/* Frees a used slot. Probing stops at the first group with an empty slot, so
+ * no probe sequence has passed a group that still has one and the slot can
+ * become empty. Slots of groups that have been full are marked deleted. */
+static void jes_hash_table_erase(struct jes_hash_table_context* table, size_t slot)
+{
+  uint8_t* control = JES_HASH_TABLE_CONTROL(table->pool, table->capacity);
+  size_t width = jes_hash_group_width(table);
+
+  assert(table->entry_count > 0);
+  table->entry_count--;
+  if (jes_hash_group_match(&control[slot - slot % width], width, JES_HASH_CONTROL_EMPTY) != 0) {
+    control[slot] = JES_HASH_CONTROL_EMPTY;
+  }
+  else {
+    control[slot] = JES_HASH_CONTROL_DELETED;
+    table->deleted_count++;
+  }
+}
+
+/**
+ * @brief Moves the entries of all slots marked as deleted to the first free
+ *        slot of their probe sequence. The table has no other deleted slots.
+ *
+ * A target slot that still holds an entry to be moved swaps with the current
+ * slot. Stored hashes are reused, no key is read.
+ */
+static void jes_hash_table_reinsert(struct jes_hash_table_context* table)
+{
+  uint8_t* control = JES_HASH_TABLE_CONTROL(table->pool, table->capacity);
+  size_t width = jes_hash_group_width(table);
+  struct jes_hash_entry entry;
+  size_t slot;
+  size_t target;
+
+  for (slot = 0; slot < table->capacity; slot++) {
+    while (control[slot] == JES_HASH_CONTROL_DELETED) {
+      target = jes_hash_table_find_free(table, table->pool[slot].hash);
+      assert(target < table->capacity);
+      if (target / width == slot / width) {
+        /* Already in the first group with a free slot */
+        control[slot] = JES_HASH_TAG(table->pool[slot].hash);
+      }
+      else if (control[target] == JES_HASH_CONTROL_EMPTY) {
+        table->pool[target] = table->pool[slot];
+        control[target] = JES_HASH_TAG(table->pool[target].hash);
+        control[slot] = JES_HASH_CONTROL_EMPTY;
+      }
+      else {
+        /* The entry of the target slot is moved in the next round */
+        entry = table->pool[target];
+        table->pool[target] = table->pool[slot];
+        table->pool[slot] = entry;
+        control[target] = JES_HASH_TAG(table->pool[target].hash);
+      }
+    }
+  }
+
+  table->deleted_count = 0;
+}
+
+/* Turns all deleted slots into empty ones without moving the table. */
+static void jes_hash_table_rehash_in_place(struct jes_hash_table_context* table)
+{
+  uint8_t* control = JES_HASH_TABLE_CONTROL(table->pool, table->capacity);
+  size_t slot;
+
+  jes_hash_table_renew(table);
+  for (slot = 0; slot < table->capacity; slot++) {
+    control[slot] = JES_HASH_CONTROL_IS_USED(control[slot]) ? JES_HASH_CONTROL_DELETED
+                                                             : JES_HASH_CONTROL_EMPTY;
+  }
+
+  jes_hash_table_reinsert(table);
+}
+
+/* Deleted slots lengthen the probing of missing keys until the table is rehashed. */
+static void jes_hash_table_check_deleted(struct jes_hash_table_context* table)
+{
+  if (table->deleted_count > JES_HASH_TABLE_REHASH_THRESHOLD(*table)) {
+    jes_hash_table_rehash_in_place(table);
+  }
+}
+
+#ifdef JES_ENABLE_ADAPTIVE_WORKSPACE
+/* Number of entries from which the table grows into the node pool */
+#define JES_HASH_TABLE_GROW_THRESHOLD(table_) ((table_).capacity - (table_).capacity / 8)
+/* Capacity a table shrinks to when the node pool needs memory. Leaves room
+ * for half as many keys again, unless that does not free a whole node. */
+#define JES_HASH_TABLE_SHRINK_CAPACITY(entry_count_) ((entry_count_) + (entry_count_) / 2)
+
+static size_t jes_hash_table_required_capacity(size_t key_count);
+static size_t jes_hash_table_fit_capacity(size_t size);
+
+/* Largest capacity the table can have without overlapping the allocated nodes */
+static size_t jes_hash_table_free_capacity(struct jes_context* ctx)
+{
+  struct jes_hash_table_context* table = &ctx->hash_table;
+  uint8_t* end = (uint8_t*)(table->pool + table->capacity);
+  uint8_t* nodes_end = (uint8_t*)&ctx->node_mng.pool[ctx->node_mng.next_free];
+
+  return jes_hash_table_fit_capacity((size_t)(end - nodes_end));
+}
+
+/**
+ * @brief Changes the capacity of the table by moving its start. The end of the
+ *        table stays and the node pool ends where the table starts.
+ *
+ * A smaller table first packs the entries at its end. The slots of all entries
+ * are then marked as deleted and the entries are reinserted, no key is read.
+ * All groups of the new table belong to the current generation.
+ */
+static void jes_hash_table_reshape(struct jes_context* ctx, size_t capacity)
+{
+  struct jes_hash_table_context* table = &ctx->hash_table;
+  struct jes_hash_entry* end = table->pool + table->capacity;
+  uint8_t* control = JES_HASH_TABLE_CONTROL(table->pool, table->capacity);
+  uint8_t* new_control = JES_HASH_TABLE_CONTROL(end - capacity, capacity);
+  uint8_t* new_generations = new_control - JES_HASH_GROUP_COUNT(capacity);
+  size_t packed = table->capacity;
+  size_t slot;
+
+  assert((capacity > 0) && (capacity >= table->entry_count));
+
+  jes_hash_table_renew(table);
+  if (capacity < table->capacity) {
+    for (slot = table->capacity; slot-- > 0;) {
+      if (JES_HASH_CONTROL_IS_USED(control[slot])) {
+        packed--;
+        table->pool[packed] = table->pool[slot];
+      }
+    }
+    /* The control bytes of the smaller table lie in front of the packed entries */
+    memset(new_control, JES_HASH_CONTROL_EMPTY, capacity - table->entry_count);
+    memset(&new_control[capacity - table->entry_count], JES_HASH_CONTROL_DELETED, table->entry_count);
+  }
+  else {
+    /* The slots keep their entries and become the last slots of the larger
+       table. Control bytes move to lower addresses, the first one first. */
+    for (slot = 0; slot < table->capacity; slot++) {
+      new_control[capacity - table->capacity + slot] =
+        JES_HASH_CONTROL_IS_USED(control[slot]) ? JES_HASH_CONTROL_DELETED : JES_HASH_CONTROL_EMPTY;
+    }
+    memset(new_control, JES_HASH_CONTROL_EMPTY, capacity - table->capacity);
+  }
+  memset(new_generations, table->generation, JES_HASH_GROUP_COUNT(capacity));
+
+  table->pool = end - capacity;
+  table->capacity = capacity;
+  table->size = (size_t)((uint8_t*)end - new_generations);
+  jes_hash_table_reinsert(table);
+
+  jes_tree_resize(&ctx->node_mng, ctx->node_mng.pool, (size_t)(new_generations - (uint8_t*)ctx->node_mng.pool));
+}
+
+/* Doubles the table if the node pool has the memory free. A full table takes
+ * whatever is left. */
+static void jes_hash_table_grow(struct jes_context* ctx)
+{
+  struct jes_hash_table_context* table = &ctx->hash_table;
+  size_t limit = jes_hash_table_free_capacity(ctx);
+  size_t capacity = (table->capacity < JES_HASH_GROUP_WIDTH) ? JES_HASH_GROUP_WIDTH : table->capacity * 2;
+
+  if (capacity > limit) {
+    if (table->entry_count < table->capacity) {
+      return;
     }
+    capacity = limit;
+  }
 
-    index =  (index + 1) % table->capacity ;
-    if (start_index == index) break;
+  if (capacity > table->capacity) {
+    jes_hash_table_reshape(ctx, capacity);
   }
+}
+
+/* Number of nodes the pool holds next to a table of the given capacity */
+static size_t jes_hash_table_pool_capacity(struct jes_context* ctx, size_t capacity)
+{
+  struct jes_hash_entry* end = ctx->hash_table.pool + ctx->hash_table.capacity;
+  uint8_t* generations = JES_HASH_TABLE_CONTROL(end - capacity, capacity) - JES_HASH_GROUP_COUNT(capacity);
 
-  return key;
+  return (size_t)(generations - (uint8_t*)ctx->node_mng.pool) / sizeof(struct jes_node);
 }
 
-static jes_status jes_hash_table_add(struct jes_context* ctx, struct jes_node* parent_object, struct jes_node* key)
+jes_status jes_hash_table_shrink(struct jes_context* ctx)
 {
   struct jes_hash_table_context* table = &ctx->hash_table;
-  size_t hash = table->hash_fn(JES_NODE_INDEX(ctx->node_mng, parent_object), key->json_tlv.value, key->json_tlv.length);
-  size_t index = hash % table->capacity;
-  size_t start_index = index;
-  size_t iterations = 0;
-
-  ctx->status = JES_OUT_OF_MEMORY;
-
-  /* Linear probing to find a free slot */
-  do {
-    /* Empty slot found */
-    if ((table->pool[index].key_element == NULL) ||
-        (table->pool[index].key_element == JES_HASH_TABLE_TOMBSTONE)) {
-      /* Store the key */
-      table->pool[index].hash = hash;
-      table->pool[index].key_element = (struct jes_element*)key;
-      table->entry_count++;
-      ctx->status = JES_NO_ERROR;
-      break;
+  size_t capacity = jes_hash_table_required_capacity(JES_HASH_TABLE_SHRINK_CAPACITY(table->entry_count));
+
+  if ((capacity >= table->capacity) || (jes_hash_table_pool_capacity(ctx, capacity) <= ctx->node_mng.capacity)) {
+    /* Without room for more keys */
+    capacity = jes_hash_table_required_capacity(table->entry_count);
+    if (capacity >= table->capacity) {
+      return JES_OUT_OF_MEMORY;
     }
+  }
 
-    if ((table->pool[index].hash == hash) &&
-        (key->json_tlv.length == table->pool[index].key_element->length) &&
-        (memcmp(table->pool[index].key_element->value, key->json_tlv.value, key->json_tlv.length) == 0)) {
-      /* Duplicate key found, cannot insert. */
-      ctx->status = JES_DUPLICATE_KEY;
-      break;
+  jes_hash_table_reshape(ctx, capacity);
+  return JES_NO_ERROR;
+}
+
+jes_status jes_hash_table_reserve(struct jes_context* ctx, size_t key_count)
+{
+  size_t capacity = jes_hash_table_required_capacity(key_count);
+
+  if (capacity > ctx->hash_table.capacity) {
+    if (capacity > jes_hash_table_free_capacity(ctx)) {
+      return JES_OUT_OF_MEMORY;
+    }
+    jes_hash_table_reshape(ctx, capacity);
+  }
+
+  return JES_NO_ERROR;
+}
+#endif
+
+static jes_status jes_hash_table_add(struct jes_context* ctx, struct jes_node* parent_object, struct jes_node* key)
+{
+  struct jes_hash_table_context* table = &ctx->hash_table;
+  size_t hash = JES_HASH_KEY(table, JES_NODE_INDEX(ctx->node_mng, parent_object), JES_ELEMENT_VALUE(ctx, &key->json_tlv), key->json_tlv.length);
+  size_t slot;
+
+#ifdef JES_ENABLE_ADAPTIVE_WORKSPACE
+  if (table->entry_count >= JES_HASH_TABLE_GROW_THRESHOLD(*table)) {
+    jes_hash_table_grow(ctx);
+  }
+#endif
+
+#ifdef JES_ENABLE_WORKSPACE_GROW
+  if ((table->entry_count >= table->capacity) && (table->capacity < JES_HASH_TABLE_MAX_CAPACITY)) {
+    jes_node_descriptor key_index = JES_NODE_INDEX(ctx->node_mng, key);
+    if (jes_workspace_grow(ctx) == JES_NO_ERROR) {
+      key = &ctx->node_mng.pool[key_index];
     }
+  }
+#endif
 
-    /* Move to next slot */
-    index =  (index + 1) % table->capacity ;
-  } while (index != start_index);
+  if (jes_hash_table_find_slot(ctx, hash, JES_ELEMENT_VALUE(ctx, &key->json_tlv), key->json_tlv.length) < table->capacity) {
+    /* Duplicate key found, cannot insert. */
+    ctx->status = JES_DUPLICATE_KEY;
+    return ctx->status;
+  }
+
+  slot = jes_hash_table_find_free(table, hash);
+  if (slot == table->capacity) {
+    ctx->status = JES_OUT_OF_MEMORY;
+    return ctx->status;
+  }
 
+  jes_hash_table_store(ctx, slot, hash, key);
+  ctx->status = JES_NO_ERROR;
   return ctx->status;
 }
 
 static void jes_hash_table_remove(struct jes_context* ctx, struct jes_node* parent_object, struct jes_node* key)
 {
   struct jes_hash_table_context* table = &ctx->hash_table;
-  struct jes_hash_entry* lookup_entries = table->pool;
   size_t hash;
-  size_t index;
-  size_t start_index;
+  size_t slot;
 
   assert(parent_object != NULL);
 
-  hash = table->hash_fn(JES_NODE_INDEX(ctx->node_mng, parent_object), key->json_tlv.value, key->json_tlv.length);
-  index = hash % table->capacity;
-  start_index = index;
-
-  /* Linear probing to find the key */
-  while (lookup_entries[index].key_element != NULL) {
-    if ((lookup_entries[index].key_element != JES_HASH_TABLE_TOMBSTONE) &&
-        (lookup_entries[index].hash == hash) &&
-        (lookup_entries[index].key_element->length == key->json_tlv.length) &&
-        (memcmp(lookup_entries[index].key_element->value, key->json_tlv.value, key->json_tlv.length) == 0)) {
-      assert(table->entry_count > 0);
-      table->entry_count--;
-      lookup_entries[index].key_element = JES_HASH_TABLE_TOMBSTONE;
-      break;
+  hash = JES_HASH_KEY(table, JES_NODE_INDEX(ctx->node_mng, parent_object), JES_ELEMENT_VALUE(ctx, &key->json_tlv), key->json_tlv.length);
+  slot = jes_hash_table_find_slot(ctx, hash, JES_ELEMENT_VALUE(ctx, &key->json_tlv), key->json_tlv.length);
+  if (slot < table->capacity) {
+    jes_hash_table_erase(table, slot);
+    jes_hash_table_check_deleted(table);
+  }
+}
+
+#ifdef JES_ENABLE_HYBRID_SEARCH
+/**
+ * @brief Adds a key of an object that has reached JES_HASH_TABLE_MIN_KEYS keys.
+ *
+ * The object reaching the threshold is promoted, all its keys are added. Keys
+ * are linked to the object before they are added, so when the table is built
+ * from a complete tree (compaction, rehash) the keys of an object with exactly
+ * JES_HASH_TABLE_MIN_KEYS keys are already in the table after the first one.
+ */
+static jes_status jes_hash_table_add_hybrid(struct jes_context* ctx, struct jes_node* parent_object, struct jes_node* key)
+{
+  struct jes_hash_table_context* table = &ctx->hash_table;
+  jes_node_descriptor object_index = JES_NODE_INDEX(ctx->node_mng, parent_object);
+  jes_node_descriptor iter_index;
+  struct jes_node* iter;
+  size_t hash;
+  size_t slot;
+  size_t count = jes_hash_table_count_keys(ctx, parent_object, JES_HASH_TABLE_MIN_KEYS + 1);
+
+  ctx->status = JES_NO_ERROR;
+  if (count < JES_HASH_TABLE_MIN_KEYS) {
+    /* Searched linearly */
+    return ctx->status;
+  }
+  if (count > JES_HASH_TABLE_MIN_KEYS) {
+    return jes_hash_table_add(ctx, parent_object, key);
+  }
+
+  for (iter_index = parent_object->first_child; iter_index != JES_INVALID_INDEX; iter_index = iter->sibling) {
+    iter = &ctx->node_mng.pool[iter_index];
+    hash = JES_HASH_KEY(table, object_index, JES_ELEMENT_VALUE(ctx, &iter->json_tlv), iter->json_tlv.length);
+    slot = jes_hash_table_find_slot(ctx, hash, JES_ELEMENT_VALUE(ctx, &iter->json_tlv), iter->json_tlv.length);
+    if ((slot == table->capacity) || (JES_HASH_ENTRY_KEY(ctx->node_mng, table->pool[slot]) != iter)) {
+      if (jes_hash_table_add(ctx, &ctx->node_mng.pool[object_index], iter) == JES_OUT_OF_MEMORY) {
+        return ctx->status;
+      }
+      /* A full hash table may have moved the pool */
+      iter = &ctx->node_mng.pool[iter_index];
     }
+  }
 
-    index =  (index + 1) % table->capacity;
-    if (start_index == index) {
-      break;
+  return ctx->status;
+}
+
+/**
+ * @brief Removes a key that is already unlinked from its object. An object
+ * that drops below JES_HASH_TABLE_MIN_KEYS keys removes all its keys.
+ */
+static void jes_hash_table_remove_hybrid(struct jes_context* ctx, struct jes_node* parent_object, struct jes_node* key)
+{
+  struct jes_node* iter;
+  size_t count = jes_hash_table_count_keys(ctx, parent_object, JES_HASH_TABLE_MIN_KEYS);
+
+  if (count + 1 < JES_HASH_TABLE_MIN_KEYS) {
+    /* Was not indexed */
+    return;
+  }
+
+  jes_hash_table_remove(ctx, parent_object, key);
+  if (count < JES_HASH_TABLE_MIN_KEYS) {
+    for (iter = GET_FIRST_CHILD(ctx->node_mng, parent_object); iter != NULL; iter = GET_SIBLING(ctx->node_mng, iter)) {
+      jes_hash_table_remove(ctx, parent_object, iter);
     }
   }
 }
+#endif
 
-jes_status jes_hash_table_resize(struct jes_hash_table_context* ctx, void *buffer, size_t buffer_size)
+void jes_hash_table_remove_released_keys(struct jes_context* ctx)
 {
-  ctx->size = buffer_size;
-  ctx->capacity = (buffer_size / sizeof(ctx->pool[0])) < JES_INVALID_INDEX
-                ? buffer_size / sizeof(ctx->pool[0])
-                : JES_INVALID_INDEX - 1;
-  ctx->pool = (struct jes_hash_entry*)buffer;
-  ctx->entry_count = 0;
-  /* Clear the pool. Any old entry in the pool is not valid after resize. */
-  memset(buffer, 0, buffer_size);
+  struct jes_hash_table_context* table = &ctx->hash_table;
+  uint8_t* control = JES_HASH_TABLE_CONTROL(table->pool, table->capacity);
+  size_t slot;
 
-  return ctx->capacity == 0 ? JES_BUFFER_TOO_SMALL : JES_NO_ERROR;
+  jes_hash_table_renew(table);
+  for (slot = 0; slot < table->capacity; slot++) {
+    /* Released nodes keep the JES_UNKNOWN type until they are allocated again. */
+    if (JES_HASH_CONTROL_IS_USED(control[slot]) &&
+        (NODE_TYPE(JES_HASH_ENTRY_KEY(ctx->node_mng, table->pool[slot])) == JES_UNKNOWN)) {
+      jes_hash_table_erase(table, slot);
+    }
+  }
+
+  jes_hash_table_check_deleted(table);
 }
 
-jes_status jes_hash_table_init(struct jes_context* ctx, void *buffer, size_t buffer_size)
+/* Inserts an entry with a known hash. The key must not be in the table. */
+static void jes_hash_table_insert_entry(struct jes_context* ctx, size_t hash, struct jes_node* key)
 {
-  struct jes_hash_table_context* hash_table_ctx = &ctx->hash_table;
+  size_t slot = jes_hash_table_find_free(&ctx->hash_table, hash);
 
-  hash_table_ctx->hash_fn = jes_fnv1a_compound_hash;
-  hash_table_ctx->add_fn = jes_hash_table_add;
-  hash_table_ctx->remove_fn = jes_hash_table_remove;
+  assert(slot < ctx->hash_table.capacity);
+  if (slot < ctx->hash_table.capacity) {
+    jes_hash_table_store(ctx, slot, hash, key);
+  }
+}
 
-  return jes_hash_table_resize(&ctx->hash_table, buffer, buffer_size);
+void jes_hash_table_move_entries(struct jes_context* ctx,
+                                 const struct jes_hash_entry* entries,
+                                 size_t capacity,
+                                 uintptr_t pool)
+{
+  const uint8_t* control = JES_HASH_TABLE_CONTROL(entries, capacity);
+  size_t slot;
+
+  for (slot = 0; slot < capacity; slot++) {
+    if (!JES_HASH_CONTROL_IS_USED(control[slot])) {
+      continue;
+    }
+    /* The table is larger than the old one. */
+#ifdef JES_USE_COMPACT_HASH_ENTRY
+    jes_hash_table_insert_entry(ctx, entries[slot].hash, &ctx->node_mng.pool[entries[slot].key]);
+#else
+    jes_hash_table_insert_entry(ctx, entries[slot].hash,
+                                (struct jes_node*)((uintptr_t)ctx->node_mng.pool +
+                                ((uintptr_t)entries[slot].key - pool)));
+#endif
+  }
+}
+
+size_t jes_hash_table_save_entries(struct jes_context* ctx, struct jes_hash_entry* entries)
+{
+  struct jes_hash_table_context* table = &ctx->hash_table;
+  const uint8_t* control = JES_HASH_TABLE_CONTROL(table->pool, table->capacity);
+  const uint8_t* generations = JES_HASH_TABLE_GENERATIONS(table->pool, table->capacity);
+  size_t width = jes_hash_group_width(table);
+  size_t count = 0;
+  size_t slot;
+
+  for (slot = 0; slot < table->capacity; slot++) {
+    /* Entries of released keys are dropped on the way. */
+    if ((generations[slot / width] != table->generation) ||
+        !JES_HASH_CONTROL_IS_USED(control[slot]) ||
+        (NODE_TYPE(JES_HASH_ENTRY_KEY(ctx->node_mng, table->pool[slot])) == JES_UNKNOWN)) {
+      continue;
+    }
+    if (entries != NULL) {
+      entries[count].hash = table->pool[slot].hash;
+#ifdef JES_USE_COMPACT_HASH_ENTRY
+      entries[count].key = table->pool[slot].key;
+#else
+      entries[count].key = (struct jes_node*)((uintptr_t)table->pool[slot].key -
+                                              (uintptr_t)ctx->node_mng.pool);
+#endif
+    }
+    count++;
+  }
+
+  return count;
+}
+
+void jes_hash_table_load_entries(struct jes_context* ctx,
+                                 const struct jes_hash_entry* entries,
+                                 size_t count)
+{
+  size_t index;
+
+  for (index = 0; index < count; index++) {
+#ifdef JES_USE_COMPACT_HASH_ENTRY
+    jes_hash_table_insert_entry(ctx, entries[index].hash, &ctx->node_mng.pool[entries[index].key]);
+#else
+    jes_hash_table_insert_entry(ctx, entries[index].hash,
+                                (struct jes_node*)((uintptr_t)ctx->node_mng.pool +
+                                (uintptr_t)entries[index].key));
+#endif
+  }
+}
+
+/* Slots of a table. Tables of a group or more hold whole groups. */
+static size_t jes_hash_table_round_capacity(size_t capacity)
+{
+  if (capacity > JES_HASH_TABLE_MAX_CAPACITY) {
+    capacity = JES_HASH_TABLE_MAX_CAPACITY;
+  }
+  return (capacity < JES_HASH_GROUP_WIDTH) ? capacity : capacity & ~(size_t)(JES_HASH_GROUP_WIDTH - 1);
+}
+
+/* Smallest capacity that holds key_count keys */
+static size_t jes_hash_table_required_capacity(size_t key_count)
+{
+  size_t capacity = (key_count > 0) ? key_count : 1;
+
+  if (capacity > JES_HASH_GROUP_WIDTH) {
+    capacity = (capacity + JES_HASH_GROUP_WIDTH - 1) & ~(size_t)(JES_HASH_GROUP_WIDTH - 1);
+  }
+  return capacity;
+}
+
+size_t jes_hash_table_required_size(size_t key_count)
+{
+  size_t capacity = jes_hash_table_required_capacity(key_count);
+
+  return capacity * JES_HASH_SLOT_SIZE + JES_HASH_GROUP_COUNT(capacity);
+}
+
+/* Largest capacity of a table in size bytes */
+static size_t jes_hash_table_fit_capacity(size_t size)
+{
+  size_t capacity = jes_hash_table_round_capacity(size * JES_HASH_GROUP_WIDTH /
+                                                  (JES_HASH_GROUP_WIDTH * JES_HASH_SLOT_SIZE + 1));
+
+  if (capacity < JES_HASH_GROUP_WIDTH) {
+    /* A single group */
+    capacity = (size > 0) ? (size - 1) / JES_HASH_SLOT_SIZE : 0;
+  }
+  return capacity;
+}
+
+void jes_hash_table_clear(struct jes_hash_table_context* table)
+{
+  table->entry_count = 0;
+  table->deleted_count = 0;
+  /* All groups become stale. Their generation bytes are only reset when the
+     generation counter wraps around. */
+  table->generation++;
+  if (table->generation == 0) {
+    memset(JES_HASH_TABLE_GENERATIONS(table->pool, table->capacity), 0, JES_HASH_GROUP_COUNT(table->capacity));
+    table->generation = 1;
+  }
+}
+
+jes_status jes_hash_table_resize(struct jes_hash_table_context* ctx, void *buffer, size_t buffer_size)
+{
+  /* Entries end at the aligned end of the buffer */
+  uint8_t* end = (uint8_t*)(((uintptr_t)buffer + buffer_size) & ~(uintptr_t)(JES_ALIGNMENT - 1));
+  size_t size = (end > (uint8_t*)buffer) ? (size_t)(end - (uint8_t*)buffer) : 0;
+  size_t capacity = jes_hash_table_fit_capacity(size);
+
+  if ((ctx->pool != (struct jes_hash_entry*)end - capacity) || (ctx->capacity != capacity)) {
+    ctx->capacity = capacity;
+    ctx->pool = (struct jes_hash_entry*)end - capacity;
+    /* Any old entry in the buffer is not valid. Groups of generation 0 are stale. */
+    memset(JES_HASH_TABLE_GENERATIONS(ctx->pool, capacity), 0, JES_HASH_GROUP_COUNT(capacity));
+    ctx->generation = 0;
+  }
+  /* Otherwise the table is resized to its own buffer, e.g. by jes_reset(), and
+     clearing it takes constant time. */
+  ctx->size = size;
+  jes_hash_table_clear(ctx);
+
+  return ctx->capacity == 0 ? JES_BUFFER_TOO_SMALL : JES_NO_ERROR;
 }
 
 static jes_status jes_hash_table_add_noop(struct jes_context* ctx, struct jes_node* parent_object, struct jes_node* key)
@@ -211,10 +1112,104 @@ static void jes_hash_table_remove_noop(struct jes_context* ctx, struct jes_node*
   /* Hash table remove function is bypassed due to fallback to linear search. */
 }
 
+static void jes_hash_table_turn_on(struct jes_context* ctx)
+{
+#ifdef JES_ENABLE_HYBRID_SEARCH
+  ctx->hash_table.add_fn = jes_hash_table_add_hybrid;
+  ctx->hash_table.remove_fn = jes_hash_table_remove_hybrid;
+#else
+  ctx->hash_table.add_fn = jes_hash_table_add;
+  ctx->hash_table.remove_fn = jes_hash_table_remove;
+#endif
+}
+
 void jes_hash_table_turn_off(struct jes_context* ctx)
 {
   ctx->hash_table.add_fn = jes_hash_table_add_noop;
   ctx->hash_table.remove_fn = jes_hash_table_remove_noop;
 }
 
+jes_status jes_hash_table_init(struct jes_context* ctx, void *buffer, size_t buffer_size)
+{
+  struct jes_hash_table_context* hash_table_ctx = &ctx->hash_table;
+
+#if JES_HASH_FUNCTION_ID == JES_HASH_CRC32C
+  hash_table_ctx->hash_fn = jes_crc32c_key_hash;
+#elif JES_HASH_FUNCTION_ID == JES_HASH_WORD
+  hash_table_ctx->hash_fn = jes_word_key_hash;
+#else
+  hash_table_ctx->hash_fn = jes_fnv1a_key_hash;
+#endif
+  jes_hash_table_turn_on(ctx);
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+  ctx->hash_index_deferred = false;
+#endif
+
+  return jes_hash_table_resize(&ctx->hash_table, buffer, buffer_size);
+}
 
+jes_status jes_hash_table_rehash(struct jes_context* ctx)
+{
+  struct jes_node* node;
+  jes_node_descriptor descriptor;
+
+  jes_hash_table_clear(&ctx->hash_table);
+
+  /* Pre-order walk, keys are hashed with the index of their parent. Of
+     duplicate keys, which only a deferred index can meet, the first is kept. */
+  for (node = ctx->node_mng.root; node != NULL;
+       node = HAS_CHILD(node) ? GET_FIRST_CHILD(ctx->node_mng, node)
+                              : jes_tree_get_subtree_end_node(ctx, node)) {
+    if (NODE_TYPE(node) == JES_KEY) {
+      descriptor = JES_NODE_INDEX(ctx->node_mng, node);
+      if (ctx->hash_table.add_fn(ctx, GET_PARENT(ctx->node_mng, node), node) == JES_OUT_OF_MEMORY) {
+        return ctx->status;
+      }
+      /* A full hash table may have moved the pool */
+      node = &ctx->node_mng.pool[descriptor];
+    }
+  }
+
+  ctx->status = JES_NO_ERROR;
+  return ctx->status;
+}
+
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+void jes_hash_table_defer(struct jes_context* ctx)
+{
+  jes_hash_table_clear(&ctx->hash_table);
+  jes_hash_table_turn_off(ctx);
+  ctx->hash_index_deferred = true;
+}
+
+jes_status jes_hash_table_build(struct jes_context* ctx, bool grow_workspace)
+{
+#ifdef JES_ENABLE_WORKSPACE_GROW
+  jes_workspace_grow_fn grow_fn = ctx->grow_fn;
+#endif
+
+  if (!ctx->hash_index_deferred) {
+    return JES_NO_ERROR;
+  }
+
+  ctx->hash_index_deferred = false;
+  jes_hash_table_turn_on(ctx);
+#ifdef JES_ENABLE_WORKSPACE_GROW
+  if (!grow_workspace) {
+    ctx->grow_fn = NULL;
+  }
+#endif
+  jes_hash_table_rehash(ctx);
+#ifdef JES_ENABLE_WORKSPACE_GROW
+  ctx->grow_fn = grow_fn;
+#endif
+  if (ctx->status != JES_NO_ERROR) {
+    /* Retried by the next lookup */
+    jes_status status = ctx->status;
+    jes_hash_table_defer(ctx);
+    ctx->status = status;
+  }
+
+  return ctx->status;
+}
+#endif
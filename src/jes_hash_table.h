@@ -1,20 +1,174 @@
 #ifndef JES_HASH_TABLE_H
 #define JES_HASH_TABLE_H
 
+/* Hash functions, selected at compile time (see JES_USE_WORD_HASH and
+ * JES_USE_CRC32C_HASH). CRC32C falls back to the word hash when the compiler
+ * does not target the CRC instructions. */
+#define JES_HASH_FNV1A   0
+#define JES_HASH_WORD    1
+#define JES_HASH_CRC32C  2
+
+#if defined(JES_USE_CRC32C_HASH) && (defined(__SSE4_2__) || defined(__ARM_FEATURE_CRC32))
+  #define JES_HASH_FUNCTION_ID JES_HASH_CRC32C
+#elif defined(JES_USE_WORD_HASH) || defined(JES_USE_CRC32C_HASH)
+  #define JES_HASH_FUNCTION_ID JES_HASH_WORD
+#else
+  #define JES_HASH_FUNCTION_ID JES_HASH_FNV1A
+#endif
+
+#ifdef JES_USE_COMPACT_HASH_ENTRY
+/* 8 bytes per entry. The key node is resolved through the node pool, so
+ * entries stay valid when the pool moves. */
+struct jes_hash_entry {
+  uint32_t hash;
+  /* Node descriptor of the key, 16 or 32 bits */
+  uint32_t key;
+};
+
+#define JES_HASH_ENTRY_KEY(node_mng_, entry_) (&(node_mng_).pool[(entry_).key])
+#define JES_HASH_ENTRY_REF(node_mng_, key_) JES_NODE_INDEX((node_mng_), (key_))
+#else
 struct jes_hash_entry {
   size_t hash;
-  struct jes_element* key_element;
+  struct jes_node* key;
 };
 
+#define JES_HASH_ENTRY_KEY(node_mng_, entry_) ((entry_).key)
+#define JES_HASH_ENTRY_REF(node_mng_, key_) (key_)
+#endif
+
+/* Key count from which the keys of an object are in the table. Smaller
+ * objects are searched linearly (see JES_ENABLE_HYBRID_SEARCH). */
+#ifdef JES_ENABLE_HYBRID_SEARCH
+  #if JES_HYBRID_SEARCH_MIN_KEYS < 1
+    #error "JES_HYBRID_SEARCH_MIN_KEYS must be at least 1"
+  #endif
+  #define JES_HASH_TABLE_MIN_KEYS JES_HYBRID_SEARCH_MIN_KEYS
+#else
+  #define JES_HASH_TABLE_MIN_KEYS 1
+#endif
+
 struct jes_hash_table_context; /* Forward declaration */
 
 jes_status jes_hash_table_init(struct jes_context* ctx, void *buffer, size_t buffer_size);
 jes_status jes_hash_table_resize(struct jes_hash_table_context* ctx, void *buffer, size_t buffer_size);
 
+/**
+ * @brief Removes all entries in constant time. The table keeps its buffer and
+ *        capacity.
+ */
+void jes_hash_table_clear(struct jes_hash_table_context* table);
+
+/**
+ * @brief Empties the groups that are stale since the table has been cleared,
+ *        so the control bytes can be read without their generation.
+ */
+void jes_hash_table_renew(struct jes_hash_table_context* table);
+
 void jes_hash_table_turn_off(struct jes_context* ctx);
 
+/**
+ * @brief Clears the table and hashes the keys of the tree again, e.g. after
+ *        the seed has changed.
+ */
+jes_status jes_hash_table_rehash(struct jes_context* ctx);
+
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+/**
+ * @brief Empties the table and leaves the keys of the tree unhashed until
+ *        jes_hash_table_build() is called, by the first lookup at the latest.
+ */
+void jes_hash_table_defer(struct jes_context* ctx);
+
+/**
+ * @brief Hashes the keys of a tree whose index has been deferred, in a
+ *        single pass. The index stays deferred if the table is too small.
+ *
+ * Only operations that add elements may grow the workspace for the table,
+ * others hold node pointers that must stay valid.
+ */
+jes_status jes_hash_table_build(struct jes_context* ctx, bool grow_workspace);
+#endif
+
+#ifdef JES_ENABLE_ADAPTIVE_WORKSPACE
+/* Keys the table of a partitioned workspace starts with, a single group. */
+#define JES_HASH_TABLE_INITIAL_KEYS 16
+
+/**
+ * @brief Gives unused slots to the node pool when it is full. The table keeps
+ *        room for more keys if that frees a node, else only for its entries.
+ */
+jes_status jes_hash_table_shrink(struct jes_context* ctx);
+
+/**
+ * @brief Grows the table into the free end of the node pool until it can hold
+ *        key_count keys.
+ */
+jes_status jes_hash_table_reserve(struct jes_context* ctx, size_t key_count);
+#endif
+
+/**
+ * @brief Returns the buffer size of a table that holds key_count keys.
+ *
+ * Each slot has an entry and a control byte. Tables of more than one group
+ * hold whole groups of slots.
+ */
+size_t jes_hash_table_required_size(size_t key_count);
+
+/* Number of keys that a subtree deletion removes one by one. Beyond that, a
+   single sweep of the table (jes_hash_table_remove_released_keys) is cheaper. */
+#define JES_HASH_TABLE_SWEEP_THRESHOLD(table_) ((table_).capacity / 8)
+
+/**
+ * @brief Removes the entries of all released key nodes in one pass over the table.
+ */
+void jes_hash_table_remove_released_keys(struct jes_context* ctx);
+
+/**
+ * @brief Inserts the entries of a previous table into the current (empty) table.
+ *
+ * Used when the workspace grows. The node pool moved from the address pool,
+ * so key node pointers are rebased to the current pool.
+ */
+void jes_hash_table_move_entries(struct jes_context* ctx,
+                                 const struct jes_hash_entry* entries,
+                                 size_t capacity,
+                                 uintptr_t pool);
+
+/**
+ * @brief Copies the entries of all live keys to a flat array for a workspace image.
+ *
+ * Key node pointers are stored as byte offsets into the node pool. With a
+ * NULL array the entries are only counted. Returns the number of entries.
+ */
+size_t jes_hash_table_save_entries(struct jes_context* ctx, struct jes_hash_entry* entries);
+
+/**
+ * @brief Inserts entries saved by jes_hash_table_save_entries() into the
+ *        current (empty) table without hashing the keys again.
+ */
+void jes_hash_table_load_entries(struct jes_context* ctx,
+                                 const struct jes_hash_entry* entries,
+                                 size_t count);
+
 struct jes_node* jes_hash_table_find_key(struct jes_context* ctx,
                                          struct jes_node* parent_object,
                                          const char* keyword,
                                          size_t keyword_length);
+
+/**
+ * @brief Same as jes_hash_table_find_key() with the keyword hash of
+ *        jes_hash_table_hash_keyword(), for keys that are looked up repeatedly.
+ */
+struct jes_node* jes_hash_table_find_hashed_key(struct jes_context* ctx,
+                                                struct jes_node* parent_object,
+                                                const char* keyword,
+                                                size_t keyword_length,
+                                                uint32_t key_hash);
+
+/**
+ * @brief Hashes a keyword with the hash function of the build. The hash does
+ *        not depend on the object of the key.
+ */
+uint32_t jes_hash_table_hash_keyword(uint32_t seed, const char* keyword, size_t keyword_length);
 #endif
\ No newline at end of file
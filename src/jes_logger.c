@@ -247,6 +247,7 @@ void jes_print_workspace_stat(struct jes_workspace_stat ws_stat)
   printf("\n  - Capacity: %zu", ws_stat.node_mng_capacity);
   printf("\n  - Used: %zu, (%.1f%%)", ws_stat.node_mng_node_count,
       (double)ws_stat.node_mng_node_count / ws_stat.node_mng_capacity * 100.0);
+  printf("\n  - Node size: %zu bytes (links: %zu bytes)", ws_stat.node_size, ws_stat.node_link_size);
 
   printf("\n- Hash Table:");
   printf("\n  - Size: %zu bytes",  ws_stat.hash_table_size);
@@ -294,9 +295,11 @@ void jes_print_context(struct jes_context* ctx)
     printf("\n- Hash Table:");
     if (ctx->hash_table.pool) {  printf("\n  - pool: 0x%X", ctx->hash_table.pool);}
     else{  printf("\n  - pool:%s", "NULL");}
-    printf("\n  - size: %u", ctx->hash_table.size);
-    printf("\n  - capacity: %u", ctx->hash_table.capacity);
-    printf("\n  - entry_count: %u", ctx->hash_table.entry_count);
+    printf("\n  - size: %zu", ctx->hash_table.size);
+    printf("\n  - capacity: %zu", ctx->hash_table.capacity);
+    printf("\n  - entry_count: %zu", ctx->hash_table.entry_count);
+    printf("\n  - deleted_count: %zu", ctx->hash_table.deleted_count);
+    printf("\n  - seed: 0x%X", ctx->hash_table.seed);
     printf("\n  - hash_fn: 0x%X", ctx->hash_table.hash_fn);
     printf("\n  - add_fn: 0x%X", ctx->hash_table.add_fn);
     printf("\n  - remove_fn: 0x%X", ctx->hash_table.remove_fn);
@@ -34,7 +34,7 @@ static inline void jes_parser_process_opening_brace(struct jes_context* ctx)
 static inline void jes_parser_process_closing_brace(struct jes_context* ctx)
 {
   /* Handle special case: empty object "{}" */
-  if ((NODE_TYPE(ctx->serdes.iter) == JES_OBJECT) && (ctx->serdes.state == JES_EXPECT_KEY)) {
+  if ((NODE_VALUE_TYPE(ctx->serdes.iter) == JES_OBJECT) && (ctx->serdes.state == JES_EXPECT_KEY)) {
     /* An object in EXPECT_KEY state, can only be an empty object with no children */
     if (HAS_CHILD(ctx->serdes.iter)) {
       ctx->status = JES_UNEXPECTED_TOKEN;
@@ -42,13 +42,13 @@ static inline void jes_parser_process_closing_brace(struct jes_context* ctx)
     }
   }
 
-  if ((NODE_TYPE(ctx->serdes.iter) == JES_KEY) || (NODE_TYPE(ctx->serdes.iter) == JES_ARRAY)) {
+  if ((NODE_VALUE_TYPE(ctx->serdes.iter) == JES_KEY) || (NODE_VALUE_TYPE(ctx->serdes.iter) == JES_ARRAY)) {
     ctx->status = JES_UNEXPECTED_TOKEN;
     return;
   }
 
   /* If current node is not an OBJECT type, navigate up to find the parent OBJECT */
-  if (NODE_TYPE(ctx->serdes.iter) != JES_OBJECT) {
+  if (NODE_VALUE_TYPE(ctx->serdes.iter) != JES_OBJECT) {
     ctx->serdes.iter = jes_tree_get_parent_node_by_type(ctx, ctx->serdes.iter, JES_OBJECT);
     assert(ctx->serdes.iter != NULL);
   }
@@ -66,7 +66,7 @@ static inline void jes_parser_process_closing_brace(struct jes_context* ctx)
     return;
   }
 
-  assert(NODE_TYPE(ctx->serdes.iter) == JES_ARRAY || NODE_TYPE(ctx->serdes.iter) == JES_OBJECT);
+  assert(NODE_VALUE_TYPE(ctx->serdes.iter) == JES_ARRAY || NODE_VALUE_TYPE(ctx->serdes.iter) == JES_OBJECT);
   ctx->serdes.state = JES_HAVE_VALUE;
 }
 
@@ -87,7 +87,7 @@ static inline void jes_parser_process_opening_bracket(struct jes_context* ctx)
 static inline void jes_parser_process_closing_bracket(struct jes_context* ctx)
 {
   /* Handle special case: empty array "[]" */
-  if ((NODE_TYPE(ctx->serdes.iter) == JES_ARRAY) && (ctx->serdes.state == JES_EXPECT_VALUE)) {
+  if ((NODE_VALUE_TYPE(ctx->serdes.iter) == JES_ARRAY) && (ctx->serdes.state == JES_EXPECT_VALUE)) {
     /* An array in expecting state, can only be an empty and must have no values */
     if (HAS_CHILD(ctx->serdes.iter)) {
       ctx->status = JES_UNEXPECTED_TOKEN;
@@ -96,7 +96,7 @@ static inline void jes_parser_process_closing_bracket(struct jes_context* ctx)
   }
 
   /* If current node is not an ARRAY type, navigate up to find the parent ARRAY */
-  if (NODE_TYPE(ctx->serdes.iter) != JES_ARRAY) {
+  if (NODE_VALUE_TYPE(ctx->serdes.iter) != JES_ARRAY) {
     ctx->serdes.iter = jes_tree_get_parent_node_by_type(ctx, ctx->serdes.iter, JES_ARRAY);
   }
 
@@ -112,7 +112,7 @@ static inline void jes_parser_process_closing_bracket(struct jes_context* ctx)
     return;
   }
 
-  assert(NODE_TYPE(ctx->serdes.iter) == JES_ARRAY || NODE_TYPE(ctx->serdes.iter) == JES_OBJECT);
+  assert(NODE_VALUE_TYPE(ctx->serdes.iter) == JES_ARRAY || NODE_VALUE_TYPE(ctx->serdes.iter) == JES_OBJECT);
   ctx->serdes.state = JES_HAVE_VALUE;
 }
 
@@ -122,7 +122,7 @@ static inline void jes_parser_process_comma(struct jes_context* ctx)
    * - For container nodes (objects/arrays), validate they have children
    * - For value nodes, move back up to the parent container
    */
-  if ((NODE_TYPE(ctx->serdes.iter) == JES_OBJECT) || (NODE_TYPE(ctx->serdes.iter) == JES_ARRAY)) {
+  if ((NODE_VALUE_TYPE(ctx->serdes.iter) == JES_OBJECT) || (NODE_VALUE_TYPE(ctx->serdes.iter) == JES_ARRAY)) {
     if (!HAS_CHILD(ctx->serdes.iter)) {
       ctx->status = JES_UNEXPECTED_TOKEN;
     }
@@ -175,14 +175,28 @@ static inline void jes_parser_process_start_state(struct jes_context* ctx)
   }
 }
 
+/* Appends a key to the current object. Keys of a tree with a deferred hash
+ * index are hashed when the index is built, duplicates are not rejected. */
+static inline struct jes_node* jes_parser_append_key(struct jes_context* ctx)
+{
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+  if (ctx->hash_index_deferred) {
+    return jes_tree_insert_node(ctx, ctx->serdes.iter,
+                                GET_LAST_CHILD(ctx->node_mng, ctx->serdes.iter), JES_KEY,
+                                ctx->serdes.tokenizer.token.length, ctx->serdes.tokenizer.token.value);
+  }
+#endif
+  return jes_tree_insert_key_node(ctx, ctx->serdes.iter,
+                                  GET_LAST_CHILD(ctx->node_mng, ctx->serdes.iter),
+                                  ctx->serdes.tokenizer.token.length, ctx->serdes.tokenizer.token.value);
+}
+
 static inline void jes_parser_process_expect_key_state(struct jes_context* ctx)
 {
   switch (ctx->serdes.tokenizer.token.type) {
     case JES_TOKEN_STRING:
       /* Append the key */
-      ctx->serdes.iter = jes_tree_insert_key_node(ctx, ctx->serdes.iter,
-                          GET_LAST_CHILD(ctx->node_mng, ctx->serdes.iter),
-                          ctx->serdes.tokenizer.token.length, ctx->serdes.tokenizer.token.value);
+      ctx->serdes.iter = jes_parser_append_key(ctx);
       if (ctx->serdes.iter == NULL) { /* Something went wrong. exit the process */
         break;
       }
@@ -257,6 +271,16 @@ static inline void jes_parser_process_expect_value_state(struct jes_context* ctx
     return;
   }
 
+  if (NODE_VALUE_TYPE(ctx->serdes.iter) == JES_KEY) {
+    /* Assign the value of a key that has no value yet */
+    ctx->serdes.iter = jes_tree_insert_key_value(ctx,
+                                                 ctx->serdes.iter,
+                                                 element_type,
+                                                 ctx->serdes.tokenizer.token.length,
+                                                 ctx->serdes.tokenizer.token.value);
+    return;
+  }
+
   ctx->serdes.iter = jes_tree_insert_node(ctx,
                                           ctx->serdes.iter,
                                           GET_LAST_CHILD(ctx->node_mng, ctx->serdes.iter),
@@ -278,7 +302,7 @@ static inline void jes_parser_process_have_value_state(struct jes_context* ctx)
     case JES_TOKEN_COMMA:
       jes_parser_process_comma(ctx);
       assert(ctx->serdes.iter);
-      switch (NODE_TYPE(ctx->serdes.iter)) {
+      switch (NODE_VALUE_TYPE(ctx->serdes.iter)) {
         case JES_ARRAY:
           ctx->serdes.state = JES_EXPECT_VALUE;
           break;
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "jes_hash_table.h"
 
@@ -21,6 +22,9 @@
 #define JES_IS_ALIGNED(ptr) \
     (((uintptr_t)(ptr) & (JES_ALIGNMENT - 1)) == 0)
 
+#define JES_ALIGN_SIZE(size) \
+    (((size_t)(size) + (JES_ALIGNMENT - 1)) & ~(size_t)(JES_ALIGNMENT - 1))
+
 #ifdef JES_USE_32BIT_NODE_DESCRIPTOR
   #define JES_INVALID_INDEX 0xFFFFFFFF
 #else
@@ -35,12 +39,75 @@
 #define GET_SIBLING(node_mng_, node_ptr) (HAS_SIBLING(node_ptr) ? &node_mng_.pool[(node_ptr)->sibling] : NULL)
 #define GET_FIRST_CHILD(node_mng_, node_ptr) (HAS_CHILD(node_ptr) ? &node_mng_.pool[(node_ptr)->first_child] : NULL)
 #define GET_LAST_CHILD(node_mng_, node_ptr) (HAS_CHILD(node_ptr) ? &node_mng_.pool[(node_ptr)->last_child] : NULL)
+/* Resolves a node descriptor. Unlike node pointers, descriptors stay valid when the pool moves. */
+#define GET_NODE(node_mng_, descriptor_) (((descriptor_) < JES_INVALID_INDEX) ? &node_mng_.pool[(descriptor_)] : NULL)
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+#define HAS_PREV_SIBLING(node_ptr) (((node_ptr) != NULL) ? (node_ptr)->prev_sibling < JES_INVALID_INDEX : false)
+#define GET_PREV_SIBLING(node_mng_, node_ptr) (HAS_PREV_SIBLING(node_ptr) ? &node_mng_.pool[(node_ptr)->prev_sibling] : NULL)
+#endif
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+#define GET_SUBTREE_END(node_mng_, node_ptr) (((node_ptr)->subtree_end < JES_INVALID_INDEX) ? &node_mng_.pool[(node_ptr)->subtree_end] : NULL)
+#endif
+
+#define NODE_TYPE(node_ptr) (((node_ptr) != NULL) ? (node_ptr)->json_tlv.type : JES_UNKNOWN)
+#define PARENT_TYPE(node_mng_, node_ptr) (HAS_PARENT(node_ptr) ? NODE_VALUE_TYPE(&node_mng_.pool[(node_ptr)->parent]) : JES_UNKNOWN)
+
+#ifdef JES_USE_MERGED_KEY_NODE
+/* An object member is a single JES_KEY node that also embeds the value element.
+   The member node is the "value node" of its key and a container value links
+   its children to the member node directly. A key without a value reports JES_KEY. */
+#define NODE_VALUE_TYPE(node_ptr) \
+  (((NODE_TYPE(node_ptr) == JES_KEY) && ((node_ptr)->value_tlv.type != JES_UNKNOWN)) \
+    ? (node_ptr)->value_tlv.type : NODE_TYPE(node_ptr))
+#define NODE_VALUE_ELEMENT(node_ptr) ((NODE_TYPE(node_ptr) == JES_KEY) ? &(node_ptr)->value_tlv : &(node_ptr)->json_tlv)
+#define GET_KEY_VALUE_NODE(node_mng_, key_ptr) (((key_ptr)->value_tlv.type != JES_UNKNOWN) ? (key_ptr) : NULL)
+#define IS_VALUE_ELEMENT(node_ptr, element_ptr) ((struct jes_element*)(element_ptr) == &(node_ptr)->value_tlv)
+#else
+#define NODE_VALUE_TYPE(node_ptr) NODE_TYPE(node_ptr)
+#define NODE_VALUE_ELEMENT(node_ptr) (&(node_ptr)->json_tlv)
+#define GET_KEY_VALUE_NODE(node_mng_, key_ptr) GET_FIRST_CHILD(node_mng_, key_ptr)
+#define IS_VALUE_ELEMENT(node_ptr, element_ptr) false
+#endif
 
-#define NODE_TYPE(node_ptr) ((node_ptr != NULL) ? node_ptr->json_tlv.type : JES_UNKNOWN)
-#define PARENT_TYPE(node_mng_, node_ptr) (HAS_PARENT(node_ptr) ? node_mng_.pool[(node_ptr)->parent].json_tlv.type : JES_UNKNOWN)
+/* The value of an array element carries no information ("["), so its length
+   marks a contiguous array instead: while it is not zero, the array values are
+   allocated back to back and the value at index i is the node at first_child + i.
+   Arrays stay contiguous as long as values are only appended or removed at
+   either end. Once cleared, the length stays zero until jes_compact() lays the
+   values out back to back again and restores the length of the "[" token. */
+#define IS_CONTIGUOUS_ARRAY(node_ptr) \
+  ((NODE_VALUE_TYPE(node_ptr) == JES_ARRAY) && (NODE_VALUE_ELEMENT(node_ptr)->length != 0))
+#define SET_CONTIGUOUS_ARRAY(node_ptr) (NODE_VALUE_ELEMENT(node_ptr)->length = 1)
+#define CLEAR_CONTIGUOUS_ARRAY(node_ptr) (NODE_VALUE_ELEMENT(node_ptr)->length = 0)
 
 #define JES_NODE_INDEX(node_mng_, node_ptr) ((node_ptr != NULL) ? (jes_node_descriptor)((node_ptr) - node_mng_.pool) : JES_INVALID_INDEX)
 
+/* A handle is the index of the node holding an element. The value of a merged
+   member shares the node of its key, so its handle has the low bit set. */
+#ifdef JES_USE_MERGED_KEY_NODE
+#define JES_HANDLE_INDEX(handle_) ((handle_) >> 1)
+#define JES_HANDLE_IS_VALUE(handle_) (((handle_) & 1) != 0)
+#define JES_NODE_HANDLE(index_) ((jes_handle)(index_) << 1)
+#define JES_VALUE_HANDLE(index_) (((jes_handle)(index_) << 1) | 1)
+#else
+#define JES_HANDLE_INDEX(handle_) (handle_)
+#define JES_HANDLE_IS_VALUE(handle_) false
+#define JES_NODE_HANDLE(index_) ((jes_handle)(index_))
+#endif
+
+#ifdef JES_USE_COMPACT_NODE
+/* Marks an element offset as a reference to a value holder node instead of an
+   offset into the JSON data. The remaining bits keep the holder node index. */
+#define JES_EXTERNAL_VALUE 0x80000000
+#define JES_HAS_EXTERNAL_VALUE(element_ptr) (((element_ptr)->offset & JES_EXTERNAL_VALUE) != 0)
+#define JES_ELEMENT_VALUE(ctx_, element_ptr) \
+  (JES_HAS_EXTERNAL_VALUE(element_ptr) \
+    ? jes_get_holder_value(&(ctx_)->node_mng.pool[(element_ptr)->offset & ~JES_EXTERNAL_VALUE]) \
+    : (ctx_)->serdes.tokenizer.json_data + (element_ptr)->offset)
+#else
+#define JES_ELEMENT_VALUE(ctx_, element_ptr) ((element_ptr)->value)
+#endif
+
 #define JES_CONTEXT_COOKIE 0xABC09DEF
 #define JES_IS_INITIATED(ctx_) ((ctx_)->cookie == JES_CONTEXT_COOKIE)
 
@@ -78,22 +145,80 @@ struct jes_node {
   /* Element containing TLV JSON data.
    * This should be the first member of the node structure. */
   struct jes_element json_tlv;
+#ifdef JES_USE_MERGED_KEY_NODE
+  /* Value of an object member. Only used by JES_KEY nodes. JES_UNKNOWN type
+   * marks a key that has no value yet. */
+  struct jes_element value_tlv;
+#endif
   /* Index of the parent node. Each node holds the index of its parent. */
   jes_node_descriptor parent;
   /* Index of sibling node. Siblings are always on the right of nodes.
    * That means reaching a specific sibling, requires iterations from left side
    * to the right side of the branch. */
   jes_node_descriptor sibling;
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+  /* Index of the sibling on the left side. Makes unlinking a node and
+   * inserting before a node independent of the branch length. */
+  jes_node_descriptor prev_sibling;
+#endif
   /* Each parent keeps only the index of its first child and its last child.
    * The remaining child nodes can be reached using the sibling indices. */
   jes_node_descriptor first_child;
   jes_node_descriptor last_child;
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+  /* Index of the first node after the subtree of this node in pre-order
+   * (the sibling of the node or the subtree end of its parent). Allows to skip
+   * a whole branch with a single jump. */
+  jes_node_descriptor subtree_end;
+#endif
+#ifdef JES_USE_CHILD_COUNT
+  /* Number of children. Cannot exceed the number of nodes, so it fits a
+   * descriptor. */
+  jes_node_descriptor child_count;
+#endif
 };
 
 struct jes_freed_node {
-  struct jes_freed_node* next;
+  /* Keeps the element of a released node with the JES_UNKNOWN type, so stale
+   * references (e.g. hash table entries) can still recognize it as released. */
+  struct jes_element json_tlv;
+  /* Next released node. A descriptor, since nodes need not be pointer aligned. */
+  jes_node_descriptor next;
 };
 
+/* A node from the pool that keeps the pointer to a value outside of the JSON data.
+ * Only used in compact node mode where elements store offsets instead of pointers. */
+struct jes_value_holder {
+  const char* value;
+};
+
+#ifdef JES_USE_COMPACT_NODE
+/* Compact nodes are only 4-byte aligned. The pointer of a value holder is
+ * copied byte-wise. */
+static inline const char* jes_get_holder_value(const struct jes_node* holder)
+{
+  const char* value;
+  memcpy(&value, holder, sizeof(value));
+  return value;
+}
+
+static inline void jes_set_holder_value(struct jes_node* holder, const char* value)
+{
+  memcpy(holder, &value, sizeof(value));
+}
+#endif
+
+#ifdef JES_ENABLE_ARRAY_INDEX
+struct jes_array_index {
+  /* Indexed array node */
+  struct jes_node* owner;
+  /* Position of the first entry, counted from the end of the table */
+  size_t offset;
+  /* Number of indexed elements */
+  size_t size;
+};
+#endif
+
 struct jes_node_mng_context {
   /* Part of the buffer given by the user at the time of the context initialization.
    * The buffer will be used to allocate the context structure at first.
@@ -106,6 +231,8 @@ struct jes_node_mng_context {
   size_t capacity;
   /* Index of the pool's next free node */
   jes_node_descriptor next_free;
+  /* Number of allocated nodes that hold external values (compact node mode). */
+  jes_node_descriptor value_holder_count;
   /* Singly Linked list of previously freed nodes to be recycled by the allocator. */
   struct jes_freed_node* freed;
   /* Number of nodes in the current JSON */
@@ -114,6 +241,17 @@ struct jes_node_mng_context {
   struct jes_node* (*find_key_fn) (struct jes_context* ctx, struct jes_node* parent, const char* key, size_t key_len);
   /* Holds the main object node */
   struct jes_node* root;
+#ifdef JES_ENABLE_ARRAY_INDEX
+  /* End of the array index table. The descriptors of the indexed array
+   * elements are stored from the end of the node pool downwards, so the newest
+   * table can grow on append until it meets the allocated nodes. */
+  jes_node_descriptor* array_index;
+  /* Indexed arrays in the order of their tables, the oldest one at the end of
+   * the node pool. Only the first array_index_count entries are valid. */
+  struct jes_array_index array_indexes[JES_ARRAY_INDEX_SLOTS];
+  /* Number of indexed arrays */
+  size_t array_index_count;
+#endif
 };
 
 struct jes_cursor {
@@ -160,14 +298,22 @@ struct jes_hash_table_context {
   size_t capacity;
   /* Number of hash entries currently allocated. */
   size_t entry_count;
+  /* Number of slots marked as deleted. Cleared by an in-place rehash. */
+  size_t deleted_count;
+  /* Seeds the hash of every keyword. Set by jes_set_hash_seed(),
+   * kept across jes_reset() and jes_load(). */
+  uint32_t seed;
+  /* Generation of the groups in use. Other groups are empty. */
+  uint8_t generation;
   /* Hash function pointer for generating table indices from keys.
-   * @param parent_id   Unique identifier of the parent JSON object
+   * @param seed        Seed of the table
    * @param key         key name to hash (non-NUL terminated)
    * @param key_length  Length of the key string in bytes
-   * @return            Hash value used for table indexing
+   * @return            Hash of the keyword
    *
-   * Incorporates parent_id to handle nested objects with identical keys. */
-  uint32_t (*hash_fn) (uint32_t parent_id, const char* key, size_t keyword_length);
+   * The hash is combined with the index of the parent object to handle nested
+   * objects with identical keys. */
+  uint32_t (*hash_fn) (uint32_t seed, const char* key, size_t keyword_length);
   /* Function to add a key-value pair to the hash table.
    *
    * @param ctx     Main JES context containing all parsing state
@@ -203,6 +349,22 @@ struct jes_context {
   void* workspace;
   /* Size of the workspace buffer in bytes. This will be used to reconstruct the workspace when needed. */
   size_t workspace_size;
+#ifdef JES_ENABLE_WORKSPACE_GROW
+  /* Requests a bigger buffer when the node pool or the hash table is full. NULL disables growing. */
+  jes_workspace_grow_fn grow_fn;
+  /* Buffer provided by grow_fn. Holds the node pool and the hash table instead
+   * of the workspace. NULL until the workspace grows for the first time. */
+  void* grown_workspace;
+  /* Size of the grown buffer in bytes. */
+  size_t grown_workspace_size;
+#endif
+#ifdef JES_ENABLE_FILE_MAPPING
+  /* Read-only mapping of the file loaded by jes_load_file() or
+   * jes_load_image_file(). NULL if the tree does not reference a mapping. */
+  void* mapping;
+  /* Size of the mapping in bytes. */
+  size_t mapping_size;
+#endif
   /* Linear or hashed table key search */
   enum jes_search_mode mode;
   /* Serialization/Deserialization subsystem state. */
@@ -213,6 +375,63 @@ struct jes_context {
   struct jes_hash_table_context hash_table;
 
   char path_separator;
+  /* Set by jes_freeze(). The tree and the lookup state are not modified anymore. */
+  bool frozen;
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+  /* Set by jes_load(). The keys of the tree are hashed by the first lookup. */
+  bool hash_index_deferred;
+#endif
+};
+
+#ifdef JES_ENABLE_FILE_MAPPING
+/**
+ * Releases the file mapping referenced by the tree, if any.
+ */
+void jes_unmap_file(struct jes_context* ctx);
+#endif
+
+#define JES_IMAGE_MAGIC   0x4A455349 /* "JESI" */
+#define JES_IMAGE_VERSION 5
+
+/* Header of a workspace image written by jes_save_image(). It is followed by
+ * the used part of the node pool, the hash table entries and the text section,
+ * each starting at an aligned offset. The text section holds the loaded JSON
+ * data followed by the values that were added through the API.
+ * Pointers are stored as offsets into the text section or indices into the
+ * node pool, biased by one so that 0 still means NULL. */
+struct jes_image_header {
+  uint32_t magic;
+  uint16_t version;
+  /* Layout checks. An image is only valid for the build that wrote it. */
+  uint16_t node_size;
+  uint32_t config;
+  uint32_t mode;
+  /* Used part of the node pool (next_free) */
+  uint32_t pool_node_count;
+  /* Number of nodes in the tree */
+  uint32_t node_count;
+  uint32_t value_holder_count;
+  /* Biased indices of the root node and of the head of the freed node list */
+  uint32_t root;
+  uint32_t freed;
+  uint32_t hash_entry_count;
+  /* Hash function and seed of the stored entries. The keys are hashed again
+   * if they differ from those of the loading context. */
+  uint32_t hash_function;
+  uint32_t hash_seed;
+  /* Key count from which the keys of an object are hashed */
+  uint32_t hash_min_keys;
+  uint32_t json_length;
+  uint32_t text_length;
 };
 
-#endif
\ No newline at end of file
+#ifdef JES_ENABLE_WORKSPACE_GROW
+/**
+ * Moves the node pool and the hash table to a buffer twice the current size,
+ * provided by the grow callback. Node pointers become invalid, callers that
+ * allocate nodes must keep descriptors instead.
+ */
+jes_status jes_workspace_grow(struct jes_context* ctx);
+#endif
+
+#endif
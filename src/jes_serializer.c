@@ -7,6 +7,7 @@
 #include "jes_private.h"
 #include "jes_logger.h"
 #include "jes_serializer.h"
+#include "jes_tree.h"
 
 #ifndef NDEBUG
   #define JES_LOG_NODE  jes_log_node
@@ -33,6 +34,7 @@ struct jes_renderer_set {
 
 struct jes_serializer {
   struct jes_renderer_set renderer;
+  struct jes_context* ctx;
   size_t evaluated_length;
   size_t indention;
   char* out_buffer;
@@ -119,7 +121,7 @@ static void jes_serializer_render_string(struct jes_serializer* serializer, stru
   *serializer->out_buffer++ = '"';
   /* The JSON string has already been validated for size and structure,
      so this memcpy can proceed safely without further boundary checks. */
-  memcpy(serializer->out_buffer, element->value, element->length);
+  memcpy(serializer->out_buffer, JES_ELEMENT_VALUE(serializer->ctx, element), element->length);
   serializer->out_buffer += element->length;
   *serializer->out_buffer++ = '"';
 
@@ -132,7 +134,7 @@ static void jes_serializer_render_key(struct jes_serializer* serializer, struct
   *serializer->out_buffer++ = '"';
   /* The JSON string has already been validated for size and structure,
      so this memcpy can proceed safely without further boundary checks. */
-  memcpy(serializer->out_buffer, element->value, element->length);
+  memcpy(serializer->out_buffer, JES_ELEMENT_VALUE(serializer->ctx, element), element->length);
   serializer->out_buffer += element->length;
   *serializer->out_buffer++ = '"';
   *serializer->out_buffer++ = ':';
@@ -145,7 +147,7 @@ static void jes_serializer_render_number(struct jes_serializer* serializer, stru
   assert((serializer->out_buffer + element->length) < serializer->buffer_end);
   /* The JSON string has already been validated for size and structure,
      so this memcpy can proceed safely without further boundary checks. */
-  memcpy(serializer->out_buffer, element->value, element->length);
+  memcpy(serializer->out_buffer, JES_ELEMENT_VALUE(serializer->ctx, element), element->length);
   serializer->out_buffer += element->length;
 }
 
@@ -155,7 +157,7 @@ static void jes_serializer_render_literal(struct jes_serializer* serializer, str
   assert((serializer->out_buffer + element->length) < serializer->buffer_end);
   /* The JSON string has already been validated for size and structure,
      so this memcpy can proceed safely without further boundary checks. */
-  memcpy(serializer->out_buffer, element->value, element->length);
+  memcpy(serializer->out_buffer, JES_ELEMENT_VALUE(serializer->ctx, element), element->length);
   serializer->out_buffer += element->length;
 }
 
@@ -182,7 +184,7 @@ static void jes_serializer_render_compact_key(struct jes_serializer* serializer,
   *serializer->out_buffer++ = '"';
   /* The JSON string has already been validated for size and structure,
      so this memcpy can proceed safely without further boundary checks. */
-  memcpy(serializer->out_buffer, element->value, element->length);
+  memcpy(serializer->out_buffer, JES_ELEMENT_VALUE(serializer->ctx, element), element->length);
   serializer->out_buffer += element->length;
   *serializer->out_buffer++ = '"';
   *serializer->out_buffer++ = ':';
@@ -195,12 +197,18 @@ static void jes_serializer_render_compact_new_line(struct jes_serializer* serial
   (void)serializer;
 }
 
+static inline void jes_serializer_process_expect_value_state(struct jes_context* ctx, struct jes_serializer* serializer);
+
 static inline void jes_serializer_process_expect_key_state(struct jes_context* ctx, struct jes_serializer* serializer)
 {
   switch (NODE_TYPE(ctx->serdes.iter)) {
     case JES_KEY:
       serializer->renderer.key(serializer, &ctx->serdes.iter->json_tlv);
       ctx->serdes.state = JES_EXPECT_VALUE;
+#ifdef JES_USE_MERGED_KEY_NODE
+      /* The value is embedded in the key node. Render it without moving to the next node. */
+      jes_serializer_process_expect_value_state(ctx, serializer);
+#endif
       break;
     default:
       ctx->status = JES_UNEXPECTED_ELEMENT;
@@ -210,19 +218,19 @@ static inline void jes_serializer_process_expect_key_state(struct jes_context* c
 
 static inline void jes_serializer_process_expect_value_state(struct jes_context* ctx, struct jes_serializer* serializer)
 {
-  switch (NODE_TYPE(ctx->serdes.iter)) {
+  switch (NODE_VALUE_TYPE(ctx->serdes.iter)) {
     case JES_STRING:
-      serializer->renderer.string(serializer, &ctx->serdes.iter->json_tlv);
+      serializer->renderer.string(serializer, NODE_VALUE_ELEMENT(ctx->serdes.iter));
       ctx->serdes.state = JES_HAVE_VALUE;
       break;
     case JES_NUMBER:
-      serializer->renderer.number(serializer, &ctx->serdes.iter->json_tlv);
+      serializer->renderer.number(serializer, NODE_VALUE_ELEMENT(ctx->serdes.iter));
       ctx->serdes.state = JES_HAVE_VALUE;
       break;
     case JES_TRUE:
     case JES_FALSE:
     case JES_NULL:
-      serializer->renderer.literal(serializer, &ctx->serdes.iter->json_tlv);
+      serializer->renderer.literal(serializer, NODE_VALUE_ELEMENT(ctx->serdes.iter));
       ctx->serdes.state = JES_HAVE_VALUE;
       break;
     case JES_OBJECT:
@@ -278,12 +286,12 @@ static inline void jes_serializer_process_have_value_state(struct jes_context* c
       ctx->serdes.state = JES_HAVE_VALUE;
       iter = GET_PARENT(ctx->node_mng, iter);
       if (iter != NULL) {
-        if (NODE_TYPE(iter) == JES_ARRAY) {
+        if (NODE_VALUE_TYPE(iter) == JES_ARRAY) {
           serializer->indention -= JES_TAB_SIZE;
           serializer->renderer.new_line(serializer);
           serializer->renderer.closing_bracket(serializer);
         }
-        else if (NODE_TYPE(iter) == JES_OBJECT) {
+        else if (NODE_VALUE_TYPE(iter) == JES_OBJECT) {
           serializer->indention -= JES_TAB_SIZE;
           serializer->renderer.new_line(serializer);
           serializer->renderer.closing_brace(serializer);
@@ -310,20 +318,9 @@ struct jes_node* jes_serializer_get_node(struct jes_context* ctx)
   else if (HAS_CHILD(ctx->serdes.iter)) {
     ctx->serdes.iter = GET_FIRST_CHILD(ctx->node_mng, ctx->serdes.iter);
   }
-  /* No children available: try to move to next sibling (breadth at current level) */
-  else if (HAS_SIBLING(ctx->serdes.iter)) {
-    ctx->serdes.iter = GET_SIBLING(ctx->node_mng, ctx->serdes.iter);
-  }
+  /* No children available: skip to the next node after the current (leaf) subtree */
   else {
-    /* No children or siblings: backtrack up the tree to find next un-visited branch
-       Walk up parent chain until we find a parent with an un-visited sibling */
-    while ((ctx->serdes.iter = GET_PARENT(ctx->node_mng, ctx->serdes.iter))) {
-      /* Found a parent with a sibling - this is our next branch to explore */
-      if (HAS_SIBLING(ctx->serdes.iter)) {
-        ctx->serdes.iter = GET_SIBLING(ctx->node_mng, ctx->serdes.iter);
-        break;
-      }
-    }
+    ctx->serdes.iter = jes_tree_get_subtree_end_node(ctx, ctx->serdes.iter);
   }
 
   if (ctx->serdes.iter == NULL) {
@@ -371,7 +368,7 @@ static void jes_serializer_state_machine(struct jes_context* ctx, struct jes_ser
     JES_LOG_NODE("", JES_NODE_INDEX(ctx->node_mng, ctx->serdes.iter),
                           ctx->serdes.iter->json_tlv.type,
                           ctx->serdes.iter->json_tlv.length,
-                          ctx->serdes.iter->json_tlv.value,
+                          JES_ELEMENT_VALUE(ctx, &ctx->serdes.iter->json_tlv),
                           ctx->serdes.iter->parent,
                           ctx->serdes.iter->sibling,
                           ctx->serdes.iter->first_child,
@@ -407,6 +404,7 @@ size_t jes_render(struct jes_context *ctx, char* buffer, size_t buffer_length, b
 
   /* First pass: just evaluate the JSON structure and calculate the required output buffer length. */
   ctx->status = JES_NO_ERROR;
+  serializer.ctx = ctx;
   serializer.renderer.opening_brace = jes_serializer_calculate_delimiter;
   serializer.renderer.closing_brace = jes_serializer_calculate_delimiter;
   serializer.renderer.opening_bracket = jes_serializer_calculate_delimiter;
@@ -475,6 +473,7 @@ size_t jes_evaluate(struct jes_context *ctx, bool compact)
   }
 
   ctx->status = JES_NO_ERROR;
+  serializer.ctx = ctx;
   serializer.renderer.opening_brace = jes_serializer_calculate_delimiter;
   serializer.renderer.closing_brace = jes_serializer_calculate_delimiter;
   serializer.renderer.opening_bracket = jes_serializer_calculate_delimiter;
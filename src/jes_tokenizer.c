@@ -615,6 +615,78 @@ enum jes_status jes_tokenizer_validate_string(struct jes_context* ctx, const cha
   return status;
 }
 
+void jes_tokenizer_count_elements(const char* json_data, size_t json_length,
+                                  size_t* value_count, size_t* key_count)
+{
+  const char* pos = json_data;
+  const char* end = json_data + json_length;
+  const char* quote;
+  bool in_literal = false;
+
+  *value_count = 0;
+  *key_count = 0;
+
+  while (pos < end) {
+    char ch = *pos++;
+    switch (ch) {
+      case '\0':
+        /* The tokenizer ends the document at a null character. */
+        pos = end;
+        break;
+      case '{':
+      case '[':
+        (*value_count)++;
+        in_literal = false;
+        break;
+      case '}':
+      case ']':
+      case ',':
+      case ':':
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+      case '\f':
+        in_literal = false;
+        break;
+      case '\"':
+        /* Jump over the string content. A quote preceded by an odd number of
+           backslashes is part of the string. */
+        while ((quote = memchr(pos, '\"', (size_t)(end - pos))) != NULL) {
+          const char* escape = quote;
+          while ((escape > pos) && (*(escape - 1) == '\\')) {
+            escape--;
+          }
+          pos = quote + 1;
+          if (((quote - escape) & 1) == 0) {
+            break;
+          }
+        }
+        if (quote == NULL) {
+          pos = end;
+        }
+        while ((pos < end) && IS_SPACE(*pos)) {
+          pos++;
+        }
+        if ((pos < end) && (*pos == ':')) {
+          (*key_count)++;
+        }
+        else {
+          (*value_count)++;
+        }
+        in_literal = false;
+        break;
+      default:
+        /* Numbers and literals are counted at their first character. */
+        if (!in_literal) {
+          (*value_count)++;
+          in_literal = true;
+        }
+        break;
+    }
+  }
+}
+
 void jes_tokenizer_reset_cursor(struct jes_tokenizer_context* ctx)
 {
   ctx->cursor.pos = ctx->json_data;
@@ -4,6 +4,9 @@
 enum jes_status jes_tokenizer_get_token(struct jes_tokenizer_context* tokenizer);
 enum jes_status jes_tokenizer_validate_number(struct jes_context* ctx, const char* value, size_t length);
 enum jes_status jes_tokenizer_validate_string(struct jes_context* ctx, const char* value, size_t length);
+/* Counts values (including containers) and object keys in a single pass without validation. */
+void jes_tokenizer_count_elements(const char* json_data, size_t json_length,
+                                  size_t* value_count, size_t* key_count);
 void jes_tokenizer_reset_cursor(struct jes_tokenizer_context* ctx);
 
 #endif
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -5,6 +6,7 @@
 #include <assert.h>
 #include "jes.h"
 #include "jes_private.h"
+#include "jes_tree.h"
 #include "jes_logger.h"
 
 #ifndef NDEBUG
@@ -17,6 +19,101 @@
 
 static struct jes_node* jes_tree_find_key(struct jes_context*, struct jes_node*, const char*, size_t);
 
+#ifdef JES_ENABLE_ARRAY_INDEX
+/* Entry i of the array index. The table grows downwards from its end. */
+#define JES_ARRAY_INDEX_ENTRY(mng_ctx_, i_) ((mng_ctx_)->array_index[-(ptrdiff_t)(i_) - 1])
+
+/* Checks if the array index can hold count entries without overlapping the allocated nodes. */
+static inline bool jes_tree_array_index_fits(struct jes_node_mng_context* mng_ctx, size_t count)
+{
+  return (size_t)((uint8_t*)mng_ctx->array_index - (uint8_t*)&mng_ctx->pool[mng_ctx->next_free])
+         >= count * sizeof(jes_node_descriptor);
+}
+
+/* Number of table entries in use, including gaps left by deletes. */
+static inline size_t jes_tree_array_index_used(struct jes_node_mng_context* mng_ctx)
+{
+  struct jes_array_index* newest = NULL;
+
+  if (mng_ctx->array_index_count == 0) {
+    return 0;
+  }
+  newest = &mng_ctx->array_indexes[mng_ctx->array_index_count - 1];
+  return newest->offset + newest->size;
+}
+
+/* Returns the index of an array or NULL if the array is not indexed. */
+static struct jes_array_index* jes_tree_find_array_index(struct jes_node_mng_context* mng_ctx,
+                                                         const struct jes_node* node)
+{
+  size_t slot;
+
+  for (slot = 0; slot < mng_ctx->array_index_count; slot++) {
+    if (mng_ctx->array_indexes[slot].owner == node) {
+      return &mng_ctx->array_indexes[slot];
+    }
+  }
+  return NULL;
+}
+
+/* Drops an array index. The tables of newer indexes move up to close the gap. */
+static void jes_tree_drop_array_index(struct jes_node_mng_context* mng_ctx, struct jes_array_index* array_index)
+{
+  size_t slot = (size_t)(array_index - mng_ctx->array_indexes);
+  size_t used = jes_tree_array_index_used(mng_ctx);
+  size_t shift;
+  size_t moved;
+
+  assert(slot < mng_ctx->array_index_count);
+
+  if (slot + 1 < mng_ctx->array_index_count) {
+    shift = mng_ctx->array_indexes[slot + 1].offset - array_index->offset;
+    moved = used - mng_ctx->array_indexes[slot + 1].offset;
+    if (moved > 0) {
+      memmove(&JES_ARRAY_INDEX_ENTRY(mng_ctx, used - 1 - shift),
+              &JES_ARRAY_INDEX_ENTRY(mng_ctx, used - 1),
+              moved * sizeof(jes_node_descriptor));
+    }
+    for (slot++; slot < mng_ctx->array_index_count; slot++) {
+      mng_ctx->array_indexes[slot - 1] = mng_ctx->array_indexes[slot];
+      mng_ctx->array_indexes[slot - 1].offset -= shift;
+    }
+  }
+  mng_ctx->array_index_count--;
+}
+
+/* Indexes the children of an array behind the newest table. The oldest index
+   is dropped if all slots are taken. Gives up if the table runs into the
+   allocated nodes. */
+static struct jes_array_index* jes_tree_build_array_index(struct jes_context* ctx, struct jes_node* node)
+{
+  struct jes_node_mng_context* mng_ctx = &ctx->node_mng;
+  struct jes_array_index* array_index = NULL;
+  struct jes_node* iter = NULL;
+  size_t offset;
+  size_t count = 0;
+
+  if (mng_ctx->array_index_count == JES_ARRAY_INDEX_SLOTS) {
+    jes_tree_drop_array_index(mng_ctx, &mng_ctx->array_indexes[0]);
+  }
+  offset = jes_tree_array_index_used(mng_ctx);
+
+  for (iter = GET_FIRST_CHILD(ctx->node_mng, node); iter != NULL; iter = GET_SIBLING(ctx->node_mng, iter)) {
+    if (!jes_tree_array_index_fits(mng_ctx, offset + count + 1)) {
+      return NULL;
+    }
+    JES_ARRAY_INDEX_ENTRY(mng_ctx, offset + count) = JES_NODE_INDEX(ctx->node_mng, iter);
+    count++;
+  }
+
+  array_index = &mng_ctx->array_indexes[mng_ctx->array_index_count++];
+  array_index->owner = node;
+  array_index->offset = offset;
+  array_index->size = count;
+  return array_index;
+}
+#endif
+
 static struct jes_node* jes_allocate(struct jes_context* ctx)
 {
   struct jes_node_mng_context* mng_ctx = NULL;
@@ -25,22 +122,63 @@ static struct jes_node* jes_allocate(struct jes_context* ctx)
   assert(ctx != NULL);
   mng_ctx = &ctx->node_mng;
 
+#ifdef JES_ENABLE_ADAPTIVE_WORKSPACE
+  if ((mng_ctx->node_count >= mng_ctx->capacity) && (mng_ctx->capacity < (JES_INVALID_INDEX - 1)) &&
+      (JES_SEARCH_HASHED == ctx->mode)) {
+    /* The pool takes unused slots of the hash table. On failure, it grows or
+       the allocation fails below. */
+    jes_hash_table_shrink(ctx);
+  }
+#endif
+
+#ifdef JES_ENABLE_WORKSPACE_GROW
+  if ((mng_ctx->node_count >= mng_ctx->capacity) && (mng_ctx->capacity < (JES_INVALID_INDEX - 1))) {
+    /* Moves the pool. On failure, the allocation fails below. */
+    jes_workspace_grow(ctx);
+  }
+#endif
+
   if (mng_ctx->node_count < mng_ctx->capacity) {
     if (mng_ctx->freed) {
       /* Pop the first node from free list */
       new_node = (struct jes_node*)mng_ctx->freed;
-      mng_ctx->freed = mng_ctx->freed->next;
+      mng_ctx->freed = (struct jes_freed_node*)GET_NODE((*mng_ctx), mng_ctx->freed->next);
     }
     else {
       assert(mng_ctx->next_free < mng_ctx->capacity);
       new_node = &mng_ctx->pool[mng_ctx->next_free];
       mng_ctx->next_free++;
+#ifdef JES_ENABLE_ARRAY_INDEX
+      while (!jes_tree_array_index_fits(mng_ctx, jes_tree_array_index_used(mng_ctx))) {
+        /* The new node takes the memory of the newest array index */
+        mng_ctx->array_index_count--;
+      }
+#endif
     }
+#ifdef JES_USE_COMPACT_NODE
+    new_node->json_tlv.offset = 0;
+#endif
+#ifdef JES_USE_MERGED_KEY_NODE
+    new_node->value_tlv.type = JES_UNKNOWN;
+    new_node->value_tlv.length = 0;
+  #ifdef JES_USE_COMPACT_NODE
+    new_node->value_tlv.offset = 0;
+  #endif
+#endif
     /* Setting node descriptors to their default values. */
     new_node->parent = JES_INVALID_INDEX;
     new_node->sibling = JES_INVALID_INDEX;
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+    new_node->prev_sibling = JES_INVALID_INDEX;
+#endif
     new_node->first_child = JES_INVALID_INDEX;
     new_node->last_child = JES_INVALID_INDEX;
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+    new_node->subtree_end = JES_INVALID_INDEX;
+#endif
+#ifdef JES_USE_CHILD_COUNT
+    new_node->child_count = 0;
+#endif
 
     mng_ctx->node_count++;
   }
@@ -51,7 +189,7 @@ static struct jes_node* jes_allocate(struct jes_context* ctx)
   return new_node;
 }
 
-static void jes_free(struct jes_context* ctx, struct jes_node* node)
+static void jes_release(struct jes_context* ctx, struct jes_node* node)
 {
   struct jes_node_mng_context* mng_ctx = NULL;
   struct jes_freed_node* free_node = (struct jes_freed_node*)node;
@@ -67,16 +205,79 @@ static void jes_free(struct jes_context* ctx, struct jes_node* node)
 
   if (mng_ctx->node_count > 0) {
     node->json_tlv.type = JES_UNKNOWN; /* This prevents reuse of deleted nodes. */
-    free_node->next = NULL;
+#ifdef JES_ENABLE_ARRAY_INDEX
+    struct jes_array_index* array_index = jes_tree_find_array_index(mng_ctx, node);
+    if (array_index != NULL) {
+      jes_tree_drop_array_index(mng_ctx, array_index);
+    }
+#endif
     mng_ctx->node_count--;
     /* prepend the node to the free LIFO */
-    if (mng_ctx->freed) {
-      free_node->next = mng_ctx->freed;
-    }
+    free_node->next = JES_NODE_INDEX((*mng_ctx), (struct jes_node*)mng_ctx->freed);
     mng_ctx->freed = free_node;
   }
 }
 
+#ifdef JES_USE_COMPACT_NODE
+/* Releases the holder node of an external value. */
+static void jes_free_value(struct jes_context* ctx, struct jes_element* element)
+{
+  if (JES_HAS_EXTERNAL_VALUE(element)) {
+    assert(ctx->node_mng.value_holder_count > 0);
+    jes_release(ctx, &ctx->node_mng.pool[element->offset & ~JES_EXTERNAL_VALUE]);
+    ctx->node_mng.value_holder_count--;
+    element->offset = 0;
+  }
+}
+#endif
+
+static void jes_free(struct jes_context* ctx, struct jes_node* node)
+{
+#ifdef JES_USE_COMPACT_NODE
+  jes_free_value(ctx, &node->json_tlv);
+  #ifdef JES_USE_MERGED_KEY_NODE
+  jes_free_value(ctx, &node->value_tlv);
+  #endif
+#endif
+  jes_release(ctx, node);
+}
+
+bool jes_tree_set_element_value(struct jes_context* ctx, struct jes_element* element, const char* value)
+{
+#ifdef JES_USE_COMPACT_NODE
+  const char* json_data = ctx->serdes.tokenizer.json_data;
+  struct jes_node* holder = NULL;
+
+  /* Drop the holder of a previous external value */
+  jes_free_value(ctx, element);
+
+  if ((json_data != NULL) && (value != NULL) &&
+      ((uintptr_t)value >= (uintptr_t)json_data) &&
+      ((uintptr_t)value <= ((uintptr_t)json_data + ctx->serdes.tokenizer.json_length))) {
+    element->offset = (uint32_t)(value - json_data);
+  }
+  else {
+    /* The value is not a part of the JSON data and can not be addressed by an
+       offset. Keep its pointer in a separate node. */
+    size_t element_offset = (size_t)((uint8_t*)element - (uint8_t*)ctx->node_mng.pool);
+    holder = jes_allocate(ctx);
+    if (holder == NULL) {
+      return false;
+    }
+    /* The allocation may have moved the pool */
+    element = (struct jes_element*)((uint8_t*)ctx->node_mng.pool + element_offset);
+    assert(JES_NODE_INDEX(ctx->node_mng, holder) < JES_EXTERNAL_VALUE);
+    jes_set_holder_value(holder, value);
+    element->offset = JES_EXTERNAL_VALUE | JES_NODE_INDEX(ctx->node_mng, holder);
+    ctx->node_mng.value_holder_count++;
+  }
+#else
+  (void)ctx;
+  element->value = value;
+#endif
+  return true;
+}
+
 bool jes_validate_node(struct jes_context* ctx, struct jes_node* node)
 {
   struct jes_node_mng_context* mng_ctx = NULL;
@@ -94,7 +295,14 @@ bool jes_validate_node(struct jes_context* ctx, struct jes_node* node)
       if (((node->parent == JES_INVALID_INDEX)      || (node->parent < mng_ctx->capacity))      &&
           ((node->first_child == JES_INVALID_INDEX) || (node->first_child < mng_ctx->capacity)) &&
           ((node->last_child == JES_INVALID_INDEX)  || (node->last_child < mng_ctx->capacity))  &&
-          ((node->sibling == JES_INVALID_INDEX)     || (node->sibling < mng_ctx->capacity))) {
+          ((node->sibling == JES_INVALID_INDEX)     || (node->sibling < mng_ctx->capacity))
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+          && ((node->prev_sibling == JES_INVALID_INDEX) || (node->prev_sibling < mng_ctx->capacity))
+#endif
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+          && ((node->subtree_end == JES_INVALID_INDEX) || (node->subtree_end < mng_ctx->capacity))
+#endif
+          ) {
         return true;
       }
     }
@@ -103,6 +311,31 @@ bool jes_validate_node(struct jes_context* ctx, struct jes_node* node)
   return false;
 }
 
+struct jes_node* jes_tree_get_element_node(struct jes_context* ctx, struct jes_element* element)
+{
+  struct jes_node* node = (struct jes_node*)element;
+
+  assert(ctx != NULL);
+
+  if (element == NULL) {
+    return NULL;
+  }
+
+#ifdef JES_USE_MERGED_KEY_NODE
+  /* The value element of a member is embedded in its key node. */
+  if (((uintptr_t)element >= ((uintptr_t)(ctx->node_mng.pool) + offsetof(struct jes_node, value_tlv))) &&
+      (((uintptr_t)element - (uintptr_t)(ctx->node_mng.pool)) % sizeof(*node) == offsetof(struct jes_node, value_tlv))) {
+    node = (struct jes_node*)((uintptr_t)element - offsetof(struct jes_node, value_tlv));
+    if (!jes_validate_node(ctx, node) || (NODE_TYPE(node) != JES_KEY) || (element->type == JES_UNKNOWN)) {
+      return NULL;
+    }
+    return node;
+  }
+#endif
+
+  return jes_validate_node(ctx, node) ? node : NULL;
+}
+
 struct jes_node* jes_tree_get_parent_node(struct jes_context* ctx,
                                           struct jes_node* node)
 {
@@ -124,6 +357,82 @@ struct jes_node* jes_tree_get_sibling_node(struct jes_context* ctx,
   return GET_SIBLING(ctx->node_mng, node);
 }
 
+size_t jes_tree_get_child_count(struct jes_context* ctx,
+                                struct jes_node* node)
+{
+  assert(ctx != NULL);
+  assert(node != NULL);
+#ifdef JES_USE_CHILD_COUNT
+  return node->child_count;
+#else
+  size_t count = 0;
+  if (IS_CONTIGUOUS_ARRAY(node)) {
+    return HAS_CHILD(node) ? (size_t)(node->last_child - node->first_child) + 1 : 0;
+  }
+  #ifdef JES_ENABLE_ARRAY_INDEX
+  struct jes_array_index* array_index = jes_tree_find_array_index(&ctx->node_mng, node);
+  if (array_index != NULL) {
+    return array_index->size;
+  }
+  #endif
+  for (node = GET_FIRST_CHILD(ctx->node_mng, node); node != NULL; node = GET_SIBLING(ctx->node_mng, node)) {
+    count++;
+  }
+  return count;
+#endif
+}
+
+struct jes_node* jes_tree_get_child_node_at(struct jes_context* ctx,
+                                            struct jes_node* node, size_t index)
+{
+  struct jes_node* iter = NULL;
+
+  assert(ctx != NULL);
+  assert(node != NULL);
+
+  if (IS_CONTIGUOUS_ARRAY(node)) {
+    return (HAS_CHILD(node) && (index <= (size_t)(node->last_child - node->first_child)))
+         ? &ctx->node_mng.pool[node->first_child + index]
+         : NULL;
+  }
+#ifdef JES_ENABLE_ARRAY_INDEX
+  struct jes_node_mng_context* mng_ctx = &ctx->node_mng;
+  struct jes_array_index* array_index = jes_tree_find_array_index(mng_ctx, node);
+
+  if ((array_index == NULL) && (index >= JES_ARRAY_INDEX_MIN_SIZE) && !ctx->frozen) {
+    /* Readers of a frozen context share the current indexes but never build one. */
+    array_index = jes_tree_build_array_index(ctx, node);
+  }
+
+  if (array_index != NULL) {
+    return (index < array_index->size)
+         ? &mng_ctx->pool[JES_ARRAY_INDEX_ENTRY(mng_ctx, array_index->offset + index)]
+         : NULL;
+  }
+#endif
+
+  for (iter = GET_FIRST_CHILD(ctx->node_mng, node); (iter != NULL) && (index > 0); index--) {
+    iter = GET_SIBLING(ctx->node_mng, iter);
+  }
+  return iter;
+}
+
+struct jes_node* jes_tree_get_subtree_end_node(struct jes_context* ctx,
+                                               struct jes_node* node)
+{
+  assert(ctx != NULL);
+  assert(node != NULL);
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+  return GET_SUBTREE_END(ctx->node_mng, node);
+#else
+  /* Walk up the parent chain until we find a node with a sibling */
+  while ((node != NULL) && !HAS_SIBLING(node)) {
+    node = GET_PARENT(ctx->node_mng, node);
+  }
+  return GET_SIBLING(ctx->node_mng, node);
+#endif
+}
+
 struct jes_node* jes_tree_get_parent_node_by_type(struct jes_context* ctx,
                                                   struct jes_node* node,
                                                   enum jes_type type)
@@ -136,7 +445,7 @@ struct jes_node* jes_tree_get_parent_node_by_type(struct jes_context* ctx,
 
   /* Traverse up the tree until we find a parent of the requested type, or reach NULL */
   for (parent = GET_PARENT(ctx->node_mng, node);
-       parent != NULL && NODE_TYPE(parent) != type;
+       parent != NULL && NODE_VALUE_TYPE(parent) != type;
        parent = GET_PARENT(ctx->node_mng, parent)) {
     /* Empty body - all work done in the loop control expression */
   }
@@ -155,7 +464,7 @@ struct jes_node* jes_tree_get_container_parent_node(struct jes_context* ctx,
 
   /* Traverse up the tree until we find an object or array parent, or reach NULL */
   for (parent = GET_PARENT(ctx->node_mng, node);
-       parent != NULL && NODE_TYPE(parent) != JES_OBJECT && NODE_TYPE(parent) != JES_ARRAY;
+       parent != NULL && NODE_VALUE_TYPE(parent) != JES_OBJECT && NODE_VALUE_TYPE(parent) != JES_ARRAY;
        parent = GET_PARENT(ctx->node_mng, parent)) {
     /* Empty body - all work done in the loop control expression */
   }
@@ -163,14 +472,39 @@ struct jes_node* jes_tree_get_container_parent_node(struct jes_context* ctx,
   return parent;
 }
 
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+/* Updates the subtree end of a node and of its last descendants, which all share the same end. */
+static void jes_tree_set_subtree_end(struct jes_context* ctx, struct jes_node* node, jes_node_descriptor subtree_end)
+{
+  for (; node != NULL; node = GET_LAST_CHILD(ctx->node_mng, node)) {
+    node->subtree_end = subtree_end;
+  }
+}
+#endif
+
 struct jes_node* jes_tree_insert_node(struct jes_context* ctx,
                                       struct jes_node* parent, struct jes_node* anchor,
                                       uint16_t type, uint16_t length, const char* value)
 {
   struct jes_node *new_node = NULL;
+  /* Allocations may move the pool. Keep descriptors of the involved nodes. */
+  jes_node_descriptor parent_index = JES_NODE_INDEX(ctx->node_mng, parent);
+  jes_node_descriptor anchor_index = JES_NODE_INDEX(ctx->node_mng, anchor);
+  jes_node_descriptor new_node_index;
 
   new_node = jes_allocate(ctx);
 
+  if (new_node != NULL) {
+    new_node_index = JES_NODE_INDEX(ctx->node_mng, new_node);
+    if (!jes_tree_set_element_value(ctx, &new_node->json_tlv, value)) {
+      jes_free(ctx, GET_NODE(ctx->node_mng, new_node_index));
+      return NULL;
+    }
+    new_node = GET_NODE(ctx->node_mng, new_node_index);
+    parent = GET_NODE(ctx->node_mng, parent_index);
+    anchor = GET_NODE(ctx->node_mng, anchor_index);
+  }
+
   if (new_node) {
     if (parent) {
       new_node->parent = JES_NODE_INDEX(ctx->node_mng, parent);
@@ -191,18 +525,62 @@ struct jes_node* jes_tree_insert_node(struct jes_context* ctx,
         }
         parent->first_child = JES_NODE_INDEX(ctx->node_mng, new_node);
       }
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+      /* JES_NODE_INDEX of a missing anchor is JES_INVALID_INDEX */
+      new_node->prev_sibling = JES_NODE_INDEX(ctx->node_mng, anchor);
+      if (HAS_SIBLING(new_node)) {
+        ctx->node_mng.pool[new_node->sibling].prev_sibling = JES_NODE_INDEX(ctx->node_mng, new_node);
+      }
+#endif
+#ifdef JES_USE_CHILD_COUNT
+      parent->child_count++;
+#endif
+      if (IS_CONTIGUOUS_ARRAY(parent)) {
+        /* Still contiguous if the value is the only one, or if it is appended
+           right behind the last value or prepended right before the first value. */
+        bool appended = (anchor != NULL) && !HAS_SIBLING(new_node) &&
+                        (JES_NODE_INDEX(ctx->node_mng, anchor) + 1 == new_node_index);
+        bool prepended = (anchor == NULL) && HAS_SIBLING(new_node) && (new_node_index + 1 == new_node->sibling);
+        bool only = (anchor == NULL) && !HAS_SIBLING(new_node);
+        if (!appended && !prepended && !only) {
+          CLEAR_CONTIGUOUS_ARRAY(parent);
+        }
+      }
+#ifdef JES_ENABLE_ARRAY_INDEX
+      struct jes_array_index* array_index = jes_tree_find_array_index(&ctx->node_mng, parent);
+      if (array_index != NULL) {
+        /* Only the newest table can grow */
+        if (!HAS_SIBLING(new_node) &&
+            (array_index == &ctx->node_mng.array_indexes[ctx->node_mng.array_index_count - 1]) &&
+            jes_tree_array_index_fits(&ctx->node_mng, array_index->offset + array_index->size + 1)) {
+          JES_ARRAY_INDEX_ENTRY(&ctx->node_mng, array_index->offset + array_index->size) = JES_NODE_INDEX(ctx->node_mng, new_node);
+          array_index->size++;
+        }
+        else {
+          jes_tree_drop_array_index(&ctx->node_mng, array_index);
+        }
+      }
+#endif
     }
     else {
       assert(ctx->node_mng.root == NULL);
       ctx->node_mng.root = new_node;
     }
 
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+    new_node->subtree_end = HAS_SIBLING(new_node) ? new_node->sibling
+                          : (parent != NULL) ? parent->subtree_end : JES_INVALID_INDEX;
+    if (anchor) {
+      /* The subtree of the anchor now ends at the new node */
+      jes_tree_set_subtree_end(ctx, anchor, JES_NODE_INDEX(ctx->node_mng, new_node));
+    }
+#endif
+
     new_node->json_tlv.type = type;
     new_node->json_tlv.length = length;
-    new_node->json_tlv.value = value;
 #if defined(JES_ENABLE_PARSER_NODE_LOG)
     JES_LOG_NODE("    + ", JES_NODE_INDEX(ctx->node_mng, new_node), NODE_TYPE(new_node),
-                  new_node->json_tlv.length, new_node->json_tlv.value,
+                  new_node->json_tlv.length, JES_ELEMENT_VALUE(ctx, &new_node->json_tlv),
                   new_node->parent, new_node->sibling, new_node->first_child, new_node->last_child, "\n");
 #endif
   }
@@ -220,12 +598,26 @@ struct jes_node* jes_tree_insert_key_node(struct jes_context* ctx,
   struct jes_node* duplicate_key_node = NULL;
 
   if (parent_object) {
-    assert(NODE_TYPE(parent_object) == JES_OBJECT);
+    assert(NODE_VALUE_TYPE(parent_object) == JES_OBJECT);
   }
   else {
     assert(anchor == NULL);
   }
 
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+  if (ctx->hash_index_deferred && !ctx->frozen) {
+    /* The index is built before the duplicate check, which must not move
+       the pool. Adding a key may grow the workspace. */
+    jes_node_descriptor parent_index = JES_NODE_INDEX(ctx->node_mng, parent_object);
+    jes_node_descriptor anchor_index = JES_NODE_INDEX(ctx->node_mng, anchor);
+    jes_status status = ctx->status;
+    jes_hash_table_build(ctx, true);
+    ctx->status = status;
+    parent_object = GET_NODE(ctx->node_mng, parent_index);
+    anchor = GET_NODE(ctx->node_mng, anchor_index);
+  }
+#endif
+
   /* No duplicate keys in the same object are allowed. */
   duplicate_key_node = ctx->node_mng.find_key_fn(ctx, parent_object, keyword, keyword_length);
 
@@ -238,31 +630,66 @@ struct jes_node* jes_tree_insert_key_node(struct jes_context* ctx,
   }
 
   if ((new_node) && (JES_SEARCH_HASHED == ctx->mode)) {
+    jes_node_descriptor new_node_index = JES_NODE_INDEX(ctx->node_mng, new_node);
     assert(ctx->hash_table.add_fn != NULL);
-    ctx->hash_table.add_fn(ctx, parent_object, new_node);
+    ctx->hash_table.add_fn(ctx, GET_PARENT(ctx->node_mng, new_node), new_node);
+    /* A full hash table may have moved the pool */
+    new_node = GET_NODE(ctx->node_mng, new_node_index);
   }
 
   return new_node;
 }
 
-static struct jes_node* jes_get_leaf(struct jes_context* ctx,
-                                     struct jes_node* parent)
+struct jes_node* jes_tree_insert_key_value(struct jes_context* ctx,
+                                           struct jes_node* key,
+                                           uint16_t type, uint16_t length, const char* value)
 {
-  struct jes_node* leaf = NULL;
-
-  assert(parent != NULL);
+  assert(NODE_TYPE(key) == JES_KEY);
+#ifdef JES_USE_MERGED_KEY_NODE
+  if (key->value_tlv.type != JES_UNKNOWN) {
+    /* A member holds exactly one value. */
+    ctx->status = JES_INVALID_OPERATION;
+    return NULL;
+  }
 
-  do {
-    leaf = GET_FIRST_CHILD(ctx->node_mng, parent);
-    parent = leaf;
-  } while (HAS_CHILD(parent));
+  jes_node_descriptor key_index = JES_NODE_INDEX(ctx->node_mng, key);
+  if (!jes_tree_set_element_value(ctx, &key->value_tlv, value)) {
+    return NULL;
+  }
+  key = GET_NODE(ctx->node_mng, key_index);
+  key->value_tlv.type = type;
+  key->value_tlv.length = length;
+  return key;
+#else
+  return jes_tree_insert_node(ctx, key, GET_LAST_CHILD(ctx->node_mng, key), type, length, value);
+#endif
+}
 
-  return leaf;
+void jes_tree_delete_key_value(struct jes_context* ctx, struct jes_node* key)
+{
+  assert(NODE_TYPE(key) == JES_KEY);
+#ifdef JES_USE_MERGED_KEY_NODE
+  /* Children of a member node belong to its container value. */
+  while (HAS_CHILD(key)) {
+    jes_tree_delete_node(ctx, GET_FIRST_CHILD(ctx->node_mng, key));
+  }
+  #ifdef JES_USE_COMPACT_NODE
+  jes_free_value(ctx, &key->value_tlv);
+  #endif
+  key->value_tlv.type = JES_UNKNOWN;
+  key->value_tlv.length = 0;
+#else
+  jes_tree_delete_node(ctx, GET_FIRST_CHILD(ctx->node_mng, key));
+#endif
 }
 
-static struct jes_node* jes_get_left_sibling(struct jes_context* ctx,
-                                             struct jes_node* node)
+struct jes_node* jes_tree_get_prev_sibling_node(struct jes_context* ctx,
+                                                struct jes_node* node)
 {
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+  assert(node != NULL);
+  return GET_PREV_SIBLING(ctx->node_mng, node);
+#else
   struct jes_node* prev_sibling = NULL;
   struct jes_node* parent = NULL;
   struct jes_node* iter = NULL;
@@ -278,109 +705,275 @@ static struct jes_node* jes_get_left_sibling(struct jes_context* ctx,
     }
   }
   return prev_sibling;
+#endif
 }
 
 /**
  * @brief Deletes a JSON node and all its children from the parse tree.
- *        Iterative bottom-up leaf removal.
+ *        The node is unlinked first, then its subtree is released in a single
+ *        iterative post-order pass that visits every node once.
  */
 void jes_tree_delete_node(struct jes_context* ctx, struct jes_node* node)
 {
-  struct jes_node* to_remove = NULL;
-  struct jes_node* parent = node;
+  struct jes_node* parent = NULL;
+  struct jes_node* iter = NULL;
+  struct jes_node* next = NULL;
+  size_t removed_keys = 0;
 
   if (node == NULL) {
     return;
   }
 
-  /* First phase: Delete all children */
-  while (true) {
-    to_remove = jes_get_leaf(ctx, parent);
+  /* First phase: Unlink the node from its parent and siblings */
+  parent = GET_PARENT(ctx->node_mng, node);
+  if (parent != NULL) {
+    struct jes_node* prev_sibling = jes_tree_get_prev_sibling_node(ctx, node);
+
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+    if (HAS_SIBLING(node)) {
+      ctx->node_mng.pool[node->sibling].prev_sibling = node->prev_sibling;
+    }
+#endif
 
-    if (to_remove == NULL) {
-      /* Current node has no leaves anymore. Move to its parent and repeat the cycle. */
+    if (prev_sibling) {
+      assert(prev_sibling->parent == JES_NODE_INDEX(ctx->node_mng, parent));
+      /* Node is not the first child of its parent */
+      prev_sibling->sibling = node->sibling;
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+      jes_tree_set_subtree_end(ctx, prev_sibling, node->subtree_end);
+#endif
 
-      if (parent == node) {
-        /* Reached the original node requested to be removed. break phase 1 and
-           proceed with phase 2. */
-        break;
+      if (parent->last_child == JES_NODE_INDEX(ctx->node_mng, node)) {
+        /* Node is the last child of its parent */
+        parent->last_child = JES_NODE_INDEX(ctx->node_mng, prev_sibling);
       }
-      /* Start traversing from node again */
-      parent = node;
-      continue;
+    }
+    else {
+      /* Node is the first child of its parent */
+      if (parent->last_child == parent->first_child) {
+        /* parent has only one single child */
+        parent->last_child = JES_INVALID_INDEX;
+      }
+      parent->first_child = node->sibling;
+    }
+#ifdef JES_USE_CHILD_COUNT
+    assert(parent->child_count > 0);
+    parent->child_count--;
+#endif
+    if (IS_CONTIGUOUS_ARRAY(parent) && (prev_sibling != NULL) && HAS_SIBLING(node)) {
+      /* Removing a value from the middle leaves a gap */
+      CLEAR_CONTIGUOUS_ARRAY(parent);
+    }
+#ifdef JES_ENABLE_ARRAY_INDEX
+    struct jes_array_index* array_index = jes_tree_find_array_index(&ctx->node_mng, parent);
+    if (array_index != NULL) {
+      if (!HAS_SIBLING(node)) {
+        array_index->size--;
+      }
+      else {
+        jes_tree_drop_array_index(&ctx->node_mng, array_index);
+      }
+    }
+#endif
+  }
+  else if (node == ctx->node_mng.root) {
+    ctx->node_mng.root = NULL;
+  }
+
+  /* Second phase: Release the subtree in post-order. Each leaf is popped from
+     its parent, so a parent becomes a leaf once its last child is released. */
+  iter = node;
+  while (iter != NULL) {
+    while (HAS_CHILD(iter)) {
+      iter = GET_FIRST_CHILD(ctx->node_mng, iter);
     }
 
-    /* Get parent before deleting the node */
-    parent = GET_PARENT(ctx->node_mng, to_remove);
-    if (parent == NULL) {
+    parent = GET_PARENT(ctx->node_mng, iter);
+    if (iter == node) {
+      next = NULL;
+    }
+    else if (parent == NULL) {
       ctx->status = JES_BROKEN_TREE;
       return;
     }
-
-    /* Detach node from its parent */
-    if (parent->first_child == parent->last_child) {
-      parent->last_child = JES_INVALID_INDEX;
+    else {
+      parent->first_child = iter->sibling;
+      next = HAS_SIBLING(iter) ? GET_SIBLING(ctx->node_mng, iter) : parent;
     }
-    parent->first_child = to_remove->sibling;
 
 #if defined(JES_ENABLE_PARSER_NODE_LOG)
-    JES_LOG_NODE("    - ", JES_NODE_INDEX(ctx->node_mng, to_remove),
-                  NODE_TYPE(to_remove),
-                  to_remove->json_tlv.length, to_remove->json_tlv.value,
-                  to_remove->parent, to_remove->sibling,
-                  to_remove->first_child, to_remove->last_child, "\n");
+    JES_LOG_NODE("    - ", JES_NODE_INDEX(ctx->node_mng, iter), NODE_TYPE(iter),
+                  iter->json_tlv.length, JES_ELEMENT_VALUE(ctx, &iter->json_tlv),
+                  iter->parent, iter->sibling, iter->first_child, iter->last_child, "\n");
 #endif
 
-    /* Remove key from hash table if applicable */
-    if (JES_SEARCH_HASHED == ctx->mode) {
-      if (NODE_TYPE(to_remove) == JES_KEY) {
+    /* Remove keys from the hash table. Large subtrees are removed in a batch
+       by a single sweep of the table after all nodes are released. The deleted
+       node itself is always removed, its object lives on. */
+    if ((JES_SEARCH_HASHED == ctx->mode) && (NODE_TYPE(iter) == JES_KEY)) {
+      if ((removed_keys < JES_HASH_TABLE_SWEEP_THRESHOLD(ctx->hash_table)) || (iter == node)) {
         assert(ctx->hash_table.remove_fn != NULL);
-        ctx->hash_table.remove_fn(ctx, parent, to_remove);
+        ctx->hash_table.remove_fn(ctx, parent, iter);
       }
+      removed_keys++;
     }
 
-    jes_free(ctx, to_remove);
+    jes_free(ctx, iter);
+    iter = next;
   }
 
-  /* Second phase: Delete the original node and update parent references */
-  parent = GET_PARENT(ctx->node_mng, node);
-  if (parent != NULL) {
-    struct jes_node* prev_sibling = jes_get_left_sibling(ctx, node);
+  if (removed_keys > JES_HASH_TABLE_SWEEP_THRESHOLD(ctx->hash_table)) {
+    jes_hash_table_remove_released_keys(ctx);
+  }
+}
 
-    if (prev_sibling) {
-      assert(prev_sibling->parent == JES_NODE_INDEX(ctx->node_mng, parent));
-      /* Node is not the first child of its parent */
-      prev_sibling->sibling = node->sibling;
+#ifdef JES_USE_COMPACT_NODE
+/* Assigns the next position of the compacted pool to the holder of an external value. */
+static void jes_tree_compact_value(struct jes_context* ctx, struct jes_element* element, jes_node_descriptor* position)
+{
+  struct jes_node* holder = NULL;
+
+  if (JES_HAS_EXTERNAL_VALUE(element)) {
+    holder = &ctx->node_mng.pool[element->offset & ~JES_EXTERNAL_VALUE];
+    /* A holder is not linked to the tree. Its descriptors follow the value pointer. */
+    holder->parent = JES_INVALID_INDEX;
+    holder->sibling = JES_INVALID_INDEX;
+    holder->first_child = JES_INVALID_INDEX;
+    holder->last_child = *position;
+    element->offset = JES_EXTERNAL_VALUE | *position;
+    (*position)++;
+    ctx->node_mng.value_holder_count++;
+  }
+}
+#endif
 
-      if (parent->last_child == JES_NODE_INDEX(ctx->node_mng, node)) {
-        /* Node is the last child of its parent */
-        parent->last_child = JES_NODE_INDEX(ctx->node_mng, prev_sibling);
-      }
+/**
+ * @brief Rewrites the node pool in pre-order and drops the free list.
+ *
+ *        The compaction runs in place without extra memory. The last_child
+ *        descriptor of each node temporarily keeps its new position:
+ *        1. Number the nodes in pre-order (holder nodes follow their owner).
+ *        2. Translate the parent, sibling and first child descriptors.
+ *        3. Move each node to its position by cycles of swaps.
+ *        4. Rebuild the last child and the optional descriptors in a single
+ *           forward pass.
+ *        5. Re-add the keys to the hash table. A failure leaves a consistent
+ *           tree and is reported once all nodes are relinked.
+ *        Nodes that are not reachable from the root are released.
+ */
+jes_status jes_tree_compact(struct jes_context* ctx)
+{
+  struct jes_node_mng_context* mng_ctx = &ctx->node_mng;
+  struct jes_node* iter = NULL;
+  struct jes_node* parent = NULL;
+  struct jes_node temp;
+  jes_node_descriptor position = 0;
+  jes_node_descriptor index;
+  jes_node_descriptor target;
+
+  for (index = 0; index < mng_ctx->next_free; index++) {
+    mng_ctx->pool[index].last_child = JES_INVALID_INDEX;
+  }
+  mng_ctx->value_holder_count = 0;
+
+  /* First phase: number the nodes in pre-order */
+  iter = mng_ctx->root;
+  while (iter != NULL) {
+    iter->last_child = position++;
+#ifdef JES_USE_COMPACT_NODE
+    jes_tree_compact_value(ctx, &iter->json_tlv, &position);
+  #ifdef JES_USE_MERGED_KEY_NODE
+    jes_tree_compact_value(ctx, &iter->value_tlv, &position);
+  #endif
+#endif
+    if (HAS_CHILD(iter)) {
+      iter = GET_FIRST_CHILD(ctx->node_mng, iter);
     }
     else {
-      /* Node is the first child of its parent */
-      if (parent->last_child == parent->first_child) {
-        /* parent has only one single child */
-        parent->last_child = JES_INVALID_INDEX;
+      while ((iter != NULL) && !HAS_SIBLING(iter)) {
+        iter = GET_PARENT(ctx->node_mng, iter);
       }
-      parent->first_child = node->sibling;
+      iter = GET_SIBLING(ctx->node_mng, iter);
     }
   }
 
-#if defined(JES_ENABLE_PARSER_NODE_LOG)
-  JES_LOG_NODE("    - ", JES_NODE_INDEX(ctx->node_mng, node), NODE_TYPE(node),
-                node->json_tlv.length, node->json_tlv.value,
-                node->parent, node->sibling, node->first_child, node->last_child, "\n");
+  /* Second phase: translate the descriptors to the new positions */
+#define JES_COMPACT_POSITION(descriptor_) \
+  (((descriptor_) < JES_INVALID_INDEX) ? mng_ctx->pool[(descriptor_)].last_child : JES_INVALID_INDEX)
+
+  for (index = 0; index < mng_ctx->next_free; index++) {
+    iter = &mng_ctx->pool[index];
+    if (iter->last_child < JES_INVALID_INDEX) {
+      iter->parent = JES_COMPACT_POSITION(iter->parent);
+      iter->sibling = JES_COMPACT_POSITION(iter->sibling);
+      iter->first_child = JES_COMPACT_POSITION(iter->first_child);
+    }
+  }
+#undef JES_COMPACT_POSITION
+
+  /* Third phase: move the nodes. Each swap places one node at its final position. */
+  for (index = 0; index < mng_ctx->next_free; index++) {
+    target = mng_ctx->pool[index].last_child;
+    while ((target < JES_INVALID_INDEX) && (target != index)) {
+      temp = mng_ctx->pool[target];
+      mng_ctx->pool[target] = mng_ctx->pool[index];
+      mng_ctx->pool[index] = temp;
+      target = mng_ctx->pool[index].last_child;
+    }
+  }
+
+  mng_ctx->node_count = position;
+  mng_ctx->next_free = position;
+  mng_ctx->freed = NULL;
+  mng_ctx->root = position > 0 ? &mng_ctx->pool[0] : NULL;
+  /* The internal iterator may refer to a moved node. */
+  ctx->serdes.iter = NULL;
+#ifdef JES_ENABLE_ARRAY_INDEX
+  mng_ctx->array_index_count = 0;
 #endif
-  /* Remove from hash table if it's a key */
-  if (JES_SEARCH_HASHED == ctx->mode) {
-    if (NODE_TYPE(node) == JES_KEY) {
-      assert(ctx->hash_table.remove_fn != NULL);
-      ctx->hash_table.remove_fn(ctx, parent, node);
+
+  /* Fourth phase: children follow their parent, so the last child assigned to
+     a parent is its actual last child. */
+  for (index = 0; index < position; index++) {
+    iter = &mng_ctx->pool[index];
+    iter->last_child = JES_INVALID_INDEX;
+    if (((index == 0) || HAS_PARENT(iter)) && (NODE_VALUE_TYPE(iter) == JES_ARRAY)) {
+      /* The root or a tree node, holder nodes keep a pointer instead of an
+         element. Cleared again below if a nested container splits the values. */
+      SET_CONTIGUOUS_ARRAY(iter);
+    }
+    parent = GET_PARENT(ctx->node_mng, iter);
+    if (parent == NULL) {
+      /* The root or a holder node */
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+      iter->prev_sibling = JES_INVALID_INDEX;
+#endif
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+      iter->subtree_end = JES_INVALID_INDEX;
+#endif
+      continue;
+    }
+#ifdef JES_USE_PREV_SIBLING_DESCRIPTOR
+    iter->prev_sibling = parent->last_child;
+#endif
+#ifdef JES_USE_SUBTREE_END_DESCRIPTOR
+    iter->subtree_end = HAS_SIBLING(iter) ? iter->sibling : parent->subtree_end;
+#endif
+    if (IS_CONTIGUOUS_ARRAY(parent) && (parent->last_child < JES_INVALID_INDEX) && (parent->last_child + 1 != index)) {
+      /* Nested containers place their own values between the array values */
+      CLEAR_CONTIGUOUS_ARRAY(parent);
     }
+    parent->last_child = index;
+  }
+
+  /* Fifth phase: keys are hashed with the index of their parent, so the table
+     is rebuilt from the relinked tree. */
+  if (JES_SEARCH_HASHED == ctx->mode) {
+    return jes_hash_table_rehash(ctx);
   }
 
-  jes_free(ctx, node);
+  ctx->status = JES_NO_ERROR;
+  return ctx->status;
 }
 
 static struct jes_node* jes_tree_find_key(struct jes_context* ctx,
@@ -393,8 +986,9 @@ static struct jes_node* jes_tree_find_key(struct jes_context* ctx,
 
   assert(parent_object != NULL);
 
-  if (NODE_TYPE(parent_object) != JES_OBJECT) {
-    ctx->status = JES_UNEXPECTED_ELEMENT;
+  if (NODE_VALUE_TYPE(parent_object) != JES_OBJECT) {
+    /* Only objects have keys. The caller reports the miss, lookups on a
+       frozen context must not write to it. */
     return NULL;
   }
 
@@ -402,7 +996,7 @@ static struct jes_node* jes_tree_find_key(struct jes_context* ctx,
 
   while ((iter != NULL) && (NODE_TYPE(iter) == JES_KEY)) {
     if ((iter->json_tlv.length == keyword_length) &&
-        (memcmp(iter->json_tlv.value, keyword, keyword_length) == 0)) {
+        (memcmp(JES_ELEMENT_VALUE(ctx, &iter->json_tlv), keyword, keyword_length) == 0)) {
       key = iter;
       break;
     }
@@ -416,7 +1010,14 @@ jes_status jes_tree_resize(struct jes_node_mng_context* ctx, void *buffer, size_
 {
   ctx->pool = buffer;
   ctx->size = buffer_size;
+#ifdef JES_ENABLE_ARRAY_INDEX
+  /* The array index table ends at the end of the pool. Nodes move with the pool, so all indexes are dropped. */
+  ctx->array_index = (jes_node_descriptor*)(((uintptr_t)buffer + buffer_size) & ~(uintptr_t)(sizeof(jes_node_descriptor) - 1));
+  ctx->array_index_count = 0;
+#endif
 
+  /* Cap capacity to JES_INVALID_INDEX - 1 to ensure node index JES_INVALID_INDEX
+     remains available as a sentinel value meaning "no node". */
   ctx->capacity = (ctx->size / sizeof(struct jes_node)) < JES_INVALID_INDEX
                 ? ctx->size / sizeof(struct jes_node)
                 : JES_INVALID_INDEX -1;
@@ -427,9 +1028,13 @@ jes_status jes_tree_resize(struct jes_node_mng_context* ctx, void *buffer, size_
 void jes_tree_reset(struct jes_node_mng_context* ctx)
 {
   ctx->node_count = 0;
+  ctx->value_holder_count = 0;
   ctx->next_free = 0;
   ctx->freed = NULL;
   ctx->root = NULL;
+#ifdef JES_ENABLE_ARRAY_INDEX
+  ctx->array_index_count = 0;
+#endif
 }
 
 jes_status jes_tree_init(struct jes_context* ctx, void *buffer, size_t buffer_size)
@@ -445,14 +1050,5 @@ jes_status jes_tree_init(struct jes_context* ctx, void *buffer, size_t buffer_si
     ctx->node_mng.find_key_fn = jes_hash_table_find_key;
   }
 
-  ctx->node_mng.pool = buffer;
-  ctx->node_mng.size = buffer_size;
-
-  /* Cap capacity to JES_INVALID_INDEX - 1 to ensure node index JES_INVALID_INDEX
-     remains available as a sentinel value meaning "no node". */
-  ctx->node_mng.capacity = (ctx->node_mng.size / sizeof(struct jes_node)) < JES_INVALID_INDEX
-                         ? ctx->node_mng.size / sizeof(struct jes_node)
-                         : JES_INVALID_INDEX - 1;
-
-  return ctx->node_mng.capacity == 0 ? JES_BUFFER_TOO_SMALL : JES_NO_ERROR;
+  return jes_tree_resize(mng_ctx, buffer, buffer_size);
 }
@@ -6,6 +6,24 @@ jes_status jes_tree_resize(struct jes_node_mng_context* ctx, void *buffer, size_
 
 bool jes_validate_node(struct jes_context* ctx, struct jes_node* node);
 
+/**
+ * @brief Resolves an element provided through the API to the node holding it.
+ *
+ * In merged key node mode, the value element of an object member resolves to
+ * its key node. Returns NULL if the element is not a valid part of the tree.
+ */
+struct jes_node* jes_tree_get_element_node(struct jes_context* ctx, struct jes_element* element);
+
+/**
+ * @brief Sets the value pointer of an element.
+ *
+ * In compact node mode, values outside the loaded JSON data are kept in an
+ * extra node. Returns false if such a node can not be allocated. The
+ * allocation may move a growable pool, so callers keep node descriptors
+ * instead of pointers across the call.
+ */
+bool jes_tree_set_element_value(struct jes_context* ctx, struct jes_element* element, const char* value);
+
 struct jes_node* jes_tree_insert_node(struct jes_context* ctx,
                                       struct jes_node* parent, struct jes_node* anchor,
                                       uint16_t type, uint16_t length, const char* value);
@@ -17,6 +35,27 @@ struct jes_node* jes_tree_insert_key_node(struct jes_context* ctx,
 
 void jes_tree_delete_node(struct jes_context* ctx, struct jes_node* node);
 
+/**
+ * @brief Moves all nodes to the start of the pool in pre-order and clears the
+ *        free list. Node descriptors and the hash table are updated accordingly.
+ */
+jes_status jes_tree_compact(struct jes_context* ctx);
+
+/**
+ * @brief Assigns a value to a key and returns the node representing the value.
+ *
+ * The value is a child node of the key, or the key node itself in merged key
+ * node mode.
+ */
+struct jes_node* jes_tree_insert_key_value(struct jes_context* ctx,
+                                           struct jes_node* key,
+                                           uint16_t type, uint16_t length, const char* value);
+
+/**
+ * @brief Deletes the value of a key and all its children.
+ */
+void jes_tree_delete_key_value(struct jes_context* ctx, struct jes_node* key);
+
 /**
  * @brief Finds the nearest parent node of a specific type in the JSON tree.
  *
@@ -43,7 +82,42 @@ struct jes_node* jes_tree_get_parent_node(struct jes_context* ctx,
 struct jes_node* jes_tree_get_child_node(struct jes_context* ctx,
                                           struct jes_node* node);
 
+/**
+ * @brief Returns the first node after the subtree of a node in pre-order.
+ *
+ * Takes a single jump when JES_USE_SUBTREE_END_DESCRIPTOR is enabled, otherwise
+ * walks up the parent chain. Returns NULL if the subtree reaches the end of the tree.
+ */
+struct jes_node* jes_tree_get_subtree_end_node(struct jes_context* ctx,
+                                               struct jes_node* node);
+
 struct jes_node* jes_tree_get_sibling_node(struct jes_context* ctx,
                                           struct jes_node* node);
 
+/**
+ * @brief Returns the sibling on the left side of a node.
+ *
+ * Constant-time with JES_USE_PREV_SIBLING_DESCRIPTOR, otherwise the branch is
+ * walked from the first child of the parent.
+ */
+struct jes_node* jes_tree_get_prev_sibling_node(struct jes_context* ctx,
+                                                struct jes_node* node);
+
+/**
+ * @brief Returns the number of children of a node.
+ *
+ * Constant-time with JES_USE_CHILD_COUNT, otherwise the children are counted.
+ */
+size_t jes_tree_get_child_count(struct jes_context* ctx,
+                                struct jes_node* node);
+
+/**
+ * @brief Returns the child of a node at the given position, or NULL.
+ *
+ * Uses the array index with JES_ENABLE_ARRAY_INDEX, otherwise the children
+ * are walked from the first child.
+ */
+struct jes_node* jes_tree_get_child_node_at(struct jes_context* ctx,
+                                            struct jes_node* node, size_t index);
+
 #endif
\ No newline at end of file
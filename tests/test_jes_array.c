@@ -0,0 +1,506 @@
+/**
+ * jes_array_test.c
+ *
+ * Tests for the array JES API functions:
+ *
+ *   jes_get_array_size(), jes_get_array_value(), jes_append_array_value(),
+ *   jes_add_array_value(), jes_update_array_value()
+ *
+ * Groups:
+ *   1. Array size after parsing  — empty, flat, nested and member arrays
+ *   2. Array size through edits  — append, insert, update and delete keep the
+ *                                  size in line with the actual elements
+ *                                  (see JES_USE_CHILD_COUNT)
+ *   3. Index access              — positive, negative and out-of-bound indices
+ *   4. Array size after compact  — jes_compact() keeps the sizes
+ *   5. Large array access        — every index resolves to the right element
+ *                                  through appends, inserts and deletes
+ *                                  (see JES_ENABLE_ARRAY_INDEX). With the
+ *                                  index, an indexed loop and interleaved loops
+ *                                  over two arrays have a CPU time budget.
+ *   6. Contiguous arrays         — index access on parsed arrays stays right
+ *                                  after edits that break the back to back
+ *                                  layout of the values, and after jes_compact()
+ *
+ * Checking every index walks the array for each index without
+ * JES_ENABLE_ARRAY_INDEX, so the large array is smaller in that case.
+ *
+ * Build (from repo root):
+ *   gcc jes_array_test.c src/jes.c src/jes_tokenizer.c src/jes_parser.c \
+ *       src/jes_serializer.c src/jes_tree.c src/jes_hash_table.c \
+ *       src/jes_logger.c -std=c99 -DNDEBUG -o jes_array_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "../src/jes.h"
+
+/* =========================================================================
+ * Harness
+ * ========================================================================= */
+
+static int g_passed = 0;
+static int g_failed = 0;
+
+static void pass(const char *id) { printf("  [PASS] %s\n", id); g_passed++; }
+static void fail(const char *id, const char *reason)
+{
+    printf("  [FAIL] %s — %s\n", id, reason); g_failed++;
+}
+
+#define CHECK(id, cond) \
+    do { if (cond) pass(id); else fail(id, #cond " was false"); } while(0)
+
+#define CHECK_NULL(id, ptr) \
+    do { if ((ptr) == NULL) pass(id); else fail(id, "expected NULL, got non-NULL"); } while(0)
+
+/* =========================================================================
+ * Workspace helpers
+ * ========================================================================= */
+
+static uint8_t g_ws[JES_REQUIRED_SIZE(128)];
+
+static struct jes_context *load(const char *json, enum jes_search_mode mode)
+{
+    struct jes_context *ctx = jes_init(g_ws, sizeof(g_ws), mode);
+    if (!ctx) return NULL;
+    return jes_load(ctx, json, strlen(json)) == JES_NO_ERROR ? ctx : NULL;
+}
+
+static int renders_as(struct jes_context *ctx, const char *expected)
+{
+    char out[2048];
+    size_t len = jes_render(ctx, out, sizeof(out), true);
+    /* The rendered length includes the NUL terminator */
+    return (len > 0) && (strcmp(out, expected) == 0);
+}
+
+/* Counts the array elements through the navigation API */
+static size_t count_values(struct jes_context *ctx, struct jes_element *array)
+{
+    size_t count = 0;
+    struct jes_element *iter;
+    for (iter = jes_get_child(ctx, array); iter != NULL; iter = jes_get_sibling(ctx, iter)) {
+        count++;
+    }
+    return count;
+}
+
+/* The reported size must match the actual elements */
+static int size_is(struct jes_context *ctx, struct jes_element *array, size_t expected)
+{
+    return (jes_get_array_size(ctx, array) == expected) && (count_values(ctx, array) == expected);
+}
+
+/* =========================================================================
+ * Group 1 — Array size after parsing
+ * ========================================================================= */
+
+static void test_size_after_parse(void)
+{
+    printf("\nGroup 1: array size after parsing\n");
+
+    struct jes_context *ctx = load("[]", JES_SEARCH_LINEAR);
+    CHECK("G1-01 empty array", ctx && size_is(ctx, jes_get_root(ctx), 0));
+
+    ctx = load("[1,\"a\",true,null,{},[]]", JES_SEARCH_LINEAR);
+    CHECK("G1-02 flat array", ctx && size_is(ctx, jes_get_root(ctx), 6));
+
+    ctx = load("[[1,2,3],[[]],{\"a\":[4,5]}]", JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G1-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    CHECK("G1-03 outer array", size_is(ctx, root, 3));
+    CHECK("G1-04 nested array", size_is(ctx, jes_get_array_value(ctx, root, 0), 3));
+    CHECK("G1-05 array of an empty array", size_is(ctx, jes_get_array_value(ctx, root, 1), 1));
+    CHECK("G1-06 member array",
+          size_is(ctx, jes_get_value(ctx, jes_get_array_value(ctx, root, 2), "a"), 2));
+
+    CHECK("G1-07 object is not an array", jes_get_array_size(ctx, jes_get_array_value(ctx, root, 2)) == 0 &&
+                                          jes_get_status(ctx) == JES_INVALID_PARAMETER);
+}
+
+/* =========================================================================
+ * Group 2 — Array size through edits
+ * ========================================================================= */
+
+static void test_size_through_edits(enum jes_search_mode mode)
+{
+    printf("\nGroup 2: array size through edits (%s)\n",
+           mode == JES_SEARCH_HASHED ? "hashed" : "linear");
+
+    struct jes_context *ctx = load("{\"a\":[1,2],\"b\":[[3,4]]}", mode);
+    if (!ctx) { fail("G2-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    struct jes_element *a = jes_get_value(ctx, root, "a");
+    struct jes_element *b = jes_get_value(ctx, root, "b");
+
+    jes_append_array_value(ctx, a, JES_NUMBER, "3", 1);
+    CHECK("G2-01 append", size_is(ctx, a, 3) && renders_as(ctx, "{\"a\":[1,2,3],\"b\":[[3,4]]}"));
+
+    jes_add_array_value(ctx, a, 0, JES_NUMBER, "0", 1);
+    CHECK("G2-02 prepend", size_is(ctx, a, 4) && renders_as(ctx, "{\"a\":[0,1,2,3],\"b\":[[3,4]]}"));
+
+    jes_add_array_value(ctx, a, -1, JES_TRUE, "true", 4);
+    CHECK("G2-03 insert from the end", size_is(ctx, a, 5) && renders_as(ctx, "{\"a\":[0,1,2,true,3],\"b\":[[3,4]]}"));
+
+    jes_add_array_value(ctx, a, 100, JES_NULL, "null", 4);
+    CHECK("G2-04 out of bound index appends", size_is(ctx, a, 6) && renders_as(ctx, "{\"a\":[0,1,2,true,3,null],\"b\":[[3,4]]}"));
+
+    jes_update_array_value(ctx, b, 0, JES_NUMBER, "5", 1);
+    CHECK("G2-05 update replaces a nested array", size_is(ctx, b, 1) && renders_as(ctx, "{\"a\":[0,1,2,true,3,null],\"b\":[5]}"));
+
+    jes_delete_element(ctx, jes_get_array_value(ctx, a, 0));
+    jes_delete_element(ctx, jes_get_array_value(ctx, a, -1));
+    jes_delete_element(ctx, jes_get_array_value(ctx, a, 2));
+    CHECK("G2-06 delete first, last and middle", size_is(ctx, a, 3) && renders_as(ctx, "{\"a\":[1,2,3],\"b\":[5]}"));
+
+    jes_delete_element(ctx, jes_get_array_value(ctx, b, 0));
+    CHECK("G2-07 delete the only value", size_is(ctx, b, 0) && renders_as(ctx, "{\"a\":[1,2,3],\"b\":[]}"));
+
+    jes_append_array_value(ctx, b, JES_NUMBER, "6", 1);
+    CHECK("G2-08 append to an emptied array", size_is(ctx, b, 1));
+
+    /* A key value replaced by a new array starts empty */
+    jes_update_key_value_to_array(ctx, jes_get_key(ctx, root, "a"));
+    a = jes_get_value(ctx, root, "a");
+    CHECK("G2-09 new array is empty", size_is(ctx, a, 0));
+    jes_append_array_value(ctx, a, JES_NUMBER, "7", 1);
+    jes_append_array_value(ctx, a, JES_NUMBER, "8", 1);
+    CHECK("G2-10 new array grows", size_is(ctx, a, 2) && renders_as(ctx, "{\"a\":[7,8],\"b\":[6]}"));
+}
+
+/* =========================================================================
+ * Group 3 — Index access
+ * ========================================================================= */
+
+static void test_index_access(void)
+{
+    printf("\nGroup 3: index access\n");
+
+    struct jes_context *ctx = load("[10,20,30]", JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G3-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+
+    CHECK("G3-01 first", jes_get_array_value(ctx, root, 0) == jes_get_child(ctx, root));
+    CHECK("G3-02 last by negative index",
+          jes_get_array_value(ctx, root, -1) == jes_get_sibling(ctx, jes_get_array_value(ctx, root, 1)));
+    CHECK("G3-03 first by negative index", jes_get_array_value(ctx, root, -3) == jes_get_child(ctx, root));
+    CHECK_NULL("G3-04 index past the end", jes_get_array_value(ctx, root, 3));
+    CHECK("G3-05 status", jes_get_status(ctx) == JES_ELEMENT_NOT_FOUND);
+    CHECK_NULL("G3-06 negative index past the start", jes_get_array_value(ctx, root, -4));
+    CHECK_NULL("G3-07 update past the end", jes_update_array_value(ctx, root, 4, JES_NUMBER, "1", 1));
+}
+
+/* =========================================================================
+ * Group 4 — Array size after compact
+ * ========================================================================= */
+
+static void test_size_after_compact(void)
+{
+    printf("\nGroup 4: array size after compact\n");
+
+    struct jes_context *ctx = load("[[1,2],[3]]", JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G4-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+
+    jes_delete_element(ctx, jes_get_array_value(ctx, root, 0));
+    jes_append_array_value(ctx, jes_get_array_value(ctx, root, 0), JES_NUMBER, "4", 1);
+    jes_append_array_value(ctx, root, JES_ARRAY, "[", 1);
+
+    CHECK("G4-01 compact succeeds", jes_compact(ctx) == JES_NO_ERROR);
+    root = jes_get_root(ctx);
+    CHECK("G4-02 outer array", size_is(ctx, root, 2));
+    CHECK("G4-03 edited array", size_is(ctx, jes_get_array_value(ctx, root, 0), 2));
+    CHECK("G4-04 appended array", size_is(ctx, jes_get_array_value(ctx, root, 1), 0));
+    CHECK("G4-05 renders", renders_as(ctx, "[[3,4],[]]"));
+}
+
+/* =========================================================================
+ * Group 5 — Large array access
+ * ========================================================================= */
+
+#ifdef JES_ENABLE_ARRAY_INDEX
+#define LARGE_ARRAY_SIZE 20000
+#else
+#define LARGE_ARRAY_SIZE 2000
+#endif
+/* A quadratic indexed loop over the array takes seconds */
+#define INDEXED_LOOP_BUDGET_SEC 0.1
+
+/* Leaves room for the array index at the end of the node pool */
+static uint8_t g_large_ws[JES_REQUIRED_SIZE((LARGE_ARRAY_SIZE * 2))];
+static char g_large_json[LARGE_ARRAY_SIZE * 6 + 2];
+
+/* Compares jes_get_array_value() at every index with a walk of the array */
+static int all_indices_match(struct jes_context *ctx, struct jes_element *array)
+{
+    size_t size = jes_get_array_size(ctx, array);
+    size_t i = 0;
+    struct jes_element *iter;
+
+    for (iter = jes_get_child(ctx, array); iter != NULL; iter = jes_get_sibling(ctx, iter), i++) {
+        if (jes_get_array_value(ctx, array, (int32_t)i) != iter) return 0;
+        if (jes_get_array_value(ctx, array, (int32_t)i - (int32_t)size) != iter) return 0;
+    }
+    return (i == size) && (jes_get_array_value(ctx, array, (int32_t)size) == NULL);
+}
+
+static void test_large_array_access(void)
+{
+    printf("\nGroup 5: large array access\n");
+
+    size_t pos = 0;
+    int i;
+
+    pos += sprintf(&g_large_json[pos], "[");
+    for (i = 0; i < LARGE_ARRAY_SIZE; i++) {
+        pos += sprintf(&g_large_json[pos], "%s%d", i ? "," : "", i % 1000);
+    }
+    pos += sprintf(&g_large_json[pos], "]");
+
+    struct jes_context *ctx = jes_init(g_large_ws, sizeof(g_large_ws), JES_SEARCH_LINEAR);
+    if (!ctx || jes_load(ctx, g_large_json, pos) != JES_NO_ERROR) { fail("G5-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+
+#ifdef JES_ENABLE_ARRAY_INDEX
+    {
+        clock_t start = clock();
+        size_t found = 0;
+        for (i = 0; i < LARGE_ARRAY_SIZE; i++) {
+            if (jes_get_array_value(ctx, root, i) != NULL) found++;
+        }
+        double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+        CHECK("G5-01 indexed loop finds every value", found == LARGE_ARRAY_SIZE);
+        CHECK("G5-02 indexed loop within budget", elapsed < INDEXED_LOOP_BUDGET_SEC);
+    }
+#endif
+
+    CHECK("G5-03 every index after parse", all_indices_match(ctx, root));
+
+    jes_append_array_value(ctx, root, JES_TRUE, "true", 4);
+    jes_append_array_value(ctx, root, JES_NULL, "null", 4);
+    CHECK("G5-04 every index after append", all_indices_match(ctx, root));
+
+    jes_delete_element(ctx, jes_get_array_value(ctx, root, -1));
+    CHECK("G5-05 every index after deleting the last value", all_indices_match(ctx, root));
+
+    jes_add_array_value(ctx, root, 100, JES_FALSE, "false", 5);
+    CHECK("G5-06 every index after insert", all_indices_match(ctx, root) &&
+                                            jes_get_array_value(ctx, root, 100)->type == JES_FALSE);
+
+    jes_delete_element(ctx, jes_get_array_value(ctx, root, 50));
+    jes_update_array_value(ctx, root, 60, JES_ARRAY, "[", 1);
+    jes_append_array_value(ctx, jes_get_array_value(ctx, root, 60), JES_NUMBER, "1", 1);
+    CHECK("G5-07 every index after delete and update", all_indices_match(ctx, root) &&
+                                                       jes_get_array_size(ctx, root) == LARGE_ARRAY_SIZE + 1);
+
+    /* Nodes allocated after the last free node use the memory of a large index */
+    struct jes_element *nested = jes_get_array_value(ctx, root, 60);
+    for (i = 0; i < 40; i++) {
+        jes_append_array_value(ctx, nested, JES_NUMBER, "2", 1);
+    }
+    CHECK("G5-08 every index after many allocations", all_indices_match(ctx, root) &&
+                                                      all_indices_match(ctx, nested));
+
+    jes_delete_element(ctx, nested);
+    CHECK("G5-09 every index after deleting a nested array", all_indices_match(ctx, root));
+
+    /* Appending until the pool is full takes the memory of the index */
+    pos = 0;
+    pos += sprintf(&g_large_json[pos], "[");
+    for (i = 0; i < 100; i++) {
+        pos += sprintf(&g_large_json[pos], "%s%d", i ? "," : "", i);
+    }
+    pos += sprintf(&g_large_json[pos], "]");
+    ctx = jes_init(g_ws, sizeof(g_ws), JES_SEARCH_LINEAR);
+    if (!ctx || jes_load(ctx, g_large_json, pos) != JES_NO_ERROR) { fail("G5-setup", "load failed"); return; }
+    root = jes_get_root(ctx);
+    int matches = all_indices_match(ctx, root);
+    while (jes_append_array_value(ctx, root, JES_NUMBER, "1", 1) != NULL) {
+        matches = matches && all_indices_match(ctx, root);
+    }
+    CHECK("G5-10 every index until the pool is full", matches && jes_get_array_size(ctx, root) > 100);
+
+    /* Interleaved loops over two arrays whose values are not back to back */
+    pos = 0;
+    pos += sprintf(&g_large_json[pos], "{\"a\":[");
+    for (i = 0; i < LARGE_ARRAY_SIZE / 2; i++) {
+        pos += sprintf(&g_large_json[pos], "%s%d", i ? "," : "", i % 1000);
+    }
+    pos += sprintf(&g_large_json[pos], "],\"b\":[");
+    for (i = 0; i < LARGE_ARRAY_SIZE / 2; i++) {
+        pos += sprintf(&g_large_json[pos], "%s%d", i ? "," : "", i % 1000);
+    }
+    pos += sprintf(&g_large_json[pos], "]}");
+    ctx = jes_init(g_large_ws, sizeof(g_large_ws), JES_SEARCH_LINEAR);
+    if (!ctx || jes_load(ctx, g_large_json, pos) != JES_NO_ERROR) { fail("G5-setup", "load failed"); return; }
+    root = jes_get_root(ctx);
+    struct jes_element *a = jes_get_value(ctx, root, "a");
+    struct jes_element *b = jes_get_value(ctx, root, "b");
+    jes_add_array_value(ctx, a, 1, JES_TRUE, "true", 4);
+    jes_add_array_value(ctx, b, 1, JES_TRUE, "true", 4);
+
+#ifdef JES_ENABLE_ARRAY_INDEX
+    {
+        clock_t start = clock();
+        size_t found = 0;
+        for (i = 0; i <= LARGE_ARRAY_SIZE / 2; i++) {
+            if (jes_get_array_value(ctx, a, i) != NULL) found++;
+            if (jes_get_array_value(ctx, b, i) != NULL) found++;
+        }
+        double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+        CHECK("G5-11 interleaved loop finds every value", found == LARGE_ARRAY_SIZE + 2);
+        /* A single slot is rebuilt on every access of the loop */
+        CHECK("G5-12 interleaved loop within budget", (JES_ARRAY_INDEX_SLOTS < 2) || (elapsed < INDEXED_LOOP_BUDGET_SEC));
+    }
+#endif
+
+    /* Appending to the older of two indexed arrays drops its index, the newer one grows */
+    jes_append_array_value(ctx, a, JES_NULL, "null", 4);
+    jes_append_array_value(ctx, b, JES_NULL, "null", 4);
+    CHECK("G5-13 every index after appending to both", all_indices_match(ctx, a) && all_indices_match(ctx, b));
+    /* Deleting in the middle of the older array moves the table of the newer one */
+    jes_get_array_value(ctx, b, -1);
+    jes_delete_element(ctx, jes_get_array_value(ctx, a, 20));
+    CHECK("G5-14 every index after deleting in the middle", all_indices_match(ctx, b) && all_indices_match(ctx, a) &&
+                                                            jes_get_array_size(ctx, a) == LARGE_ARRAY_SIZE / 2 + 1);
+
+    /* More interleaved arrays than indexes */
+    const char *arrays_json = "{\"a\":[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19],"
+                              "\"b\":[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19],"
+                              "\"c\":[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19],"
+                              "\"d\":[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19],"
+                              "\"e\":[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19],"
+                              "\"f\":[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19]}";
+    ctx = jes_init(g_large_ws, sizeof(g_large_ws), JES_SEARCH_LINEAR);
+    if (!ctx || jes_load(ctx, arrays_json, strlen(arrays_json)) != JES_NO_ERROR) { fail("G5-setup", "load failed"); return; }
+    root = jes_get_root(ctx);
+    struct jes_element *arrays[6];
+    for (i = 0; i < 6; i++) {
+        char name[2] = { (char)('a' + i), '\0' };
+        arrays[i] = jes_get_value(ctx, root, name);
+        jes_add_array_value(ctx, arrays[i], 0, JES_NUMBER, "-1", 2);
+    }
+    matches = 1;
+    for (i = 17; i <= 20; i++) {
+        int j;
+        for (j = 0; j < 6; j++) {
+            struct jes_element *value = jes_get_child(ctx, arrays[j]);
+            int k;
+            for (k = 0; k < i && value != NULL; k++) value = jes_get_sibling(ctx, value);
+            matches = matches && (jes_get_array_value(ctx, arrays[j], i) == value);
+        }
+        jes_delete_element(ctx, jes_get_array_value(ctx, arrays[i % 6], 5));
+        matches = matches && all_indices_match(ctx, arrays[i % 6]);
+    }
+    for (i = 0; i < 6; i++) {
+        matches = matches && all_indices_match(ctx, arrays[i]);
+    }
+    CHECK("G5-15 every index over interleaved arrays", matches);
+}
+
+/* =========================================================================
+ * Group 6 — Contiguous arrays
+ * ========================================================================= */
+
+static void test_contiguous_arrays(void)
+{
+    printf("\nGroup 6: contiguous arrays\n");
+
+    struct jes_context *ctx = load("[1,2,3,4,5]", JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G6-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    CHECK("G6-01 parsed flat array", all_indices_match(ctx, root) && size_is(ctx, root, 5));
+
+    jes_delete_element(ctx, jes_get_array_value(ctx, root, 0));
+    jes_delete_element(ctx, jes_get_array_value(ctx, root, -1));
+    CHECK("G6-02 delete at both ends", all_indices_match(ctx, root) && renders_as(ctx, "[2,3,4]"));
+
+    jes_delete_element(ctx, jes_get_array_value(ctx, root, 1));
+    CHECK("G6-03 delete in the middle", all_indices_match(ctx, root) && renders_as(ctx, "[2,4]"));
+
+    /* The appended value reuses a released node */
+    jes_append_array_value(ctx, root, JES_NUMBER, "6", 1);
+    CHECK("G6-04 append a reused node", all_indices_match(ctx, root) && renders_as(ctx, "[2,4,6]"));
+
+    ctx = load("[[1],2,[3,4],5]", JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G6-setup", "load failed"); return; }
+    root = jes_get_root(ctx);
+    CHECK("G6-05 parsed nested arrays", all_indices_match(ctx, root) &&
+                                        all_indices_match(ctx, jes_get_array_value(ctx, root, 0)) &&
+                                        all_indices_match(ctx, jes_get_array_value(ctx, root, 2)));
+
+    ctx = load("{\"a\":[1,2],\"b\":[3]}", JES_SEARCH_HASHED);
+    if (!ctx) { fail("G6-setup", "load failed"); return; }
+    root = jes_get_root(ctx);
+    struct jes_element *a = jes_get_value(ctx, root, "a");
+    struct jes_element *b = jes_get_value(ctx, root, "b");
+    jes_append_array_value(ctx, b, JES_NUMBER, "4", 1);
+    jes_append_array_value(ctx, a, JES_NUMBER, "5", 1);
+    CHECK("G6-06 append behind another array", all_indices_match(ctx, a) && all_indices_match(ctx, b) &&
+                                               renders_as(ctx, "{\"a\":[1,2,5],\"b\":[3,4]}"));
+
+    jes_add_array_value(ctx, b, 0, JES_NUMBER, "0", 1);
+    jes_add_array_value(ctx, b, 2, JES_TRUE, "true", 4);
+    CHECK("G6-07 prepend and insert", all_indices_match(ctx, b) &&
+                                      renders_as(ctx, "{\"a\":[1,2,5],\"b\":[0,3,true,4]}"));
+
+    /* Compacting lays out the values of a flat array back to back again */
+    CHECK("G6-08 compact succeeds", jes_compact(ctx) == JES_NO_ERROR);
+    root = jes_get_root(ctx);
+    CHECK("G6-09 every index after compact", all_indices_match(ctx, jes_get_value(ctx, root, "a")) &&
+                                             all_indices_match(ctx, jes_get_value(ctx, root, "b")));
+
+    /* A nested array added before another value keeps its values apart after compact */
+    ctx = load("[1]", JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G6-setup", "load failed"); return; }
+    root = jes_get_root(ctx);
+    struct jes_element *nested = jes_append_array_value(ctx, root, JES_ARRAY, "[", 1);
+    jes_append_array_value(ctx, root, JES_NUMBER, "2", 1);
+    jes_append_array_value(ctx, nested, JES_NUMBER, "3", 1);
+    jes_append_array_value(ctx, nested, JES_NUMBER, "4", 1);
+    CHECK("G6-10 compact succeeds", jes_compact(ctx) == JES_NO_ERROR);
+    root = jes_get_root(ctx);
+    CHECK("G6-11 every index after compacting a nested array",
+          all_indices_match(ctx, root) && all_indices_match(ctx, jes_get_array_value(ctx, root, 1)) &&
+          renders_as(ctx, "[1,[3,4],2]"));
+
+    /* The "[" token of an array keeps its length while the values are back to
+       back. A delete in the middle clears it, compacting restores it. Values
+       added through the API are left out, with JES_USE_COMPACT_NODE their
+       holder nodes follow them. */
+    ctx = load("[1,[2,3,4],5]", JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G6-setup", "load failed"); return; }
+    root = jes_get_root(ctx);
+    nested = jes_get_array_value(ctx, root, 1);
+    CHECK("G6-12 parsed nested array is back to back", root->length == 0 && nested->length == 1);
+    jes_delete_element(ctx, jes_get_array_value(ctx, nested, 1));
+    CHECK("G6-13 delete in the middle breaks the layout", nested->length == 0);
+    CHECK("G6-14 compact succeeds", jes_compact(ctx) == JES_NO_ERROR);
+    root = jes_get_root(ctx);
+    nested = jes_get_array_value(ctx, root, 1);
+    CHECK("G6-15 compact restores the layout", root->length == 0 && nested->length == 1 &&
+                                               all_indices_match(ctx, nested) && renders_as(ctx, "[1,[2,4],5]"));
+}
+
+/* =========================================================================
+ * main
+ * ========================================================================= */
+
+int main(void)
+{
+    printf("=== JES Array API Tests ===\n");
+
+    test_size_after_parse();
+    test_size_through_edits(JES_SEARCH_LINEAR);
+    test_size_through_edits(JES_SEARCH_HASHED);
+    test_index_access();
+    test_size_after_compact();
+    test_large_array_access();
+    test_contiguous_arrays();
+
+    printf("\n=== Results: %d passed, %d failed ===\n", g_passed, g_failed);
+    return g_failed == 0 ? 0 : 1;
+}
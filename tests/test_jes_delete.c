@@ -0,0 +1,425 @@
+/**
+ * jes_delete_test.c
+ *
+ * Complexity regression tests for jes_delete_element() on large subtrees.
+ *
+ * Groups:
+ *   1. Deep subtree     — a chain of nested arrays, one node per level
+ *   2. Wide subtree     — an array with a single level of many values
+ *   3. Hashed subtree   — an object with many keys in JES_SEARCH_HASHED mode,
+ *                         removed from the hash table in a batch
+ *   4. Small subtree    — hashed keys removed one by one
+ *   5. Compaction       — jes_compact() after delete/add cycles restores the
+ *                         document order of the node pool
+ *   6. Hash table churn — keys deleted and added many times over the table
+ *                         capacity, lookups of missing keys stay fast
+ *
+ * Deleting a subtree must visit every node once. A quadratic implementation
+ * takes seconds on the deep subtree, so each deletion has a CPU time budget.
+ *
+ * With 16-bit node descriptors the subtrees are limited to 60000 nodes.
+ * Define JES_USE_32BIT_NODE_DESCRIPTOR to delete subtrees of 10^5 nodes.
+ *
+ * Build (from repo root):
+ *   gcc jes_delete_test.c src/jes.c src/jes_tokenizer.c src/jes_parser.c \
+ *       src/jes_serializer.c src/jes_tree.c src/jes_hash_table.c \
+ *       src/jes_logger.c -std=c99 -DNDEBUG -DJES_USE_32BIT_NODE_DESCRIPTOR \
+ *       -o jes_delete_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "../src/jes.h"
+
+/* =========================================================================
+ * Harness
+ * ========================================================================= */
+
+static int g_passed = 0;
+static int g_failed = 0;
+
+static void pass(const char *id) { printf("  [PASS] %s\n", id); g_passed++; }
+static void fail(const char *id, const char *reason)
+{
+    printf("  [FAIL] %s — %s\n", id, reason); g_failed++;
+}
+
+#define CHECK(id, cond) \
+    do { if (cond) pass(id); else fail(id, #cond " was false"); } while(0)
+
+#define CHECK_NULL(id, ptr) \
+    do { if ((ptr) == NULL) pass(id); else fail(id, "expected NULL, got non-NULL"); } while(0)
+
+#define CHECK_NOTNULL(id, ptr) \
+    do { if ((ptr) != NULL) pass(id); else fail(id, "expected non-NULL, got NULL"); } while(0)
+
+/* =========================================================================
+ * Workspace
+ * ========================================================================= */
+
+#ifdef JES_USE_32BIT_NODE_DESCRIPTOR
+  #define SUBTREE_NODES 100000
+#else
+  #define SUBTREE_NODES 60000
+#endif
+
+/* CPU time allowed for a single subtree deletion */
+#define DELETE_BUDGET_SEC 0.5
+
+#define WORKSPACE_NODES (SUBTREE_NODES + 16)
+
+/* Hash table entries of an object with key_count_ keys */
+#ifdef JES_ENABLE_HYBRID_SEARCH
+  #define OBJECT_ENTRIES(key_count_) ((key_count_) >= JES_HYBRID_SEARCH_MIN_KEYS ? (key_count_) : 0)
+#else
+  #define OBJECT_ENTRIES(key_count_) (key_count_)
+#endif
+
+/* Hashed mode gives a quarter of the workspace to the hash table, which
+   spends a control byte per slot besides the entry */
+static uint8_t g_ws[JES_REQUIRED_SIZE(WORKSPACE_NODES) * 5 / 2];
+static char g_json[SUBTREE_NODES * 16];
+
+static struct jes_context *load(const char *json, enum jes_search_mode mode)
+{
+    struct jes_context *ctx = jes_init(g_ws, sizeof(g_ws), mode);
+    if (!ctx) return NULL;
+    if (jes_load(ctx, json, strlen(json)) != JES_NO_ERROR) {
+        printf("  load status: %d\n", jes_get_status(ctx));
+        return NULL;
+    }
+    return ctx;
+}
+
+static int renders_as(struct jes_context *ctx, const char *expected)
+{
+    char out[256];
+    /* The rendered length includes the NUL terminator */
+    size_t len = jes_render(ctx, out, sizeof(out), true);
+    return (len > 0) && (strcmp(out, expected) == 0);
+}
+
+/* Walks the tree in document order. Every element must be placed behind the
+   previous one and within the allocated part of the pool. */
+static int in_document_order(struct jes_context *ctx)
+{
+    struct jes_element *iter = jes_get_root(ctx);
+    const uint8_t *end = (const uint8_t *)iter +
+                         jes_get_workspace_stat(ctx).node_mng_node_count * jes_node_size();
+    const uint8_t *prev = NULL;
+
+    while (iter != NULL) {
+        if ((const uint8_t *)iter <= prev || (const uint8_t *)iter >= end) return 0;
+        prev = (const uint8_t *)iter;
+
+        if (jes_get_child(ctx, iter) != NULL) {
+            iter = jes_get_child(ctx, iter);
+            continue;
+        }
+        while (iter != NULL && jes_get_sibling(ctx, iter) == NULL) {
+            iter = jes_get_parent(ctx, iter);
+        }
+        if (iter != NULL) iter = jes_get_sibling(ctx, iter);
+    }
+    return 1;
+}
+
+static double timed_delete(struct jes_context *ctx, struct jes_element *element)
+{
+    clock_t start = clock();
+    jes_delete_element(ctx, element);
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* =========================================================================
+ * Group 1 — deep subtree
+ * ========================================================================= */
+static void test_delete_deep_subtree(void)
+{
+    printf("\nGroup 1: deep subtree (%d levels)\n", SUBTREE_NODES);
+
+    size_t depth = SUBTREE_NODES;
+    size_t pos = 0;
+    size_t i;
+
+    g_json[pos++] = '{';
+    memcpy(&g_json[pos], "\"deep\":", 7); pos += 7;
+    for (i = 0; i < depth; i++) g_json[pos++] = '[';
+    for (i = 0; i < depth; i++) g_json[pos++] = ']';
+    memcpy(&g_json[pos], ",\"keep\":1}", 10); pos += 10;
+    g_json[pos] = '\0';
+
+    struct jes_context *ctx = load(g_json, JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G1-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    size_t count = jes_get_element_count(ctx);
+
+    double elapsed = timed_delete(ctx, jes_get_key(ctx, root, "deep"));
+    size_t remaining = jes_get_element_count(ctx);
+    printf("  deleted %zu nodes in %.4f s\n", count - remaining, elapsed);
+
+    /* G1-01 */ CHECK("G1-01 deletion within budget", elapsed < DELETE_BUDGET_SEC);
+    /* G1-02 */ CHECK_NOTNULL("G1-02 keep still found", jes_get_key(ctx, root, "keep"));
+    /* G1-03 */ CHECK("G1-03 renders", renders_as(ctx, "{\"keep\":1}"));
+
+    /* The remaining document must not hold any node of the deleted levels */
+    ctx = load("{\"keep\":1}", JES_SEARCH_LINEAR);
+    /* G1-04 */ CHECK("G1-04 all levels released", ctx && jes_get_element_count(ctx) == remaining);
+}
+
+/* =========================================================================
+ * Group 2 — wide subtree
+ * ========================================================================= */
+static void test_delete_wide_subtree(void)
+{
+    printf("\nGroup 2: wide subtree (%d values)\n", SUBTREE_NODES);
+
+    size_t pos = 0;
+    size_t i;
+
+    pos += sprintf(&g_json[pos], "[1,[");
+    for (i = 0; i < SUBTREE_NODES; i++) {
+        pos += sprintf(&g_json[pos], i ? ",%zu" : "%zu", i % 10);
+    }
+    pos += sprintf(&g_json[pos], "],3]");
+
+    struct jes_context *ctx = load(g_json, JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G2-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    size_t count = jes_get_element_count(ctx);
+
+    double elapsed = timed_delete(ctx, jes_get_array_value(ctx, root, 1));
+    printf("  deleted %zu nodes in %.4f s\n", count - jes_get_element_count(ctx), elapsed);
+
+    /* G2-01 */ CHECK("G2-01 deletion within budget", elapsed < DELETE_BUDGET_SEC);
+    /* G2-02 */ CHECK("G2-02 all values released", count - jes_get_element_count(ctx) == SUBTREE_NODES + 1);
+    /* G2-03 */ CHECK("G2-03 renders", renders_as(ctx, "[1,3]"));
+
+    /* G2-04 */ CHECK_NOTNULL("G2-04 append after delete", jes_append_array_value(ctx, root, JES_NUMBER, "4", 1));
+    /* G2-05 */ CHECK("G2-05 renders after append", renders_as(ctx, "[1,3,4]"));
+}
+
+/* =========================================================================
+ * Group 3 — hashed subtree
+ * ========================================================================= */
+static void test_delete_hashed_subtree(void)
+{
+    /* Each member takes two nodes in the default node representation */
+    size_t key_count = SUBTREE_NODES / 2;
+    size_t pos = 0;
+    size_t i;
+
+    printf("\nGroup 3: hashed subtree (%zu keys)\n", key_count);
+
+    pos += sprintf(&g_json[pos], "{\"a\":0,\"big\":{");
+    for (i = 0; i < key_count; i++) {
+        pos += sprintf(&g_json[pos], i ? ",\"k%zu\":%zu" : "\"k%zu\":%zu", i, i % 10);
+    }
+    pos += sprintf(&g_json[pos], "},\"z\":1}");
+
+    struct jes_context *ctx = load(g_json, JES_SEARCH_HASHED);
+    if (!ctx) { fail("G3-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+
+    /* G3-01 */ CHECK_NOTNULL("G3-01 last key found", jes_get_key(ctx, root, "big.k17"));
+    /* G3-02 */ CHECK("G3-02 all keys hashed", jes_get_workspace_stat(ctx).hash_table_entry_count == OBJECT_ENTRIES(key_count) + OBJECT_ENTRIES(3));
+
+    double elapsed = timed_delete(ctx, jes_get_key(ctx, root, "big"));
+    printf("  deleted %zu keys in %.4f s\n", key_count + 1, elapsed);
+
+    /* G3-03 */ CHECK("G3-03 deletion within budget", elapsed < DELETE_BUDGET_SEC);
+    /* G3-04 */ CHECK("G3-04 hash entries released", jes_get_workspace_stat(ctx).hash_table_entry_count == OBJECT_ENTRIES(2));
+    /* G3-05 */ CHECK_NULL("G3-05 big not found", jes_get_key(ctx, root, "big"));
+    /* G3-06 */ CHECK_NOTNULL("G3-06 a still found", jes_get_key(ctx, root, "a"));
+    /* G3-07 */ CHECK_NOTNULL("G3-07 z still found", jes_get_key(ctx, root, "z"));
+    /* G3-08 */ CHECK("G3-08 renders", renders_as(ctx, "{\"a\":0,\"z\":1}"));
+
+    /* Released key nodes are reused by new keys */
+    struct jes_element *key = jes_add_key(ctx, root, "k1", 2);
+    /* G3-09 */ CHECK_NOTNULL("G3-09 add key after delete", key);
+    /* G3-10 */ CHECK("G3-10 new key found", jes_get_key(ctx, root, "k1") == key);
+}
+
+/* =========================================================================
+ * Group 4 — small subtree
+ * ========================================================================= */
+static void test_delete_small_hashed_subtree(void)
+{
+    printf("\nGroup 4: small hashed subtree\n");
+
+    struct jes_context *ctx = load("{\"a\":{\"b\":{\"c\":1},\"d\":2},\"e\":3}", JES_SEARCH_HASHED);
+    if (!ctx) { fail("G4-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+
+    jes_delete_element(ctx, jes_get_key(ctx, root, "a.b"));
+    /* G4-01 */ CHECK("G4-01 hash entries released", jes_get_workspace_stat(ctx).hash_table_entry_count == OBJECT_ENTRIES(2) + OBJECT_ENTRIES(1));
+    /* G4-02 */ CHECK_NULL("G4-02 a.b.c not found", jes_get_key(ctx, root, "a.b.c"));
+    /* G4-03 */ CHECK_NOTNULL("G4-03 a.d still found", jes_get_key(ctx, root, "a.d"));
+    /* G4-04 */ CHECK("G4-04 renders", renders_as(ctx, "{\"a\":{\"d\":2},\"e\":3}"));
+}
+
+/* =========================================================================
+ * Group 5 — compaction
+ * ========================================================================= */
+static void test_compact(enum jes_search_mode mode)
+{
+    printf("\nGroup 5: compaction (%s)\n", mode == JES_SEARCH_HASHED ? "hashed" : "linear");
+
+    static const char *expected =
+        "{\"y\":\"new\",\"b\":{\"c\":\"x\",\"d\":[0,1,2,3,4,5,6,7]},\"e\":null,\"z\":[true,false]}";
+    char before[256];
+    char after[256];
+    int i;
+
+    struct jes_context *ctx = load("{\"a\":[1,2,3],\"b\":{\"c\":\"x\",\"d\":[]},\"e\":null}", mode);
+    if (!ctx) { fail("G5-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+
+    /* Released nodes are recycled in LIFO order, far from their new neighbours */
+    for (i = 0; i < 8; i++) {
+        jes_append_array_value(ctx, jes_get_value(ctx, root, "b.d"), JES_NUMBER, &"01234567"[i], 1);
+        jes_delete_element(ctx, jes_get_array_value(ctx, jes_get_value(ctx, root, "a"), 0));
+        jes_append_array_value(ctx, jes_get_value(ctx, root, "a"), JES_NUMBER, "9", 1);
+    }
+    jes_delete_element(ctx, jes_get_key(ctx, root, "a"));
+    struct jes_element *z = jes_add_key(ctx, root, "z", 1);
+    jes_update_key_value_to_array(ctx, z);
+    jes_append_array_value(ctx, jes_get_value(ctx, root, "z"), JES_TRUE, "true", 4);
+    jes_append_array_value(ctx, jes_get_value(ctx, root, "z"), JES_FALSE, "false", 5);
+    jes_update_key_value(ctx, jes_add_key_before(ctx, jes_get_key(ctx, root, "b"), "y", 1), JES_STRING, "new", 3);
+
+    size_t count = jes_get_element_count(ctx);
+    size_t entries = jes_get_workspace_stat(ctx).hash_table_entry_count;
+    jes_render(ctx, before, sizeof(before), true);
+
+    /* G5-01 */ CHECK("G5-01 edits scatter the pool", !in_document_order(ctx));
+    /* G5-02 */ CHECK("G5-02 edited document", strcmp(before, expected) == 0);
+    /* G5-03 */ CHECK("G5-03 compact succeeds", jes_compact(ctx) == JES_NO_ERROR);
+
+    root = jes_get_root(ctx);
+    /* G5-04 */ CHECK("G5-04 pool in document order", in_document_order(ctx));
+    /* G5-05 */ CHECK("G5-05 element count kept", jes_get_element_count(ctx) == count);
+    /* G5-06 */ CHECK("G5-06 hash entries kept", jes_get_workspace_stat(ctx).hash_table_entry_count == entries);
+    jes_render(ctx, after, sizeof(after), true);
+    /* G5-07 */ CHECK("G5-07 renders unchanged", strcmp(before, after) == 0);
+    /* G5-08 */ CHECK_NOTNULL("G5-08 b.c found", jes_get_key(ctx, root, "b.c"));
+    /* G5-09 */ CHECK_NOTNULL("G5-09 y found", jes_get_key(ctx, root, "y"));
+    /* G5-10 */ CHECK_NULL("G5-10 a not found", jes_get_key(ctx, root, "a"));
+
+    /* The compacted tree stays editable */
+    jes_delete_element(ctx, jes_get_key(ctx, root, "b"));
+    jes_update_key_value_to_null(ctx, jes_add_key_before(ctx, jes_get_key(ctx, root, "y"), "b", 1));
+    /* G5-11 */ CHECK("G5-11 renders after edits",
+                      renders_as(ctx, "{\"b\":null,\"y\":\"new\",\"e\":null,\"z\":[true,false]}"));
+    /* G5-12 */ CHECK_NOTNULL("G5-12 new member found", jes_get_key(ctx, root, "b"));
+
+    /* An empty context compacts to an empty pool */
+    jes_delete_element(ctx, root);
+    /* G5-13 */ CHECK("G5-13 compact empty tree", jes_compact(ctx) == JES_NO_ERROR);
+    /* G5-14 */ CHECK_NULL("G5-14 no root", jes_get_root(ctx));
+    /* G5-15 */ CHECK("G5-15 no elements", jes_get_element_count(ctx) == 0);
+}
+
+/* =========================================================================
+ * Group 6 — hash table churn
+ * ========================================================================= */
+
+/* Key names are referenced by the tree, so each live key keeps its own slot
+   of a ring. */
+#define CHURN_KEY_SIZE 12
+#define CHURN_RING_SIZE (SUBTREE_NODES * 2)
+
+static char g_keys[CHURN_RING_SIZE][CHURN_KEY_SIZE];
+
+static const char *churn_key(size_t id, size_t ring, size_t *length)
+{
+    char *key = g_keys[id % ring];
+    *length = (size_t)sprintf(key, "k%zu", id);
+    return key;
+}
+
+static void test_hash_table_churn(void)
+{
+    const char *key;
+    size_t length;
+    size_t capacity;
+    size_t live;
+    size_t ring;
+    size_t next;
+    size_t found;
+    size_t i;
+
+    struct jes_context *ctx = load("{}", JES_SEARCH_HASHED);
+    if (!ctx) { fail("G6-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+
+    /* Keep the table 7/8 full, so groups fill up and deletions leave deleted slots */
+    capacity = jes_get_workspace_stat(ctx).hash_table_capacity;
+    live = capacity - capacity / 8 - 1;
+#ifdef JES_USE_COMPACT_NODE
+    /* Added keys are held by a second node */
+    if (live > jes_get_element_capacity(ctx) / 2 - 1) live = jes_get_element_capacity(ctx) / 2 - 1;
+#else
+    if (live > jes_get_element_capacity(ctx) - 1) live = jes_get_element_capacity(ctx) - 1;
+#endif
+    if (live > CHURN_RING_SIZE - 1) live = CHURN_RING_SIZE - 1;
+    ring = live + 1;
+    printf("\nGroup 6: hash table churn (%zu of %zu slots)\n", live, capacity);
+
+    for (next = 0; next < live; next++) {
+        key = churn_key(next, ring, &length);
+        if (jes_add_key(ctx, root, key, length) == NULL) break;
+    }
+    /* G6-01 */ CHECK("G6-01 table filled", next == live);
+
+    /* Replace the oldest key, many times over the capacity */
+    for (i = 0; i < 4 * capacity; i++, next++) {
+        key = churn_key(next - live, ring, &length);
+        if (jes_delete_element(ctx, jes_get_key(ctx, root, key)) != JES_NO_ERROR) break;
+        key = churn_key(next, ring, &length);
+        if (jes_add_key(ctx, root, key, length) == NULL) break;
+    }
+    /* G6-02 */ CHECK("G6-02 churn succeeds", i == 4 * capacity);
+    /* G6-03 */ CHECK("G6-03 entry count stable", jes_get_workspace_stat(ctx).hash_table_entry_count == live);
+
+    char name[CHURN_KEY_SIZE];
+    for (i = next - live, found = 0; i < next; i++) {
+        sprintf(name, "k%zu", i);
+        found += jes_get_key(ctx, root, name) != NULL;
+    }
+    /* G6-04 */ CHECK("G6-04 live keys found", found == live);
+
+    /* Lookups of missing keys stop at the first group with an empty slot.
+       Without cleanup, deleted slots make every miss scan the whole table. */
+    clock_t start = clock();
+    for (i = 0, found = 0; i < 100000; i++) {
+        sprintf(name, "k%zu", i % (next - live));
+        found += jes_get_key(ctx, root, name) != NULL;
+    }
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("  100000 missing keys looked up in %.4f s\n", elapsed);
+    /* G6-05 */ CHECK("G6-05 deleted keys not found", found == 0);
+    /* G6-06 */ CHECK("G6-06 lookups within budget", elapsed < DELETE_BUDGET_SEC);
+}
+
+/* =========================================================================
+ * main
+ * ========================================================================= */
+
+int main(void)
+{
+    printf("=== JES Delete Tests ===\n");
+
+    test_delete_deep_subtree();
+    test_delete_wide_subtree();
+    test_delete_hashed_subtree();
+    test_delete_small_hashed_subtree();
+    test_compact(JES_SEARCH_LINEAR);
+    test_compact(JES_SEARCH_HASHED);
+    test_hash_table_churn();
+
+    printf("\n=== Results: %d passed, %d failed ===\n", g_passed, g_failed);
+    return g_failed == 0 ? 0 : 1;
+}
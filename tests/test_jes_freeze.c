@@ -0,0 +1,229 @@
+/**
+ * jes_freeze_test.c
+ *
+ * Tests for frozen contexts and the reentrant lookup JES API functions:
+ *
+ *   jes_freeze(), jes_get_key_r(), jes_get_value_r(), jes_get_array_size_r(),
+ *   jes_get_array_value_r()
+ *
+ * Groups:
+ *   1. Reentrant lookups  — the _r functions find the same elements as their
+ *                           counterparts and report the status through the
+ *                           out-parameter only
+ *   2. Frozen context     — every function that modifies the tree fails with
+ *                           JES_INVALID_OPERATION and leaves the document intact
+ *   3. Read-only readers  — lookups, iterators and handles on a frozen context
+ *                           leave every byte of the workspace untouched, so
+ *                           they can run concurrently (linear and hashed)
+ *
+ * Build (from repo root):
+ *   gcc jes_freeze_test.c src/jes.c src/jes_tokenizer.c src/jes_parser.c \
+ *       src/jes_serializer.c src/jes_tree.c src/jes_hash_table.c \
+ *       src/jes_logger.c -std=c99 -o jes_freeze_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "../src/jes.h"
+
+/* =========================================================================
+ * Harness
+ * ========================================================================= */
+
+static int g_passed = 0;
+static int g_failed = 0;
+
+static void pass(const char *id) { printf("  [PASS] %s\n", id); g_passed++; }
+static void fail(const char *id, const char *reason)
+{
+    printf("  [FAIL] %s — %s\n", id, reason); g_failed++;
+}
+
+#define CHECK(id, cond) \
+    do { if (cond) pass(id); else fail(id, #cond " was false"); } while(0)
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+#define ARRAY_SIZE 40
+
+static uint8_t g_ws[JES_REQUIRED_SIZE(128)];
+static uint8_t g_snapshot[sizeof(g_ws)];
+static char g_json[512];
+
+static struct jes_context *load(enum jes_search_mode mode)
+{
+    size_t pos = 0;
+    int i;
+
+    pos += sprintf(&g_json[pos], "{\"a\":{\"b\":{\"c\":1}},\"d\":[");
+    for (i = 0; i < ARRAY_SIZE; i++) {
+        pos += sprintf(&g_json[pos], "%s%d", i ? "," : "", i);
+    }
+    pos += sprintf(&g_json[pos], "],\"e\":[[1],2]}");
+
+    struct jes_context *ctx = jes_init(g_ws, sizeof(g_ws), mode);
+    if (!ctx) return NULL;
+    return jes_load(ctx, g_json, pos) == JES_NO_ERROR ? ctx : NULL;
+}
+
+static int renders_as(struct jes_context *ctx, const char *expected)
+{
+    char out[512];
+    size_t len = jes_render(ctx, out, sizeof(out), true);
+    return (len > 0) && (strcmp(out, expected) == 0);
+}
+
+/* =========================================================================
+ * Group 1 — Reentrant lookups
+ * ========================================================================= */
+
+static void test_reentrant_lookups(void)
+{
+    printf("\nGroup 1: reentrant lookups\n");
+
+    struct jes_context *ctx = load(JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G1-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    jes_status status = JES_BROKEN_TREE;
+
+    CHECK("G1-01 key", jes_get_key_r(ctx, root, "a.b.c", &status) == jes_get_key(ctx, root, "a.b.c") &&
+                       status == JES_NO_ERROR);
+    CHECK("G1-02 value", jes_get_value_r(ctx, root, "a.b", &status) == jes_get_value(ctx, root, "a.b") &&
+                         status == JES_NO_ERROR);
+
+    struct jes_element *array = jes_get_value(ctx, root, "d");
+    CHECK("G1-03 array size", jes_get_array_size_r(ctx, array, &status) == ARRAY_SIZE && status == JES_NO_ERROR);
+    CHECK("G1-04 array value", jes_get_array_value_r(ctx, array, -1, &status) == jes_get_array_value(ctx, array, -1) &&
+                               status == JES_NO_ERROR);
+
+    /* The context keeps its own status */
+    jes_get_key(ctx, root, "missing");
+    CHECK("G1-05 missing key", jes_get_key_r(ctx, root, "a.x", &status) == NULL && status == JES_ELEMENT_NOT_FOUND &&
+                               jes_get_status(ctx) == JES_ELEMENT_NOT_FOUND);
+    jes_get_key(ctx, root, "a");
+    CHECK("G1-06 context status untouched", jes_get_array_value_r(ctx, array, ARRAY_SIZE, &status) == NULL &&
+                                            status == JES_ELEMENT_NOT_FOUND && jes_get_status(ctx) == JES_NO_ERROR);
+    CHECK("G1-07 invalid parameter", jes_get_array_size_r(ctx, root, &status) == 0 && status == JES_INVALID_PARAMETER &&
+                                     jes_get_status(ctx) == JES_NO_ERROR);
+    CHECK("G1-08 NULL context", jes_get_key_r(NULL, root, "a", &status) == NULL && status == JES_INVALID_CONTEXT);
+    CHECK("G1-09 NULL status", jes_get_value_r(ctx, root, "a.b.c", NULL) != NULL);
+}
+
+/* =========================================================================
+ * Group 2 — Frozen context
+ * ========================================================================= */
+
+static void test_frozen_context(void)
+{
+    printf("\nGroup 2: frozen context\n");
+
+    struct jes_context *ctx = load(JES_SEARCH_HASHED);
+    if (!ctx) { fail("G2-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    struct jes_element *array = jes_get_value(ctx, root, "d");
+    struct jes_element *key = jes_get_key(ctx, root, "a");
+
+    CHECK("G2-01 freeze", jes_freeze(ctx) == JES_NO_ERROR);
+    CHECK("G2-02 load", jes_load(ctx, "[]", 2) == JES_INVALID_OPERATION);
+    CHECK("G2-03 reset", jes_reset(ctx) == JES_INVALID_OPERATION);
+    CHECK("G2-04 compact", jes_compact(ctx) == JES_INVALID_OPERATION);
+    CHECK("G2-05 delete", jes_delete_element(ctx, key) == JES_INVALID_OPERATION);
+    CHECK("G2-06 add key", jes_add_key(ctx, root, "x", 1) == NULL && jes_get_status(ctx) == JES_INVALID_OPERATION);
+    CHECK("G2-07 add key after", jes_add_key_after(ctx, key, "x", 1) == NULL &&
+                                 jes_get_status(ctx) == JES_INVALID_OPERATION);
+    CHECK("G2-08 update key value", jes_update_key_value_to_null(ctx, key) == NULL &&
+                                    jes_get_status(ctx) == JES_INVALID_OPERATION);
+    CHECK("G2-09 append", jes_append_array_value(ctx, array, JES_NUMBER, "1", 1) == NULL &&
+                          jes_get_status(ctx) == JES_INVALID_OPERATION);
+    CHECK("G2-10 insert", jes_add_array_value(ctx, array, 0, JES_NUMBER, "1", 1) == NULL &&
+                          jes_get_status(ctx) == JES_INVALID_OPERATION);
+    CHECK("G2-11 update array value", jes_update_array_value(ctx, array, 0, JES_NUMBER, "1", 1) == NULL &&
+                                      jes_get_status(ctx) == JES_INVALID_OPERATION);
+    CHECK("G2-12 add element", jes_add_element(ctx, array, JES_NUMBER, "1", 1) == NULL &&
+                               jes_get_status(ctx) == JES_INVALID_OPERATION);
+
+    jes_set_path_separator(ctx, '/');
+    CHECK("G2-13 path separator unchanged", jes_get_key(ctx, root, "a.b.c") != NULL);
+    CHECK("G2-14 document intact", jes_get_array_size(ctx, array) == ARRAY_SIZE &&
+                                   renders_as(ctx, g_json));
+
+    ctx = load(JES_SEARCH_HASHED);
+    CHECK("G2-15 init thaws", ctx && jes_add_key(ctx, jes_get_root(ctx), "x", 1) != NULL);
+}
+
+/* =========================================================================
+ * Group 3 — Read-only readers
+ * ========================================================================= */
+
+static void test_read_only_readers(enum jes_search_mode mode)
+{
+    printf("\nGroup 3: read-only readers (%s)\n", mode == JES_SEARCH_HASHED ? "hashed" : "linear");
+
+    struct jes_context *ctx = load(mode);
+    if (!ctx) { fail("G3-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    struct jes_element *array = jes_get_value(ctx, root, "d");
+    struct jes_element *nested = jes_get_value(ctx, root, "e");
+    struct jes_iterator iterator;
+    jes_status status;
+    jes_status context_status;
+    size_t found = 0;
+    size_t visited = 0;
+    int i;
+
+    jes_freeze(ctx);
+    memcpy(g_snapshot, g_ws, sizeof(g_ws));
+    context_status = jes_get_status(ctx);
+
+    found += jes_get_key_r(ctx, root, "a.b.c", &status) != NULL;
+    found += jes_get_key_r(ctx, root, "a.b.x", &status) != NULL;
+    found += jes_get_value_r(ctx, root, "e", &status) != NULL;
+    for (i = 0; i < ARRAY_SIZE; i++) {
+        /* Indices beyond JES_ARRAY_INDEX_MIN_SIZE would build an array index */
+        found += jes_get_array_value_r(ctx, array, i, &status) != NULL;
+    }
+    found += jes_get_array_value_r(ctx, nested, 1, &status) != NULL;
+    found += jes_get_array_size_r(ctx, nested, &status);
+    JES_ITERATOR_FOR_EACH(ctx, root, iterator) {
+        visited++;
+    }
+    jes_iterator_init(ctx, &iterator, nested);
+    while (jes_iterator_next(&iterator) != JES_ITERATOR_END) {
+        visited++;
+    }
+    jes_handle handle;
+    for (handle = jes_get_child_handle(ctx, jes_get_root_handle(ctx)); handle != JES_INVALID_HANDLE;
+         handle = jes_get_sibling_handle(ctx, handle)) {
+        visited++;
+    }
+
+    CHECK("G3-01 lookups find the elements", found == 1 + 1 + ARRAY_SIZE + 1 + 2);
+    CHECK("G3-02 traversals visit the elements", visited > 0);
+    CHECK("G3-03 workspace untouched", memcmp(g_snapshot, g_ws, sizeof(g_ws)) == 0);
+
+    /* A path through an array is a miss, not an error of the context */
+    CHECK("G3-04 miss through an array", jes_get_key_r(ctx, root, "d.x", &status) == NULL &&
+                                         status == JES_ELEMENT_NOT_FOUND &&
+                                         jes_get_status(ctx) == context_status &&
+                                         memcmp(g_snapshot, g_ws, sizeof(g_ws)) == 0);
+}
+
+/* =========================================================================
+ * main
+ * ========================================================================= */
+
+int main(void)
+{
+    printf("=== JES Freeze Tests ===\n");
+
+    test_reentrant_lookups();
+    test_frozen_context();
+    test_read_only_readers(JES_SEARCH_LINEAR);
+    test_read_only_readers(JES_SEARCH_HASHED);
+
+    printf("\n=== Results: %d passed, %d failed ===\n", g_passed, g_failed);
+    return g_failed == 0 ? 0 : 1;
+}
@@ -1,7 +1,7 @@
 /**
  * jes_get_key_test.c
  *
- * Tests for jes_get_key() and jes_set_path_separator().
+ * Tests for jes_get_key(), jes_set_path_separator() and compiled paths.
  *
  * Build (from repo root):
  *   gcc jes_get_key_test.c src/jes.c src/jes_tokenizer.c src/jes_parser.c \
@@ -222,7 +222,7 @@ static void test_group_flat_lookup(void)
             FAIL("G3-01 type check", "expected JES_KEY");
         else
             PASS("G3-01 type == JES_KEY");
-        if (key->length == 4 && memcmp(key->value, "key1", 4) == 0)
+        if (key->length == 4 && memcmp(jes_get_element_value(g_ctx, key), "key1", 4) == 0)
             PASS("G3-01 value == \"key1\"");
         else
             FAIL("G3-01 value check", "wrong key name in element");
@@ -267,7 +267,7 @@ static void test_group_nested_lookup(void)
     if (key) {
         struct jes_element *val = jes_get_key_value(g_ctx, key);
         if (val && val->type == JES_STRING && val->length == 4
-                && memcmp(val->value, "leaf", 4) == 0)
+                && memcmp(jes_get_element_value(g_ctx, val), "leaf", 4) == 0)
             PASS("G4-03 leaf value == \"leaf\"");
         else
             FAIL("G4-03 leaf value", "wrong value");
@@ -290,7 +290,7 @@ static void test_group_nested_lookup(void)
     CHECK_FOUND("G4-06 x.p found", key);
     if (key) {
         struct jes_element *val = jes_get_key_value(g_ctx, key);
-        if (val && val->length == 1 && val->value[0] == '1')
+        if (val && val->length == 1 && jes_get_element_value(g_ctx, val)[0] == '1')
             PASS("G4-06 x.p == \"1\"");
         else
             FAIL("G4-06 x.p value", "wrong value");
@@ -300,7 +300,7 @@ static void test_group_nested_lookup(void)
     CHECK_FOUND("G4-07 y.q found", key);
     if (key) {
         struct jes_element *val = jes_get_key_value(g_ctx, key);
-        if (val && val->length == 1 && val->value[0] == '4')
+        if (val && val->length == 1 && jes_get_element_value(g_ctx, val)[0] == '4')
             PASS("G4-07 y.q == \"4\"");
         else
             FAIL("G4-07 y.q value", "wrong value");
@@ -360,7 +360,7 @@ static void test_group_repeated_lookups(void)
     struct jes_element *k1b = jes_get_key(g_ctx, root, "key1");
     if (k1a && k1a == k1b)
         PASS("G6-01 repeated lookup same pointer");
-    else if (k1a && k1b && k1a->value == k1b->value)
+    else if (k1a && k1b && jes_get_element_value(g_ctx, k1a) == jes_get_element_value(g_ctx, k1b))
         PASS("G6-01 repeated lookup same value ptr");
     else
         FAIL("G6-01 repeated lookup", "inconsistent results");
@@ -377,6 +377,118 @@ static void test_group_repeated_lookups(void)
     (void)k2; /* suppress unused warning */
 }
 
+/* =========================================================================
+ * Group 7 — Compiled paths
+ * ========================================================================= */
+
+static void test_group_compiled_paths(void)
+{
+    static uint64_t hashed_workspace[2048];
+    struct jes_context *hashed_ctx;
+    struct jes_path path;
+    struct jes_element *key;
+    struct jes_element *val;
+    char long_path[64];
+    int i;
+
+    printf("\nGroup 7: Compiled paths\n");
+
+    if (setup(NESTED_JSON) != 0) { FAIL("G7-setup", "context init/load failed"); return; }
+
+    struct jes_element *root = jes_get_root(g_ctx);
+
+    /* G7-01: Compiled path finds the same key as jes_get_key */
+    if (jes_compile_path(g_ctx, "a.b.c", &path) != JES_NO_ERROR || path.key_count != 3)
+        FAIL("G7-01 compile a.b.c", "unexpected status or key count");
+    else if (jes_get_key_compiled(g_ctx, root, &path) != jes_get_key(g_ctx, root, "a.b.c"))
+        FAIL("G7-01 compiled lookup", "differs from jes_get_key");
+    else
+        PASS("G7-01 compiled lookup matches jes_get_key");
+
+    /* G7-02: Value of a compiled path */
+    val = jes_get_value_compiled(g_ctx, root, &path);
+    if (val && val->length == 4 && memcmp(jes_get_element_value(g_ctx, val), "leaf", 4) == 0)
+        PASS("G7-02 a.b.c == \"leaf\"");
+    else
+        FAIL("G7-02 a.b.c value", "wrong value");
+
+    /* G7-03: Missing intermediate and last keys */
+    jes_compile_path(g_ctx, "a.x.c", &path);
+    key = jes_get_key_compiled(g_ctx, root, &path);
+    CHECK_NULL_STATUS("G7-03 missing intermediate key", key, g_ctx, JES_ELEMENT_NOT_FOUND);
+    jes_compile_path(g_ctx, "a.b.x", &path);
+    key = jes_get_key_compiled(g_ctx, root, &path);
+    CHECK_NULL_STATUS("G7-03 missing last key", key, g_ctx, JES_ELEMENT_NOT_FOUND);
+
+    /* G7-04: More than JES_MAX_PATH_KEYS keys */
+    long_path[0] = '\0';
+    for (i = 0; i <= JES_MAX_PATH_KEYS; i++) {
+        strcat(long_path, i ? ".a" : "a");
+    }
+    if (jes_compile_path(g_ctx, long_path, &path) == JES_PATH_TOO_LONG && path.key_count == 0)
+        PASS("G7-04 too many keys rejected");
+    else
+        FAIL("G7-04 too many keys", "not rejected");
+
+    /* G7-05: Invalid arguments */
+    if (jes_compile_path(NULL, "a", &path) == JES_INVALID_CONTEXT &&
+        jes_compile_path(g_ctx, NULL, &path) == JES_INVALID_PARAMETER &&
+        jes_compile_path(g_ctx, "a", NULL) == JES_INVALID_PARAMETER)
+        PASS("G7-05 compile rejects NULL arguments");
+    else
+        FAIL("G7-05 compile NULL arguments", "wrong status");
+    key = jes_get_key_compiled(g_ctx, root, NULL);
+    CHECK_NULL_STATUS("G7-05 lookup NULL path", key, g_ctx, JES_INVALID_PARAMETER);
+
+    /* G7-06: Search from an intermediate key with a custom separator */
+    jes_set_path_separator(g_ctx, '/');
+    jes_compile_path(g_ctx, "b/c", &path);
+    jes_set_path_separator(g_ctx, JES_DEFAULT_PATH_SEPARATOR);
+    key = jes_get_key_compiled(g_ctx, jes_get_key(g_ctx, root, "a"), &path);
+    if (key && key == jes_get_key(g_ctx, root, "a.b.c"))
+        PASS("G7-06 keeps the separator of compile time");
+    else
+        FAIL("G7-06 separator", "lookup failed");
+
+    /* G7-07: Hashed mode, pre-hashed keys */
+    hashed_ctx = jes_init(hashed_workspace, sizeof(hashed_workspace), JES_SEARCH_HASHED);
+    if (!hashed_ctx || jes_load(hashed_ctx, WIDE_JSON, strlen(WIDE_JSON)) != JES_NO_ERROR) {
+        FAIL("G7-07 setup", "context init/load failed");
+        return;
+    }
+    root = jes_get_root(hashed_ctx);
+    jes_compile_path(hashed_ctx, "y.q", &path);
+    val = jes_get_value_compiled(hashed_ctx, root, &path);
+    if (val && val->length == 1 && jes_get_element_value(hashed_ctx, val)[0] == '4')
+        PASS("G7-07 hashed y.q == \"4\"");
+    else
+        FAIL("G7-07 hashed y.q", "wrong value");
+    jes_compile_path(hashed_ctx, "p", &path);
+    val = jes_get_value_compiled(hashed_ctx, jes_get_key(hashed_ctx, root, "x"), &path);
+    if (val && val->length == 1 && jes_get_element_value(hashed_ctx, val)[0] == '1')
+        PASS("G7-07 hashed x + p == \"1\"");
+    else
+        FAIL("G7-07 hashed x + p", "wrong value");
+
+    /* G7-08: Keys hashed with an old seed are still found */
+    jes_compile_path(hashed_ctx, "x.q", &path);
+    jes_set_hash_seed(hashed_ctx, 0x5EEDu);
+    val = jes_get_value_compiled(hashed_ctx, jes_get_root(hashed_ctx), &path);
+    if (val && val->length == 1 && jes_get_element_value(hashed_ctx, val)[0] == '2')
+        PASS("G7-08 path of an old seed");
+    else
+        FAIL("G7-08 path of an old seed", "lookup failed");
+
+    /* G7-09: A path compiled for a hashed context also works in a linear one */
+    if (setup(WIDE_JSON) != 0) { FAIL("G7-09 setup", "context init/load failed"); return; }
+    jes_compile_path(hashed_ctx, "y.p", &path);
+    val = jes_get_value_compiled(g_ctx, jes_get_root(g_ctx), &path);
+    if (val && val->length == 1 && jes_get_element_value(g_ctx, val)[0] == '3')
+        PASS("G7-09 path used by another context");
+    else
+        FAIL("G7-09 path used by another context", "lookup failed");
+}
+
 /* =========================================================================
  * main
  * ========================================================================= */
@@ -391,6 +503,7 @@ int main(void)
     test_group_nested_lookup();
     test_group_path_separator();
     test_group_repeated_lookups();
+    test_group_compiled_paths();
 
     printf("\n=== Results: %d passed, %d failed ===\n", g_passed, g_failed);
     return g_failed == 0 ? 0 : 1;
@@ -0,0 +1,188 @@
+/**
+ * jes_handle_test.c
+ *
+ * Tests for the handle-based navigation JES API functions:
+ *
+ *   jes_get_element_handle(), jes_get_handle_element(), jes_get_root_handle(),
+ *   jes_get_parent_handle(), jes_get_child_handle(), jes_get_sibling_handle()
+ *
+ * Groups:
+ *   1. Navigation parity  — for every element of a document, the handle
+ *                           functions reach the same elements as
+ *                           jes_get_parent/child/sibling() (linear and hashed)
+ *   2. Edited trees       — parity after adding and deleting elements
+ *   3. Invalid input      — invalid elements, the invalid handle and empty trees
+ *
+ * Build (from repo root):
+ *   gcc jes_handle_test.c src/jes.c src/jes_tokenizer.c src/jes_parser.c \
+ *       src/jes_serializer.c src/jes_tree.c src/jes_hash_table.c \
+ *       src/jes_logger.c -std=c99 -o jes_handle_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "../src/jes.h"
+
+/* =========================================================================
+ * Harness
+ * ========================================================================= */
+
+static int g_passed = 0;
+static int g_failed = 0;
+
+static void pass(const char *id) { printf("  [PASS] %s\n", id); g_passed++; }
+static void fail(const char *id, const char *reason)
+{
+    printf("  [FAIL] %s — %s\n", id, reason); g_failed++;
+}
+
+#define CHECK(id, cond) \
+    do { if (cond) pass(id); else fail(id, #cond " was false"); } while(0)
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+static uint8_t g_ws[JES_REQUIRED_SIZE(64)];
+
+static const char *g_doc =
+    "{\"a\":[1,{\"b\":null,\"c\":[]}],\"d\":\"x\",\"e\":{\"f\":{\"g\":true}},\"h\":[[false]]}";
+
+static struct jes_context *load(const char *json, enum jes_search_mode mode)
+{
+    struct jes_context *ctx = jes_init(g_ws, sizeof(g_ws), mode);
+    if (!ctx) return NULL;
+    return jes_load(ctx, json, strlen(json)) == JES_NO_ERROR ? ctx : NULL;
+}
+
+/* Compares the handle functions with the element functions for every element */
+static size_t parity_failures(struct jes_context *ctx, size_t *visited)
+{
+    struct jes_iterator iterator;
+    size_t failures = 0;
+
+    *visited = 0;
+    JES_ITERATOR_FOR_EACH(ctx, jes_get_root(ctx), iterator) {
+        struct jes_element *element = iterator.element;
+        jes_handle handle = jes_get_element_handle(ctx, element);
+        (*visited)++;
+        if ((handle == JES_INVALID_HANDLE) || (jes_get_handle_element(ctx, handle) != element)) {
+            failures++;
+            continue;
+        }
+        if (jes_get_handle_element(ctx, jes_get_parent_handle(ctx, handle)) != jes_get_parent(ctx, element)) failures++;
+        if (jes_get_handle_element(ctx, jes_get_child_handle(ctx, handle)) != jes_get_child(ctx, element)) failures++;
+        if (jes_get_handle_element(ctx, jes_get_sibling_handle(ctx, handle)) != jes_get_sibling(ctx, element)) failures++;
+    }
+    return failures;
+}
+
+/* Counts the elements reached from the root handle by a handle-only walk */
+static size_t walk_handles(struct jes_context *ctx)
+{
+    jes_handle root = jes_get_root_handle(ctx);
+    jes_handle iter = root;
+    size_t count = 0;
+
+    while (iter != JES_INVALID_HANDLE) {
+        jes_handle next;
+        count++;
+        next = jes_get_child_handle(ctx, iter);
+        while ((next == JES_INVALID_HANDLE) && (iter != root)) {
+            next = jes_get_sibling_handle(ctx, iter);
+            if (next == JES_INVALID_HANDLE) iter = jes_get_parent_handle(ctx, iter);
+        }
+        iter = next;
+    }
+    return count;
+}
+
+/* =========================================================================
+ * Group 1 — Navigation parity
+ * ========================================================================= */
+
+static void test_navigation_parity(enum jes_search_mode mode)
+{
+    printf("\nGroup 1: navigation parity (%s)\n", mode == JES_SEARCH_HASHED ? "hashed" : "linear");
+
+    struct jes_context *ctx = load(g_doc, mode);
+    if (!ctx) { fail("G1-setup", "load failed"); return; }
+    size_t visited = 0;
+
+    CHECK("G1-01 root handle", jes_get_handle_element(ctx, jes_get_root_handle(ctx)) == jes_get_root(ctx));
+    CHECK("G1-02 every element", parity_failures(ctx, &visited) == 0 && visited == 21);
+    CHECK("G1-03 handle-only walk", walk_handles(ctx) == visited);
+
+    struct jes_element *value = jes_get_value(ctx, jes_get_root(ctx), "d");
+    jes_handle handle = jes_get_element_handle(ctx, value);
+    CHECK("G1-04 member value", jes_get_handle_element(ctx, jes_get_parent_handle(ctx, handle)) ==
+                                jes_get_key(ctx, jes_get_root(ctx), "d") &&
+                                jes_get_sibling_handle(ctx, handle) == JES_INVALID_HANDLE);
+}
+
+/* =========================================================================
+ * Group 2 — Edited trees
+ * ========================================================================= */
+
+static void test_edited_trees(void)
+{
+    printf("\nGroup 2: edited trees\n");
+
+    struct jes_context *ctx = load(g_doc, JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G2-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    size_t visited = 0;
+
+    jes_handle kept = jes_get_element_handle(ctx, jes_get_value(ctx, root, "d"));
+    jes_delete_element(ctx, jes_get_key(ctx, root, "e"));
+    jes_add_key(ctx, root, "i", 1);
+    jes_append_array_value(ctx, jes_get_value(ctx, root, "a"), JES_NUMBER, "2", 1);
+    CHECK("G2-01 every element after edits", parity_failures(ctx, &visited) == 0 && visited == 17);
+    CHECK("G2-02 handle-only walk after edits", walk_handles(ctx) == visited);
+
+    struct jes_element *key = jes_get_key(ctx, root, "i");
+    CHECK("G2-03 key without value", jes_get_child_handle(ctx, jes_get_element_handle(ctx, key)) == JES_INVALID_HANDLE);
+    CHECK("G2-04 handle survives edits of other elements",
+          jes_get_handle_element(ctx, kept) == jes_get_value(ctx, root, "d"));
+}
+
+/* =========================================================================
+ * Group 3 — Invalid input
+ * ========================================================================= */
+
+static void test_invalid_input(void)
+{
+    printf("\nGroup 3: invalid input\n");
+
+    struct jes_context *ctx = jes_init(g_ws, sizeof(g_ws), JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G3-setup", "init failed"); return; }
+    struct jes_element bogus = { 0 };
+
+    CHECK("G3-01 empty tree", jes_get_root_handle(ctx) == JES_INVALID_HANDLE);
+    CHECK("G3-02 invalid handle", jes_get_handle_element(ctx, JES_INVALID_HANDLE) == NULL);
+    CHECK("G3-03 NULL context", jes_get_element_handle(NULL, &bogus) == JES_INVALID_HANDLE);
+
+    ctx = load("[1]", JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G3-setup", "load failed"); return; }
+    CHECK("G3-04 NULL element", jes_get_element_handle(ctx, NULL) == JES_INVALID_HANDLE &&
+                                jes_get_status(ctx) == JES_INVALID_PARAMETER);
+    CHECK("G3-05 element outside the tree", jes_get_element_handle(ctx, &bogus) == JES_INVALID_HANDLE);
+}
+
+/* =========================================================================
+ * main
+ * ========================================================================= */
+
+int main(void)
+{
+    printf("=== JES Handle API Tests ===\n");
+
+    test_navigation_parity(JES_SEARCH_LINEAR);
+    test_navigation_parity(JES_SEARCH_HASHED);
+    test_edited_trees();
+    test_invalid_input();
+
+    printf("\n=== Results: %d passed, %d failed ===\n", g_passed, g_failed);
+    return g_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,361 @@
+/**
+ * jes_image_test.c
+ *
+ * Tests for the workspace image JES API functions:
+ *
+ *   jes_save_image(), jes_load_image()
+ *
+ * Groups:
+ *   1. Round trip     — a loaded document restored from its image renders the
+ *                       same and outlives the JSON data it was parsed from
+ *   2. Edited tree    — values added through the API, released nodes and
+ *                       further edits survive the image
+ *   3. Relocation     — an image moved in memory restores the same tree and
+ *                       saving a restored tree gives the same image. Images do
+ *                       not depend on the old content of the buffer.
+ *   4. Search modes   — images are exchanged between linear and hashed contexts
+ *                       and between contexts with different hash seeds
+ *   5. Errors         — size queries, small buffers, damaged or truncated images
+ *   6. Image file     — jes_load_image_file() restores a saved image from a
+ *                       mapped file (requires -DJES_ENABLE_FILE_MAPPING)
+ *
+ * Build (from repo root):
+ *   gcc jes_image_test.c src/jes.c src/jes_tokenizer.c src/jes_parser.c \
+ *       src/jes_serializer.c src/jes_tree.c src/jes_hash_table.c \
+ *       src/jes_logger.c src/jes_file.c -std=c99 -o jes_image_test
+ *
+ * Nodes of a size that is not a multiple of JES_ALIGNMENT pad the node section
+ * of an image. Build with 44-byte nodes to cover the padding:
+ *   -DJES_USE_32BIT_NODE_DESCRIPTOR -DJES_USE_COMPACT_NODE -DJES_USE_MERGED_KEY_NODE
+ *   -DJES_USE_SUBTREE_END_DESCRIPTOR -DJES_USE_PREV_SIBLING_DESCRIPTOR -DJES_USE_CHILD_COUNT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "../src/jes.h"
+
+/* =========================================================================
+ * Harness
+ * ========================================================================= */
+
+static int g_passed = 0;
+static int g_failed = 0;
+
+static void pass(const char *id) { printf("  [PASS] %s\n", id); g_passed++; }
+static void fail(const char *id, const char *reason)
+{
+    printf("  [FAIL] %s — %s\n", id, reason); g_failed++;
+}
+
+#define CHECK(id, cond) \
+    do { if (cond) pass(id); else fail(id, #cond " was false"); } while(0)
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+static const char DOCUMENT[] =
+    "{\"name\":\"jes\",\"version\":[1,2,3],\"nested\":{\"a\":{\"b\":true},\"c\":null},\"n\":-1.5e3}";
+
+/* Workspaces and images must be aligned to JES_ALIGNMENT */
+static uint64_t g_ws_src[JES_REQUIRED_SIZE(64) / sizeof(uint64_t) + 1];
+static uint64_t g_ws_dst[JES_REQUIRED_SIZE(64) / sizeof(uint64_t) + 1];
+static uint64_t g_image[1024];
+static uint64_t g_moved[1024];
+static char g_json[sizeof(DOCUMENT)];
+
+static struct jes_context *load_source(enum jes_search_mode mode)
+{
+    memcpy(g_json, DOCUMENT, sizeof(DOCUMENT));
+    struct jes_context *ctx = jes_init(g_ws_src, sizeof(g_ws_src), mode);
+    if (!ctx) return NULL;
+    return jes_load(ctx, g_json, sizeof(DOCUMENT) - 1) == JES_NO_ERROR ? ctx : NULL;
+}
+
+static struct jes_context *init_target(enum jes_search_mode mode)
+{
+    memset(g_ws_dst, 0xA5, sizeof(g_ws_dst));
+    return jes_init(g_ws_dst, sizeof(g_ws_dst), mode);
+}
+
+static int render(struct jes_context *ctx, char *out, size_t size)
+{
+    return jes_render(ctx, out, size, true) > 0;
+}
+
+static int renders_as(struct jes_context *ctx, const char *expected)
+{
+    char out[512];
+    return render(ctx, out, sizeof(out)) && (strcmp(out, expected) == 0);
+}
+
+/* =========================================================================
+ * Group 1 — Round trip
+ * ========================================================================= */
+
+static void test_round_trip(enum jes_search_mode mode)
+{
+    printf("\nGroup 1: round trip (%s)\n", mode == JES_SEARCH_HASHED ? "hashed" : "linear");
+
+    struct jes_context *src = load_source(mode);
+    if (!src) { fail("G1-setup", "load failed"); return; }
+    char expected[512];
+    render(src, expected, sizeof(expected));
+    size_t count = jes_get_element_count(src);
+
+    size_t size = jes_save_image(src, g_image, sizeof(g_image));
+    CHECK("G1-01 save", size > 0 && jes_get_status(src) == JES_NO_ERROR);
+
+    /* The image does not reference the JSON data */
+    memset(g_json, 0, sizeof(g_json));
+
+    struct jes_context *dst = init_target(mode);
+    CHECK("G1-02 load", jes_load_image(dst, g_image, size) == JES_NO_ERROR);
+    CHECK("G1-03 renders the same", renders_as(dst, expected));
+    CHECK("G1-04 element count", jes_get_element_count(dst) == count);
+
+    struct jes_element *root = jes_get_root(dst);
+    struct jes_element *value = jes_get_value(dst, root, "nested.a.b");
+    CHECK("G1-05 key lookup", value != NULL && value->type == JES_TRUE);
+    value = jes_get_value(dst, root, "name");
+    CHECK("G1-06 string value", value != NULL && value->length == 3 &&
+                                memcmp(jes_get_element_value(dst, value), "jes", 3) == 0);
+    struct jes_element *array = jes_get_value(dst, root, "version");
+    CHECK("G1-07 array access", jes_get_array_size(dst, array) == 3 &&
+                                jes_get_array_value(dst, array, 2) != NULL &&
+                                memcmp(jes_get_element_value(dst, jes_get_array_value(dst, array, 2)), "3", 1) == 0);
+}
+
+/* =========================================================================
+ * Group 2 — Edited tree
+ * ========================================================================= */
+
+static void test_edited_tree(enum jes_search_mode mode)
+{
+    printf("\nGroup 2: edited tree (%s)\n", mode == JES_SEARCH_HASHED ? "hashed" : "linear");
+
+    struct jes_context *src = load_source(mode);
+    if (!src) { fail("G2-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(src);
+    char key[8] = "added";
+    char text[8] = "value";
+
+    /* Released nodes and values outside the JSON data */
+    jes_delete_element(src, jes_get_key(src, root, "nested"));
+    struct jes_element *added = jes_add_key(src, root, key, 5);
+    jes_update_key_value(src, added, JES_STRING, text, 5);
+    jes_append_array_value(src, jes_get_value(src, root, "version"), JES_NUMBER, "4", 1);
+    char expected[512];
+    render(src, expected, sizeof(expected));
+
+    size_t size = jes_save_image(src, g_image, sizeof(g_image));
+    CHECK("G2-01 save", size > 0);
+
+    memset(key, 0, sizeof(key));
+    memset(text, 0, sizeof(text));
+    memset(g_json, 0, sizeof(g_json));
+
+    struct jes_context *dst = init_target(mode);
+    CHECK("G2-02 load", jes_load_image(dst, g_image, size) == JES_NO_ERROR);
+    CHECK("G2-03 renders the same", renders_as(dst, expected));
+    root = jes_get_root(dst);
+    CHECK("G2-04 added key", jes_get_value(dst, root, "added") != NULL);
+    CHECK("G2-05 deleted key", jes_get_key(dst, root, "nested") == NULL);
+
+    /* Further edits reuse the released nodes */
+    size_t count = jes_get_element_count(dst);
+    added = jes_add_key(dst, root, "more", 4);
+    CHECK("G2-06 add after load", jes_update_key_value_to_null(dst, added) != NULL &&
+                                  jes_get_element_count(dst) > count);
+    CHECK("G2-07 duplicate key rejected", jes_add_key(dst, root, "name", 4) == NULL &&
+                                          jes_get_status(dst) == JES_DUPLICATE_KEY);
+    CHECK("G2-08 delete after load", jes_delete_element(dst, jes_get_key(dst, root, "version")) == JES_NO_ERROR &&
+                                     jes_get_key(dst, root, "version") == NULL);
+    CHECK("G2-09 compact after load", jes_compact(dst) == JES_NO_ERROR &&
+        renders_as(dst, "{\"name\":\"jes\",\"n\":-1.5e3,\"added\":\"value\",\"more\":null}"));
+}
+
+/* =========================================================================
+ * Group 3 — Relocation
+ * ========================================================================= */
+
+static void test_relocation(void)
+{
+    printf("\nGroup 3: relocation\n");
+
+    struct jes_context *src = load_source(JES_SEARCH_HASHED);
+    if (!src) { fail("G3-setup", "load failed"); return; }
+    char expected[512];
+    render(src, expected, sizeof(expected));
+
+    size_t size = jes_save_image(src, g_image, sizeof(g_image));
+    memcpy(g_moved, g_image, size);
+    memset(g_image, 0, sizeof(g_image));
+
+    struct jes_context *dst = init_target(JES_SEARCH_HASHED);
+    CHECK("G3-01 load moved image", jes_load_image(dst, g_moved, size) == JES_NO_ERROR);
+    CHECK("G3-02 renders the same", renders_as(dst, expected));
+    CHECK("G3-03 save again", jes_save_image(dst, g_image, sizeof(g_image)) == size);
+    CHECK("G3-04 identical image", memcmp(g_image, g_moved, size) == 0);
+
+    /* Padding between the image sections is written as well */
+    memset(g_image, 0xA5, sizeof(g_image));
+    memset(g_moved, 0x5A, sizeof(g_moved));
+    CHECK("G3-05 image independent of the buffer content",
+          jes_save_image(dst, g_image, sizeof(g_image)) == size &&
+          jes_save_image(dst, g_moved, sizeof(g_moved)) == size &&
+          memcmp(g_image, g_moved, size) == 0);
+}
+
+/* =========================================================================
+ * Group 4 — Search modes
+ * ========================================================================= */
+
+static void test_search_modes(void)
+{
+    printf("\nGroup 4: search modes\n");
+
+    struct jes_context *src = load_source(JES_SEARCH_LINEAR);
+    if (!src) { fail("G4-setup", "load failed"); return; }
+    size_t size = jes_save_image(src, g_image, sizeof(g_image));
+
+    /* Keys of a linear image are hashed on load */
+    struct jes_context *dst = init_target(JES_SEARCH_HASHED);
+    CHECK("G4-01 linear image in hashed context", jes_load_image(dst, g_image, size) == JES_NO_ERROR);
+    CHECK("G4-02 hashed lookup", jes_get_value(dst, jes_get_root(dst), "nested.c") != NULL);
+    CHECK("G4-03 duplicate key rejected", jes_add_key(dst, jes_get_root(dst), "n", 1) == NULL &&
+                                          jes_get_status(dst) == JES_DUPLICATE_KEY);
+
+    src = load_source(JES_SEARCH_HASHED);
+    size = jes_save_image(src, g_image, sizeof(g_image));
+    dst = init_target(JES_SEARCH_LINEAR);
+    CHECK("G4-04 hashed image in linear context", jes_load_image(dst, g_image, size) == JES_NO_ERROR);
+    CHECK("G4-05 linear lookup", jes_get_value(dst, jes_get_root(dst), "nested.a") != NULL);
+
+    /* Keys are hashed again when the seeds differ */
+    src = load_source(JES_SEARCH_HASHED);
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+    /* An image has no hash table until a lookup builds the index */
+    jes_get_key(src, jes_get_root(src), "name");
+#endif
+    size = jes_save_image(src, g_image, sizeof(g_image));
+    dst = init_target(JES_SEARCH_HASHED);
+    jes_set_hash_seed(dst, 0x5EEDu);
+    CHECK("G4-06 image in context with another seed", jes_load_image(dst, g_image, size) == JES_NO_ERROR);
+    CHECK("G4-07 lookup with the seed of the context", jes_get_value(dst, jes_get_root(dst), "nested.a.b") != NULL &&
+                                                       jes_get_value(dst, jes_get_root(dst), "name") != NULL);
+    CHECK("G4-08 seeded image in seeded context", jes_save_image(dst, g_image, sizeof(g_image)) == size &&
+                                                  jes_load_image(dst, g_image, size) == JES_NO_ERROR &&
+                                                  jes_get_value(dst, jes_get_root(dst), "version") != NULL);
+}
+
+/* =========================================================================
+ * Group 5 — Errors
+ * ========================================================================= */
+
+static void test_errors(void)
+{
+    printf("\nGroup 5: errors\n");
+
+    struct jes_context *src = load_source(JES_SEARCH_HASHED);
+    if (!src) { fail("G5-setup", "load failed"); return; }
+    size_t size = jes_save_image(src, NULL, 0);
+
+    CHECK("G5-01 size query", size > 0 && jes_save_image(src, g_image, sizeof(g_image)) == size);
+    CHECK("G5-02 buffer too small", jes_save_image(src, g_moved, size - 1) == 0 &&
+                                    jes_get_status(src) == JES_BUFFER_TOO_SMALL);
+    CHECK("G5-03 unaligned buffer", jes_save_image(src, (uint8_t*)g_moved + 1, sizeof(g_moved) - 1) == 0 &&
+                                    jes_get_status(src) == JES_INVALID_PARAMETER);
+    CHECK("G5-04 NULL context", jes_save_image(NULL, g_image, sizeof(g_image)) == 0 &&
+                                jes_load_image(NULL, g_image, size) == JES_INVALID_CONTEXT);
+
+    struct jes_context *dst = init_target(JES_SEARCH_HASHED);
+    CHECK("G5-05 NULL image", jes_load_image(dst, NULL, size) == JES_INVALID_PARAMETER);
+    CHECK("G5-06 truncated image", jes_load_image(dst, g_image, size - 1) == JES_INVALID_PARAMETER);
+
+    memcpy(g_moved, g_image, size);
+    ((uint8_t*)g_moved)[0] ^= 0xFF;
+    CHECK("G5-07 bad magic", jes_load_image(dst, g_moved, size) == JES_INVALID_PARAMETER &&
+                             jes_get_root(dst) == NULL);
+
+    /* The image needs more nodes than the workspace holds */
+    static uint64_t small[JES_REQUIRED_SIZE(4) / sizeof(uint64_t) + 1];
+    struct jes_context *tiny = jes_init(small, sizeof(small), JES_SEARCH_LINEAR);
+    CHECK("G5-08 workspace too small", jes_load_image(tiny, g_image, size) == JES_OUT_OF_MEMORY &&
+                                       jes_get_root(tiny) == NULL);
+
+    jes_freeze(dst);
+    CHECK("G5-09 frozen context", jes_load_image(dst, g_image, size) == JES_INVALID_OPERATION);
+
+    /* An empty context gives a valid image of an empty tree */
+    struct jes_context *empty = jes_init(g_ws_src, sizeof(g_ws_src), JES_SEARCH_LINEAR);
+    size = jes_save_image(empty, g_image, sizeof(g_image));
+    dst = init_target(JES_SEARCH_LINEAR);
+    CHECK("G5-10 empty tree", size > 0 && jes_load_image(dst, g_image, size) == JES_NO_ERROR &&
+                              jes_get_root(dst) == NULL && jes_get_element_count(dst) == 0);
+}
+
+#ifdef JES_ENABLE_FILE_MAPPING
+
+/* =========================================================================
+ * Group 6 — Image file
+ * ========================================================================= */
+
+static void test_image_file(void)
+{
+    static const char path[] = "jes_image_test.bin";
+
+    printf("\nGroup 6: image file\n");
+
+    struct jes_context *src = load_source(JES_SEARCH_HASHED);
+    if (!src) { fail("G6-setup", "load failed"); return; }
+    char expected[512];
+    render(src, expected, sizeof(expected));
+    size_t size = jes_save_image(src, g_image, sizeof(g_image));
+
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) { fail("G6-setup", "can not write the image file"); return; }
+    fwrite(g_image, 1, size, fp);
+    fclose(fp);
+    memset(g_image, 0, sizeof(g_image));
+
+    struct jes_context *dst = init_target(JES_SEARCH_HASHED);
+    CHECK("G6-01 load image file", jes_load_image_file(dst, path) == JES_NO_ERROR);
+    CHECK("G6-02 renders the same", renders_as(dst, expected));
+    CHECK("G6-03 key lookup", jes_get_value(dst, jes_get_root(dst), "nested.a.b") != NULL);
+
+    /* A JSON file is not an image */
+    CHECK("G6-04 load as JSON fails", jes_load_file(dst, path) != JES_NO_ERROR);
+    fp = fopen(path, "wb");
+    if (fp != NULL) { fwrite(DOCUMENT, 1, sizeof(DOCUMENT) - 1, fp); fclose(fp); }
+    CHECK("G6-05 JSON is no image", jes_load_image_file(dst, path) == JES_INVALID_PARAMETER);
+    CHECK("G6-06 reset", jes_reset(dst) == JES_NO_ERROR);
+
+    remove(path);
+}
+
+#endif
+
+/* =========================================================================
+ * main
+ * ========================================================================= */
+
+int main(void)
+{
+    printf("=== JES Image Tests ===\n");
+
+    test_round_trip(JES_SEARCH_LINEAR);
+    test_round_trip(JES_SEARCH_HASHED);
+    test_edited_tree(JES_SEARCH_LINEAR);
+    test_edited_tree(JES_SEARCH_HASHED);
+    test_relocation();
+    test_search_modes();
+    test_errors();
+#ifdef JES_ENABLE_FILE_MAPPING
+    test_image_file();
+#endif
+
+    printf("\n=== Results: %d passed, %d failed ===\n", g_passed, g_failed);
+    return g_failed == 0 ? 0 : 1;
+}
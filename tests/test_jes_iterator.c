@@ -0,0 +1,270 @@
+/**
+ * jes_iterator_test.c
+ *
+ * Tests for the iterator JES API functions:
+ *
+ *   jes_iterator_init(), jes_iterator_next(), jes_iterator_next_unchecked(),
+ *   JES_ITERATOR_FOR_EACH
+ *
+ * Groups:
+ *   1. Event order            — pre-order ENTER and post-order LEAVE events
+ *                               over a whole document (linear and hashed)
+ *   2. Subtrees               — traversals starting at a container, a key, a
+ *                               member value and a leaf stop at the subtree end
+ *   3. Independent iterators  — interleaved iterators, jes_render() and
+ *                               jes_get_stat() do not disturb each other
+ *   4. Validation             — invalid parameters and elements deleted during
+ *                               a checked traversal
+ *
+ * Build (from repo root):
+ *   gcc jes_iterator_test.c src/jes.c src/jes_tokenizer.c src/jes_parser.c \
+ *       src/jes_serializer.c src/jes_tree.c src/jes_hash_table.c \
+ *       src/jes_logger.c -std=c99 -DNDEBUG -o jes_iterator_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "../src/jes.h"
+
+/* =========================================================================
+ * Harness
+ * ========================================================================= */
+
+static int g_passed = 0;
+static int g_failed = 0;
+
+static void pass(const char *id) { printf("  [PASS] %s\n", id); g_passed++; }
+static void fail(const char *id, const char *reason)
+{
+    printf("  [FAIL] %s — %s\n", id, reason); g_failed++;
+}
+
+#define CHECK(id, cond) \
+    do { if (cond) pass(id); else fail(id, #cond " was false"); } while(0)
+
+/* Compares a recorded traversal with the expected one */
+#define CHECK_TRACE(id, actual, expected) \
+    do { \
+        if (strcmp((actual), (expected)) == 0) pass(id); \
+        else { char _m[192]; snprintf(_m, sizeof(_m), "trace \"%s\", expected \"%s\"", \
+               (actual), (expected)); fail(id, _m); } \
+    } while(0)
+
+/* =========================================================================
+ * Helpers
+ * ========================================================================= */
+
+static uint8_t g_ws[JES_REQUIRED_SIZE(64)];
+static char g_trace[128];
+
+static struct jes_context *load(const char *json, enum jes_search_mode mode)
+{
+    struct jes_context *ctx = jes_init(g_ws, sizeof(g_ws), mode);
+    if (!ctx) return NULL;
+    return jes_load(ctx, json, strlen(json)) == JES_NO_ERROR ? ctx : NULL;
+}
+
+/* Elements of the document. Member values do not take a node of their own
+   with JES_USE_MERGED_KEY_NODE, so jes_get_element_count() can be smaller. */
+static size_t element_total(struct jes_context *ctx)
+{
+    struct jes_stat stat = jes_get_stat(ctx);
+    return stat.objects + stat.keys + stat.arrays + stat.values;
+}
+
+/* One letter per element type: upper case on ENTER, lower case on LEAVE */
+static char trace_char(const struct jes_iterator *iterator)
+{
+    char c = '?';
+    switch (iterator->element->type) {
+        case JES_STRING: c = 's'; break;
+        case JES_NUMBER: c = 'n'; break;
+        case JES_TRUE:   c = 't'; break;
+        case JES_FALSE:  c = 'f'; break;
+        case JES_NULL:   c = 'l'; break;
+        case JES_OBJECT: c = 'o'; break;
+        case JES_KEY:    c = 'k'; break;
+        case JES_ARRAY:  c = 'a'; break;
+        default: break;
+    }
+    return (iterator->event == JES_ITERATOR_ENTER) ? (char)(c - 'a' + 'A') : c;
+}
+
+/* Records a full traversal of the subtree of element in g_trace */
+static const char *trace(struct jes_context *ctx, struct jes_element *element, int checked)
+{
+    struct jes_iterator iterator;
+    size_t pos = 0;
+
+    g_trace[0] = '\0';
+    if (jes_iterator_init(ctx, &iterator, element) != JES_NO_ERROR) return "init failed";
+    while ((checked ? jes_iterator_next(&iterator) : jes_iterator_next_unchecked(&iterator)) != JES_ITERATOR_END) {
+        if (pos + 1 >= sizeof(g_trace)) return "trace too long";
+        g_trace[pos++] = trace_char(&iterator);
+    }
+    g_trace[pos] = '\0';
+    return g_trace;
+}
+
+/* =========================================================================
+ * Group 1 — Event order
+ * ========================================================================= */
+
+static void test_event_order(enum jes_search_mode mode)
+{
+    printf("\nGroup 1: event order (%s)\n", mode == JES_SEARCH_HASHED ? "hashed" : "linear");
+
+    struct jes_context *ctx = load("{\"a\":[1,{\"b\":null}],\"c\":\"x\",\"d\":true}", mode);
+    if (!ctx) { fail("G1-setup", "load failed"); return; }
+
+    CHECK_TRACE("G1-01 checked traversal", trace(ctx, jes_get_root(ctx), 1),
+                "OKANnOKLlkoakKSskKTtko");
+    CHECK_TRACE("G1-02 unchecked traversal", trace(ctx, jes_get_root(ctx), 0),
+                "OKANnOKLlkoakKSskKTtko");
+
+    ctx = load("[[],{},[[false]]]", mode);
+    if (!ctx) { fail("G1-setup", "load failed"); return; }
+    CHECK_TRACE("G1-03 empty and nested containers", trace(ctx, jes_get_root(ctx), 1),
+                "AAaOoAAFfaaa");
+
+    ctx = load("42", mode);
+    if (!ctx) { fail("G1-setup", "load failed"); return; }
+    CHECK_TRACE("G1-04 scalar document", trace(ctx, jes_get_root(ctx), 1), "Nn");
+
+    ctx = load("{\"a\":{\"b\":[1,2]},\"c\":[3]}", mode);
+    if (!ctx) { fail("G1-setup", "load failed"); return; }
+    struct jes_iterator iterator;
+    size_t visited = 0;
+    JES_ITERATOR_FOR_EACH(ctx, jes_get_root(ctx), iterator) {
+        visited++;
+    }
+    CHECK("G1-05 JES_ITERATOR_FOR_EACH visits every element once", visited == element_total(ctx) && visited == 10);
+}
+
+/* =========================================================================
+ * Group 2 — Subtrees
+ * ========================================================================= */
+
+static void test_subtrees(void)
+{
+    printf("\nGroup 2: subtrees\n");
+
+    struct jes_context *ctx = load("{\"a\":[1,{\"b\":null}],\"c\":\"x\"}", JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G2-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    struct jes_element *a = jes_get_value(ctx, root, "a");
+
+    CHECK_TRACE("G2-01 array", trace(ctx, a, 1), "ANnOKLlkoa");
+    CHECK_TRACE("G2-02 key", trace(ctx, jes_get_key(ctx, root, "a"), 1), "KANnOKLlkoak");
+    CHECK_TRACE("G2-03 nested object", trace(ctx, jes_get_array_value(ctx, a, 1), 1), "OKLlko");
+    CHECK_TRACE("G2-04 member value", trace(ctx, jes_get_value(ctx, root, "c"), 1), "Ss");
+    CHECK_TRACE("G2-05 leaf", trace(ctx, jes_get_array_value(ctx, a, 0), 0), "Nn");
+
+    /* A key without a value yet */
+    jes_add_key(ctx, root, "e", 1);
+    CHECK_TRACE("G2-06 key without value", trace(ctx, jes_get_key(ctx, root, "e"), 1), "Kk");
+}
+
+/* =========================================================================
+ * Group 3 — Independent iterators
+ * ========================================================================= */
+
+static void test_independent_iterators(void)
+{
+    printf("\nGroup 3: independent iterators\n");
+
+    struct jes_context *ctx = load("{\"a\":[1,2],\"b\":{\"c\":3}}", JES_SEARCH_HASHED);
+    if (!ctx) { fail("G3-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    struct jes_iterator outer;
+    struct jes_iterator inner;
+    char out[256];
+    size_t pairs = 0;
+    size_t outer_steps = 0;
+    int renders = 1;
+
+    /* Nested loops over the same context, with renders and stats in between */
+    jes_iterator_init(ctx, &outer, root);
+    while (jes_iterator_next(&outer) != JES_ITERATOR_END) {
+        if (outer.event != JES_ITERATOR_ENTER) continue;
+        outer_steps++;
+        jes_iterator_init(ctx, &inner, root);
+        while (jes_iterator_next(&inner) != JES_ITERATOR_END) {
+            if (inner.event == JES_ITERATOR_ENTER) pairs++;
+        }
+        renders = renders && (jes_render(ctx, out, sizeof(out), true) > 0);
+        (void)jes_get_stat(ctx);
+    }
+    size_t count = element_total(ctx);
+    CHECK("G3-01 nested traversals", outer_steps == count && pairs == count * count);
+    CHECK("G3-02 renders in between", renders && strcmp(out, "{\"a\":[1,2],\"b\":{\"c\":3}}") == 0);
+
+    /* A traversal can be continued after editing elements it has not reached */
+    jes_iterator_init(ctx, &outer, root);
+    jes_iterator_next(&outer);
+    jes_iterator_next(&outer);
+    CHECK("G3-03 iterator on the first key", outer.element == jes_get_key(ctx, root, "a"));
+    jes_update_key_value(ctx, jes_get_key(ctx, root, "b"), JES_FALSE, "false", 5);
+    size_t pos = 0;
+    while (jes_iterator_next(&outer) != JES_ITERATOR_END) {
+        g_trace[pos++] = trace_char(&outer);
+    }
+    g_trace[pos] = '\0';
+    CHECK_TRACE("G3-04 continues over the edited tree", g_trace, "ANnNnakKFfko");
+}
+
+/* =========================================================================
+ * Group 4 — Validation
+ * ========================================================================= */
+
+static void test_validation(void)
+{
+    printf("\nGroup 4: validation\n");
+
+    struct jes_context *ctx = load("[1,[2,3],4]", JES_SEARCH_LINEAR);
+    if (!ctx) { fail("G4-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    struct jes_element bogus = { 0 };
+    struct jes_iterator iterator;
+
+    CHECK("G4-01 NULL context", jes_iterator_init(NULL, &iterator, root) == JES_INVALID_CONTEXT);
+    CHECK("G4-02 NULL iterator", jes_iterator_init(ctx, NULL, root) == JES_INVALID_PARAMETER);
+    CHECK("G4-03 NULL element", jes_iterator_init(ctx, &iterator, NULL) == JES_INVALID_PARAMETER &&
+                                jes_iterator_next(&iterator) == JES_ITERATOR_END);
+    CHECK("G4-04 element outside the tree", jes_iterator_init(ctx, &iterator, &bogus) == JES_INVALID_PARAMETER &&
+                                            jes_iterator_next_unchecked(&iterator) == JES_ITERATOR_END);
+    CHECK("G4-05 NULL iterator step", jes_iterator_next(NULL) == JES_ITERATOR_END);
+
+    /* Deleting the current element ends a checked traversal */
+    jes_iterator_init(ctx, &iterator, root);
+    jes_iterator_next(&iterator);
+    jes_iterator_next(&iterator);
+    jes_iterator_next(&iterator);
+    jes_iterator_next(&iterator);
+    struct jes_element *nested = iterator.element;
+    CHECK("G4-06 iterator on the nested array", nested == jes_get_array_value(ctx, root, 1) &&
+                                              iterator.event == JES_ITERATOR_ENTER);
+    jes_delete_element(ctx, nested);
+    CHECK("G4-07 deleted element ends the traversal", jes_iterator_next(&iterator) == JES_ITERATOR_END &&
+                                                      jes_get_status(ctx) == JES_INVALID_PARAMETER);
+    CHECK("G4-08 stays at the end", jes_iterator_next(&iterator) == JES_ITERATOR_END && iterator.element == NULL);
+}
+
+/* =========================================================================
+ * main
+ * ========================================================================= */
+
+int main(void)
+{
+    printf("=== JES Iterator API Tests ===\n");
+
+    test_event_order(JES_SEARCH_LINEAR);
+    test_event_order(JES_SEARCH_HASHED);
+    test_subtrees();
+    test_independent_iterators();
+    test_validation();
+
+    printf("\n=== Results: %d passed, %d failed ===\n", g_passed, g_failed);
+    return g_failed == 0 ? 0 : 1;
+}
@@ -4,7 +4,7 @@
  * Tests for all key-related JES API functions:
  *
  *   Lookup:     jes_get_key(), jes_get_key_value(), jes_get_value(),
- *               jes_set_path_separator()
+ *               jes_set_path_separator(), jes_set_hash_seed()
  *   Mutation:   jes_add_key(), jes_add_key_before(), jes_add_key_after(),
  *               jes_update_key_value(), jes_update_key_value_to_object(),
  *               jes_update_key_value_to_array(),  jes_update_key_value_to_true(),
@@ -25,6 +25,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include "../src/jes.h"
@@ -66,15 +67,15 @@ static void fail(const char *id, const char *reason)
                (elem) ? (int)(elem)->type : -1, (int)(expected)); fail(id, _m); } \
     } while(0)
 
-#define CHECK_VALUE(id, elem, str) \
+#define CHECK_VALUE(id, ctx, elem, str) \
     do { \
         size_t _len = strlen(str); \
         if ((elem) && (elem)->length == (uint16_t)_len \
-                   && memcmp((elem)->value, (str), _len) == 0) pass(id); \
+                   && memcmp(jes_get_element_value((ctx), (elem)), (str), _len) == 0) pass(id); \
         else { char _m[128]; \
                snprintf(_m, sizeof(_m), "got \"%.*s\", expected \"%s\"", \
                         (elem) ? (int)(elem)->length : 0, \
-                        (elem) ? (elem)->value : "", (str)); \
+                        (elem) ? jes_get_element_value((ctx), (elem)) : "", (str)); \
                fail(id, _m); } \
     } while(0)
 
@@ -185,7 +186,7 @@ static void test_get_key_lookup(void)
     k = jes_get_key(ctx, root, "a");
     /* G3-01 */ CHECK_NOTNULL("G3-01 found \"a\"",       k);
     /* G3-02 */ CHECK_TYPE("G3-02 type == JES_KEY",      k, JES_KEY);
-    /* G3-03 */ CHECK_VALUE("G3-03 key name == \"a\"",   k, "a");
+    /* G3-03 */ CHECK_VALUE("G3-03 key name == \"a\"",   ctx, k, "a");
     /* G3-04 */ CHECK_STATUS("G3-04 status JES_NO_ERROR",ctx, JES_NO_ERROR);
 
     /* ── multi-level path ────────────────────────────────────────────── */
@@ -194,7 +195,7 @@ static void test_get_key_lookup(void)
 
     k = jes_get_key(ctx, root, "a.b.c");
     /* G3-06 */ CHECK_NOTNULL("G3-06 found \"a.b.c\"",   k);
-    /* G3-07 */ CHECK_VALUE("G3-07 leaf name == \"c\"",  k, "c");
+    /* G3-07 */ CHECK_VALUE("G3-07 leaf name == \"c\"",  ctx, k, "c");
 
     /* ── relative path from KEY element ─────────────────────────────── */
     struct jes_element *k_a = jes_get_key(ctx, root, "a");
@@ -205,12 +206,12 @@ static void test_get_key_lookup(void)
     k = jes_get_key(ctx, root, "x.p");
     struct jes_element *v = jes_get_key_value(ctx, k);
     /* G3-09 */ CHECK_NOTNULL("G3-09 found \"x.p\"",     k);
-    /* G3-10 */ CHECK_VALUE("G3-10 x.p value == \"1\"",  v, "1");
+    /* G3-10 */ CHECK_VALUE("G3-10 x.p value == \"1\"",  ctx, v, "1");
 
     k = jes_get_key(ctx, root, "x.q");
     v = jes_get_key_value(ctx, k);
     /* G3-11 */ CHECK_NOTNULL("G3-11 found \"x.q\"",     k);
-    /* G3-12 */ CHECK_VALUE("G3-12 x.q value == \"2\"",  v, "2");
+    /* G3-12 */ CHECK_VALUE("G3-12 x.q value == \"2\"",  ctx, v, "2");
 
     /* ── repeated lookup returns consistent result ───────────────────── */
     struct jes_element *k1 = jes_get_key(ctx, root, "a");
@@ -258,12 +259,12 @@ static void test_get_key_value(void)
     k = jes_get_key(ctx, root, "str");
     v = jes_get_key_value(ctx, k);
     /* G4-01 */ CHECK_TYPE("G4-01 string value type",  v, JES_STRING);
-    /* G4-02 */ CHECK_VALUE("G4-02 string value data", v, "hello");
+    /* G4-02 */ CHECK_VALUE("G4-02 string value data", ctx, v, "hello");
 
     k = jes_get_key(ctx, root, "num");
     v = jes_get_key_value(ctx, k);
     /* G4-03 */ CHECK_TYPE("G4-03 number value type",  v, JES_NUMBER);
-    /* G4-04 */ CHECK_VALUE("G4-04 number value data", v, "42");
+    /* G4-04 */ CHECK_VALUE("G4-04 number value data", ctx, v, "42");
 
     k = jes_get_key(ctx, root, "flag");
     v = jes_get_key_value(ctx, k);
@@ -286,7 +287,7 @@ static void test_get_key_value(void)
     /* ── jes_get_value convenience wrapper ───────────────────────────── */
     v = jes_get_value(ctx, root, "str");
     /* G4-10 */ CHECK_TYPE("G4-10 get_value type",     v, JES_STRING);
-    /* G4-11 */ CHECK_VALUE("G4-11 get_value data",    v, "hello");
+    /* G4-11 */ CHECK_VALUE("G4-11 get_value data",    ctx, v, "hello");
 
     v = jes_get_value(ctx, root, "obj.x");
     /* G4-12 */ CHECK_TYPE("G4-12 get_value nested",   v, JES_NUMBER);
@@ -311,7 +312,7 @@ static void test_add_key(void)
     struct jes_element *k_c = jes_add_key(ctx, root, "c", 1);
     /* G5-01 */ CHECK_NOTNULL("G5-01 add_key returns element", k_c);
     /* G5-02 */ CHECK_TYPE("G5-02 add_key type == JES_KEY", k_c, JES_KEY);
-    /* G5-03 */ CHECK_VALUE("G5-03 add_key name == \"c\"",  k_c, "c");
+    /* G5-03 */ CHECK_VALUE("G5-03 add_key name == \"c\"",  ctx, k_c, "c");
     /* G5-04 */ CHECK("G5-04 tree doesn't render after add_key", renders_ok(ctx) == 0);
     jes_update_key_value(ctx, k_c, JES_STRING, "tmp", 3);  // give it a value first
     /* G5-05 */ CHECK("G5-05 tree renders after update_key_value", renders_ok(ctx));
@@ -385,14 +386,14 @@ static void test_update_key_value(void)
     v = jes_update_key_value(ctx, k, JES_STRING, "new", 3);
     /* G6-01 */ CHECK_NOTNULL("G6-01 update_key_value returns value", v);
     /* G6-02 */ CHECK_TYPE("G6-02 updated type == JES_STRING",        v, JES_STRING);
-    /* G6-03 */ CHECK_VALUE("G6-03 updated value == \"new\"",         v, "new");
+    /* G6-03 */ CHECK_VALUE("G6-03 updated value == \"new\"",         ctx, v, "new");
     /* G6-04 */ CHECK("G6-04 renders after string update", renders_ok(ctx));
 
     /* ── update to number ────────────────────────────────────────────── */
     k = jes_get_key(ctx, root, "b");
     v = jes_update_key_value(ctx, k, JES_NUMBER, "99", 2);
     /* G6-05 */ CHECK_TYPE("G6-05 updated type == JES_NUMBER", v, JES_NUMBER);
-    /* G6-06 */ CHECK_VALUE("G6-06 updated value == \"99\"",   v, "99");
+    /* G6-06 */ CHECK_VALUE("G6-06 updated value == \"99\"",   ctx, v, "99");
 
     /* ── _to_true / _to_false / _to_null ────────────────────────────── */
     k = jes_get_key(ctx, root, "c");
@@ -427,7 +428,7 @@ static void test_update_key_value(void)
     /* ── unaffected sibling keeps its value ──────────────────────────── */
     struct jes_element *k_e = jes_get_key(ctx, root, "e");
     struct jes_element *v_e = jes_get_key_value(ctx, k_e);
-    /* G6-15 */ CHECK_VALUE("G6-15 sibling \"e\" unchanged", v_e, "keep");
+    /* G6-15 */ CHECK_VALUE("G6-15 sibling \"e\" unchanged", ctx, v_e, "keep");
 
     /* ── invalid args ────────────────────────────────────────────────── */
     /* G6-16 */ CHECK_NULL("G6-16 update NULL ctx",
@@ -444,6 +445,29 @@ static void test_update_key_value(void)
                            jes_update_key_value_to_object(ctx, NULL));
     /* G6-22 */ CHECK_NULL("G6-22 _to_array NULL key",
                            jes_update_key_value_to_array(ctx, NULL));
+
+    /* ── values added through the API point to the caller's buffers ──── */
+    static const char api_keyword[] = "added";
+    static const char api_value[] = "external";
+    static const char api_item[] = "item";
+    struct jes_element *k_api = jes_add_key(ctx, root, api_keyword, 5);
+    v = k_api ? jes_update_key_value(ctx, k_api, JES_STRING, api_value, 8) : NULL;
+    /* G6-23 */ CHECK_VALUE("G6-23 API key name == \"added\"", ctx, k_api, "added");
+    /* G6-24 */ CHECK("G6-24 API key name points to caller buffer",
+                      k_api && jes_get_element_value(ctx, k_api) == api_keyword);
+    /* G6-25 */ CHECK_VALUE("G6-25 API value == \"external\"", ctx, v, "external");
+    /* G6-26 */ CHECK("G6-26 API value points to caller buffer",
+                      v && jes_get_element_value(ctx, v) == api_value);
+    /* G6-27 */ CHECK_VALUE("G6-27 API value found by path", ctx,
+                            jes_get_value(ctx, root, "added"), "external");
+
+    k = jes_get_key(ctx, root, "b");
+    v = jes_get_key_value(ctx, k);
+    struct jes_element *item = jes_add_array_value(ctx, v, -1, JES_STRING, api_item, 4);
+    /* G6-28 */ CHECK_VALUE("G6-28 API array item == \"item\"", ctx, item, "item");
+    /* G6-29 */ CHECK("G6-29 API array item points to caller buffer",
+                      item && jes_get_element_value(ctx, item) == api_item);
+    /* G6-30 */ CHECK("G6-30 renders after API additions", renders_ok(ctx));
 }
 
 /* =========================================================================
@@ -491,7 +515,7 @@ static void test_delete_key(void)
     struct jes_element *k_found = jes_get_key(ctx, root, "del");
     /* G7-10 */ CHECK_NOTNULL("G7-10 re-added key findable", k_found);
     struct jes_element *v_found = jes_get_key_value(ctx, k_found);
-    /* G7-11 */ CHECK_VALUE("G7-11 re-added key value correct", v_found, "back");
+    /* G7-11 */ CHECK_VALUE("G7-11 re-added key value correct", ctx, v_found, "back");
 
     /* ── invalid args ────────────────────────────────────────────────── */
     /* G7-12 */ CHECK("G7-12 delete NULL ctx returns error",
@@ -527,7 +551,7 @@ static void test_hashed_search(void)
 
     k = jes_get_key(ctx, root, "a.b.c");
     /* G8-01 */ CHECK_NOTNULL("G8-01 hashed: deep path found",    k);
-    /* G8-02 */ CHECK_VALUE("G8-02 hashed: key name == \"c\"",    k, "c");
+    /* G8-02 */ CHECK_VALUE("G8-02 hashed: key name == \"c\"",    ctx, k, "c");
 
     k = jes_get_key(ctx, root, "x");
     /* G8-03 */ CHECK_NOTNULL("G8-03 hashed: flat key found",     k);
@@ -547,14 +571,25 @@ static void test_hashed_search(void)
     /* G8-06 */ CHECK("G8-06 hashed and linear agree on found key",
                       k_lin  && k_hash &&
                       k_lin->length == k_hash->length &&
-                      memcmp(k_lin->value, k_hash->value, k_lin->length) == 0);
+                      memcmp(jes_get_element_value(ctx_lin, k_lin), jes_get_element_value(ctx, k_hash), k_lin->length) == 0);
 
     k_lin  = jes_get_key(ctx_lin, root_lin, "y");
     k_hash = jes_get_key(ctx,     root,     "y");
     /* G8-07 */ CHECK("G8-07 hashed and linear agree on sibling",
                       k_lin  && k_hash &&
                       k_lin->length == k_hash->length &&
-                      memcmp(k_lin->value, k_hash->value, k_lin->length) == 0);
+                      memcmp(jes_get_element_value(ctx_lin, k_lin), jes_get_element_value(ctx, k_hash), k_lin->length) == 0);
+
+    /* A path through an array never reaches the array items */
+    const char *array_json = "{\"a\":[\"b\",\"c\"]}";
+    jes_load(ctx, array_json, strlen(array_json));
+    jes_load(ctx_lin, array_json, strlen(array_json));
+    k = jes_get_key(ctx, jes_get_root(ctx), "a.b");
+    /* G8-08 */ CHECK_NULL("G8-08 hashed: path through an array returns NULL", k);
+    /* G8-09 */ CHECK_STATUS("G8-09 hashed: path through an array status", ctx, JES_ELEMENT_NOT_FOUND);
+    k_lin = jes_get_key(ctx_lin, jes_get_root(ctx_lin), "a.b");
+    /* G8-10 */ CHECK_NULL("G8-10 linear: path through an array returns NULL", k_lin);
+    /* G8-11 */ CHECK_STATUS("G8-11 linear: path through an array status", ctx_lin, JES_ELEMENT_NOT_FOUND);
 }
 
 /* =========================================================================
@@ -593,12 +628,473 @@ static void test_delete_key_with_multiple_values(void)
 
     /* G9-09: node count is consistent (no leaked nodes) */
     uint32_t count = jes_get_element_count(ctx);
+#ifdef JES_USE_MERGED_KEY_NODE
+    /* G9-09 */ CHECK("G9-09 node count == 3", count == 3); /* root + keep:0 + also_keep:2 */
+#else
     /* G9-09 */ CHECK("G9-09 node count == 5", count == 5); /* root + keep + 1 + also_keep + 2 */
+#endif
+}
+
+/* =========================================================================
+ * Group 10 — navigation between keys and values
+ * Must hold for every node representation (see JES_USE_MERGED_KEY_NODE).
+ * ========================================================================= */
+static void test_key_value_navigation(void)
+{
+    printf("\nGroup 10: key/value navigation\n");
+
+    struct jes_context *ctx = load("{\"a\":{\"b\":[1,2]},\"c\":true}");
+    if (!ctx) { fail("G10-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    struct jes_element *key_a = jes_get_key(ctx, root, "a");
+    struct jes_element *val_a = jes_get_key_value(ctx, key_a);
+    struct jes_element *key_b = jes_get_key(ctx, root, "a.b");
+
+    /* G10-01 */ CHECK("G10-01 value of a is OBJECT", val_a && val_a->type == JES_OBJECT);
+    /* G10-02 */ CHECK("G10-02 child of key is its value", jes_get_child(ctx, key_a) == val_a);
+    /* G10-03 */ CHECK("G10-03 parent of value is its key", jes_get_parent(ctx, val_a) == key_a);
+    /* G10-04 */ CHECK_NULL("G10-04 value has no sibling", jes_get_sibling(ctx, val_a));
+    /* G10-05 */ CHECK("G10-05 child of value is first member", jes_get_child(ctx, val_a) == key_b);
+    /* G10-06 */ CHECK("G10-06 parent of member is the object", jes_get_parent(ctx, key_b) == val_a);
+    /* G10-07 */ CHECK("G10-07 parent type of member is OBJECT", jes_get_parent_type(ctx, key_b) == JES_OBJECT);
+    /* G10-08 */ CHECK("G10-08 lookup from value", jes_get_key(ctx, val_a, "b") == key_b);
+    /* G10-09 */ CHECK("G10-09 array size via value", jes_get_array_size(ctx, jes_get_key_value(ctx, key_b)) == 2);
+
+    /* G10-10: deleting a value keeps its key */
+    jes_delete_element(ctx, val_a);
+    /* G10-10 */ CHECK_NULL("G10-10 key has no value after delete", jes_get_key_value(ctx, key_a));
+    /* G10-11 */ CHECK_NULL("G10-11 a.b is gone", jes_get_key(ctx, root, "a.b"));
+
+    /* G10-12: a key can get a new value */
+    /* G10-12 */ CHECK_NOTNULL("G10-12 add value to key", jes_add_element(ctx, key_a, JES_NUMBER, "7", 1));
+    /* G10-13 */ CHECK("G10-13 renders", renders_ok(ctx));
+    /* G10-14 */ CHECK("G10-14 stat keys == 2", jes_get_stat(ctx).keys == 2);
+    /* G10-15 */ CHECK("G10-15 stat values == 2", jes_get_stat(ctx).values == 2);
+}
+/* =========================================================================
+ * Group 11 — element order after edits
+ * Inserting and deleting in the middle of a branch must keep the rendered
+ * document order (see JES_USE_SUBTREE_END_DESCRIPTOR).
+ * ========================================================================= */
+static int renders_as(struct jes_context *ctx, const char *expected)
+{
+    char out[2048];
+    size_t len = jes_render(ctx, out, sizeof(out), true);
+    /* The rendered length includes the NUL terminator */
+    return (len > 0) && (strcmp(out, expected) == 0);
+}
+
+static void test_order_after_edits(void)
+{
+    printf("\nGroup 11: element order after edits\n");
+
+    struct jes_context *ctx = load("{\"a\":[1,[2,[3]]],\"b\":{\"c\":{\"d\":4}},\"e\":5}");
+    if (!ctx) { fail("G11-setup", "load failed"); return; }
+    struct jes_element *root = jes_get_root(ctx);
+    struct jes_element *key;
+
+    /* G11-01 */ CHECK("G11-01 baseline", renders_as(ctx, "{\"a\":[1,[2,[3]]],\"b\":{\"c\":{\"d\":4}},\"e\":5}"));
+
+    key = jes_add_key_after(ctx, jes_get_key(ctx, root, "a"), "x", 1);
+    jes_add_element(ctx, key, JES_NUMBER, "6", 1);
+    /* G11-02 */ CHECK("G11-02 add after nested branch", renders_as(ctx, "{\"a\":[1,[2,[3]]],\"x\":6,\"b\":{\"c\":{\"d\":4}},\"e\":5}"));
+
+    key = jes_add_key_before(ctx, jes_get_key(ctx, root, "a"), "y", 1);
+    jes_add_element(ctx, key, JES_NULL, "null", 4);
+    /* G11-03 */ CHECK("G11-03 add before first key", renders_as(ctx, "{\"y\":null,\"a\":[1,[2,[3]]],\"x\":6,\"b\":{\"c\":{\"d\":4}},\"e\":5}"));
+
+    jes_delete_element(ctx, jes_get_key(ctx, root, "x"));
+    /* G11-04 */ CHECK("G11-04 delete middle key", renders_as(ctx, "{\"y\":null,\"a\":[1,[2,[3]]],\"b\":{\"c\":{\"d\":4}},\"e\":5}"));
+
+    jes_delete_element(ctx, jes_get_key(ctx, root, "e"));
+    /* G11-05 */ CHECK("G11-05 delete last key", renders_as(ctx, "{\"y\":null,\"a\":[1,[2,[3]]],\"b\":{\"c\":{\"d\":4}}}"));
+
+    jes_append_array_value(ctx, jes_get_value(ctx, root, "a"), JES_NUMBER, "7", 1);
+    jes_add_key(ctx, jes_get_key(ctx, root, "b.c"), "f", 1);
+    jes_add_element(ctx, jes_get_key(ctx, root, "b.c.f"), JES_TRUE, "true", 4);
+    /* G11-06 */ CHECK("G11-06 append to nested branches", renders_as(ctx, "{\"y\":null,\"a\":[1,[2,[3]],7],\"b\":{\"c\":{\"d\":4,\"f\":true}}}"));
+
+    /* G11-07 */ CHECK("G11-07 stat keys == 6", jes_get_stat(ctx).keys == 6);
+
+    jes_delete_element(ctx, jes_get_array_value(ctx, jes_get_value(ctx, root, "a"), 1));
+    /* G11-08 */ CHECK("G11-08 delete middle array value", renders_as(ctx, "{\"y\":null,\"a\":[1,7],\"b\":{\"c\":{\"d\":4,\"f\":true}}}"));
+    key = jes_add_key_before(ctx, jes_get_key(ctx, root, "b.c.f"), "g", 1);
+    jes_add_element(ctx, key, JES_FALSE, "false", 5);
+    /* G11-09 */ CHECK("G11-09 add before last key", renders_as(ctx, "{\"y\":null,\"a\":[1,7],\"b\":{\"c\":{\"d\":4,\"g\":false,\"f\":true}}}"));
+
+    struct jes_workspace_stat ws = jes_get_workspace_stat(ctx);
+    /* G11-10 */ CHECK("G11-10 workspace stat node size", ws.node_size == jes_node_size() && ws.node_link_size < ws.node_size);
 }
+
+/* =========================================================================
+ * Group 12 — jes_set_hash_seed
+ * Keys of all lengths must be found with any seed and hash function
+ * (see JES_USE_WORD_HASH and JES_USE_CRC32C_HASH).
+ * ========================================================================= */
+
+static void test_hash_seed(void)
+{
+    printf("\nGroup 12: jes_set_hash_seed\n");
+
+    static uint8_t ws_hashed[JES_REQUIRED_SIZE(64)];
+    struct jes_context *ctx = jes_init(ws_hashed, sizeof(ws_hashed), JES_SEARCH_HASHED);
+    if (!ctx) { fail("G12-setup", "ctx init failed"); return; }
+
+    const char *json =
+        "{\"\":0,\"a\":1,\"abc\":2,\"abcd\":3,\"abcdefgh\":4,"
+         "\"abcdefghijklmnop\":5,\"abcdefghijklmnopq\":6,"
+         "\"configuration_service_endpoint_retry_policy_maximum_attempts\":7,"
+         "\"o\":{\"a\":8,\"abcdefghijklmnopq\":9}}";
+    static const char *paths[] = {
+        "", "a", "abc", "abcd", "abcdefgh", "abcdefghijklmnop", "abcdefghijklmnopq",
+        "configuration_service_endpoint_retry_policy_maximum_attempts",
+        "o.a", "o.abcdefghijklmnopq"
+    };
+    static const char *values[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9" };
+    size_t i;
+    int found;
+
+    if (jes_load(ctx, json, strlen(json)) != JES_NO_ERROR) {
+        fail("G12-setup", "load failed"); return;
+    }
+    struct jes_element *root = jes_get_root(ctx);
+
+    for (i = 0, found = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        struct jes_element *v = jes_get_value(ctx, root, paths[i]);
+        found += (v != NULL) && (v->length == 1) && (jes_get_element_value(ctx, v)[0] == values[i][0]);
+    }
+    /* G12-01 */ CHECK("G12-01 all key lengths found with seed 0", found == 10);
+
+    /* G12-02 */ CHECK("G12-02 set seed", jes_set_hash_seed(ctx, 0x9E3779B9u) == JES_NO_ERROR);
+    for (i = 0, found = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        struct jes_element *v = jes_get_value(ctx, root, paths[i]);
+        found += (v != NULL) && (v->length == 1) && (jes_get_element_value(ctx, v)[0] == values[i][0]);
+    }
+    /* G12-03 */ CHECK("G12-03 keys rehashed with the new seed", found == 10);
+
+    /* G12-04 */ CHECK_NULL("G12-04 duplicate key rejected after seeding",
+                            jes_add_key(ctx, root, "abcdefgh", 8));
+    /* G12-05 */ CHECK_STATUS("G12-05 duplicate key status", ctx, JES_DUPLICATE_KEY);
+
+    struct jes_element *k = jes_add_key(ctx, root, "added_after_seeding", 19);
+    jes_add_element(ctx, k, JES_NUMBER, "10", 2);
+    /* G12-06 */ CHECK_NOTNULL("G12-06 added key found",
+                               jes_get_value(ctx, root, "added_after_seeding"));
+
+    jes_reset(ctx);
+    jes_load(ctx, json, strlen(json));
+    root = jes_get_root(ctx);
+    for (i = 0, found = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        found += jes_get_key(ctx, root, paths[i]) != NULL;
+    }
+    /* G12-07 */ CHECK("G12-07 seed kept across reset and load", found == 10);
+
+    jes_freeze(ctx);
+    /* G12-08 */ CHECK("G12-08 frozen context rejects a seed",
+                       jes_set_hash_seed(ctx, 1) == JES_INVALID_OPERATION);
+    /* G12-09 */ CHECK("G12-09 NULL ctx", jes_set_hash_seed(NULL, 1) == JES_INVALID_CONTEXT);
+
+    struct jes_context *lin = load("{\"a\":1}");
+    /* G12-10 */ CHECK("G12-10 linear mode accepts a seed",
+                       lin && jes_set_hash_seed(lin, 5) == JES_NO_ERROR &&
+                       jes_get_key(lin, jes_get_root(lin), "a") != NULL);
+}
+
+#ifdef JES_ENABLE_HYBRID_SEARCH
+/* =========================================================================
+ * Group 13 — hybrid search (JES_ENABLE_HYBRID_SEARCH)
+ * Only objects with at least JES_HYBRID_SEARCH_MIN_KEYS keys are hashed.
+ * ========================================================================= */
+
+#define HYBRID_KEYS  JES_HYBRID_SEARCH_MIN_KEYS
+/* Entries of the root object with key_count_ keys */
+#define HYBRID_ROOT_ENTRIES(key_count_) ((key_count_) >= HYBRID_KEYS ? (key_count_) : 0)
+
+/* Keys are referenced, not copied, so their names must outlive the tree. */
+static char g_hybrid_names[2 * HYBRID_KEYS + 8][8];
+
+static size_t hybrid_entries(struct jes_context *ctx)
+{
+    return jes_get_workspace_stat(ctx).hash_table_entry_count;
+}
+
+static int hybrid_all_found(struct jes_context *ctx, struct jes_element *object, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++) {
+        if (jes_get_key(ctx, object, g_hybrid_names[i]) == NULL) return 0;
+    }
+    return 1;
+}
+
+static void test_hybrid_search(void)
+{
+    printf("\nGroup 13: hybrid search\n");
+
+    static uint8_t ws_hybrid[JES_REQUIRED_SIZE(512)];
+    struct jes_context *ctx = jes_init(ws_hybrid, sizeof(ws_hybrid), JES_SEARCH_HASHED);
+    if (!ctx) { fail("G13-setup", "ctx init failed"); return; }
+
+    size_t i;
+    size_t large_keys = HYBRID_KEYS + 4;
+    for (i = 0; i < sizeof(g_hybrid_names) / sizeof(g_hybrid_names[0]); i++) {
+        snprintf(g_hybrid_names[i], sizeof(g_hybrid_names[i]), "k%u", (unsigned)i);
+    }
+
+    if (jes_load(ctx, "{\"small\":{},\"large\":{}}", 23) != JES_NO_ERROR) {
+        fail("G13-setup", "load failed"); return;
+    }
+    struct jes_element *root = jes_get_root(ctx);
+    struct jes_element *small = jes_get_value(ctx, root, "small");
+    struct jes_element *large = jes_get_value(ctx, root, "large");
+    for (i = 0; i < large_keys; i++) {
+        struct jes_element *k = jes_add_key(ctx, large, g_hybrid_names[i], strlen(g_hybrid_names[i]));
+        jes_add_element(ctx, k, JES_NUMBER, "1", 1);
+    }
+    for (i = 0; i + 1 < HYBRID_KEYS; i++) {
+        struct jes_element *k = jes_add_key(ctx, small, g_hybrid_names[i], strlen(g_hybrid_names[i]));
+        jes_add_element(ctx, k, JES_NUMBER, "2", 1);
+    }
+
+    /* G13-01 */ CHECK("G13-01 only the large object is hashed",
+                       hybrid_entries(ctx) == large_keys + HYBRID_ROOT_ENTRIES(2));
+    /* G13-02 */ CHECK("G13-02 keys of both objects found",
+                       hybrid_all_found(ctx, large, large_keys) &&
+                       hybrid_all_found(ctx, small, HYBRID_KEYS - 1));
+    /* G13-03 */ CHECK_NULL("G13-03 missing key in small object",
+                            jes_get_key(ctx, small, g_hybrid_names[HYBRID_KEYS]));
+    /* G13-04 */ CHECK_NULL("G13-04 missing key in large object",
+                            jes_get_key(ctx, large, g_hybrid_names[large_keys]));
+
+    size_t before = hybrid_entries(ctx);
+    struct jes_element *k = jes_add_key(ctx, small, g_hybrid_names[HYBRID_KEYS - 1],
+                                        strlen(g_hybrid_names[HYBRID_KEYS - 1]));
+    jes_add_element(ctx, k, JES_NUMBER, "3", 1);
+    /* G13-05 */ CHECK("G13-05 object promoted at the threshold",
+                       hybrid_entries(ctx) == before + HYBRID_KEYS);
+    /* G13-06 */ CHECK("G13-06 keys of the promoted object found",
+                       hybrid_all_found(ctx, small, HYBRID_KEYS));
+    /* G13-07 */ CHECK_NULL("G13-07 duplicate key rejected in promoted object",
+                            jes_add_key(ctx, small, g_hybrid_names[0], strlen(g_hybrid_names[0])));
+
+    jes_delete_element(ctx, jes_get_key(ctx, small, g_hybrid_names[0]));
+    /* G13-08 */ CHECK("G13-08 object demoted below the threshold",
+                       hybrid_entries(ctx) == before);
+    /* G13-09 */ CHECK("G13-09 keys of the demoted object found",
+                       jes_get_key(ctx, small, g_hybrid_names[0]) == NULL &&
+                       (HYBRID_KEYS == 1 || jes_get_key(ctx, small, g_hybrid_names[HYBRID_KEYS - 1]) != NULL));
+
+    /* G13-10 */ CHECK("G13-10 compaction keeps the index",
+                       jes_compact(ctx) == JES_NO_ERROR &&
+                       hybrid_entries(ctx) == before);
+    root = jes_get_root(ctx);
+    large = jes_get_value(ctx, root, "large");
+    /* G13-11 */ CHECK("G13-11 rehash keeps the index",
+                       jes_set_hash_seed(ctx, 0x1234u) == JES_NO_ERROR &&
+                       hybrid_entries(ctx) == before &&
+                       hybrid_all_found(ctx, large, large_keys));
+
+    jes_delete_element(ctx, jes_get_key(ctx, root, "large"));
+    /* G13-12 */ CHECK("G13-12 deleting a large object removes its entries",
+                       hybrid_entries(ctx) == HYBRID_ROOT_ENTRIES(1));
+    /* G13-13 */ CHECK("G13-13 tree renders", renders_ok(ctx));
+}
+#endif
+
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+/* =========================================================================
+ * Group 14 — lazy hash index (JES_ENABLE_LAZY_HASH_INDEX)
+ * jes_load() leaves the keys unhashed until the first lookup.
+ * ========================================================================= */
+
+/* Hash table entries of the test document: {a,b,f}, {c,d} and {e} */
+#ifdef JES_ENABLE_HYBRID_SEARCH
+  #define LAZY_OBJECT_ENTRIES(key_count_) ((key_count_) >= JES_HYBRID_SEARCH_MIN_KEYS ? (key_count_) : 0)
+#else
+  #define LAZY_OBJECT_ENTRIES(key_count_) (key_count_)
+#endif
+#define LAZY_ENTRIES (LAZY_OBJECT_ENTRIES(3) + LAZY_OBJECT_ENTRIES(2) + LAZY_OBJECT_ENTRIES(1))
+
+#ifdef JES_ENABLE_WORKSPACE_GROW
+static void *lazy_grow(void *buffer, size_t size)
+{
+    if (size == 0) {
+        free(buffer);
+        return NULL;
+    }
+    return realloc(buffer, size);
+}
+
+/* Building the index may grow the workspace, only when a key is added. */
+static void test_lazy_hash_index_grow(void)
+{
+    static uint64_t ws_grow[1024];
+    static char json[2000 * 12];
+    size_t pos = 0;
+    size_t workspace_size;
+    int i;
+
+    struct jes_context *ctx = jes_init_growable(ws_grow, sizeof(ws_grow), JES_SEARCH_HASHED, lazy_grow);
+    if (!ctx) { fail("G14-grow-setup", "ctx init failed"); return; }
+
+    pos += sprintf(&json[pos], "{");
+    for (i = 0; i < 2000; i++) {
+        pos += sprintf(&json[pos], "%s\"k%d\":%d", i ? "," : "", i, i);
+    }
+    pos += sprintf(&json[pos], "}");
+
+    if (jes_load(ctx, json, pos) != JES_NO_ERROR) {
+        fail("G14-grow-setup", "load failed"); jes_reset(ctx); return;
+    }
+    workspace_size = jes_get_workspace_size(ctx);
+    /* G14-14 */ CHECK("G14-14 a lookup does not grow the workspace",
+                       jes_get_key(ctx, jes_get_root(ctx), "k1999") != NULL &&
+                       jes_get_workspace_size(ctx) == workspace_size);
+
+    /* Back to the initial workspace */
+    jes_reset(ctx);
+    jes_load(ctx, json, pos);
+    struct jes_element *key = jes_add_key(ctx, jes_get_root(ctx), "zz", 2);
+    /* G14-15 */ CHECK("G14-15 adding a key builds the index of a growing workspace",
+                       key != NULL && jes_get_status(ctx) == JES_NO_ERROR &&
+                       jes_get_key(ctx, jes_get_root(ctx), "zz") == key);
+    /* G14-16 */ CHECK("G14-16 all keys are indexed",
+                       jes_get_workspace_stat(ctx).hash_table_entry_count == 2001 &&
+                       jes_get_key(ctx, jes_get_root(ctx), "k0") != NULL);
+    /* G14-17 */ CHECK_NULL("G14-17 duplicate rejected after the build", jes_add_key(ctx, jes_get_root(ctx), "k7", 2));
+
+    jes_reset(ctx);
+}
+#endif
+
+static void test_lazy_hash_index(void)
+{
+    printf("\nGroup 14: lazy hash index\n");
+
+    static uint8_t ws_lazy[JES_REQUIRED_SIZE(64)];
+    struct jes_context *ctx = jes_init(ws_lazy, sizeof(ws_lazy), JES_SEARCH_HASHED);
+    if (!ctx) { fail("G14-setup", "ctx init failed"); return; }
+
+    const char *json = "{\"a\":1,\"b\":{\"c\":2,\"d\":[{\"e\":3}]},\"f\":4}";
+    if (jes_load(ctx, json, strlen(json)) != JES_NO_ERROR) {
+        fail("G14-setup", "load failed"); return;
+    }
+    struct jes_element *root = jes_get_root(ctx);
+
+    /* G14-01 */ CHECK("G14-01 no key hashed by jes_load",
+                       jes_get_workspace_stat(ctx).hash_table_entry_count == 0);
+    /* G14-02 */ CHECK("G14-02 rendering does not build the index",
+                       renders_ok(ctx) && jes_get_workspace_stat(ctx).hash_table_entry_count == 0);
+    /* G14-03 */ CHECK_NOTNULL("G14-03 first lookup finds the key", jes_get_key(ctx, root, "b.c"));
+    /* G14-04 */ CHECK("G14-04 first lookup builds the whole index",
+                       jes_get_workspace_stat(ctx).hash_table_entry_count == LAZY_ENTRIES);
+    /* G14-05 */ CHECK_NULL("G14-05 duplicate key rejected after build",
+                            jes_add_key(ctx, root, "f", 1));
+    /* G14-06 */ CHECK_STATUS("G14-06 duplicate key status", ctx, JES_DUPLICATE_KEY);
+
+    jes_load(ctx, json, strlen(json));
+    root = jes_get_root(ctx);
+    /* G14-07 */ CHECK("G14-07 reload defers the index again",
+                       jes_get_workspace_stat(ctx).hash_table_entry_count == 0);
+    /* G14-08 */ CHECK_NULL("G14-08 adding a key builds the index first",
+                            jes_add_key(ctx, root, "a", 1));
+
+    const char *dup = "{\"k\":1,\"k\":2}";
+    /* G14-09 */ CHECK("G14-09 duplicate keys are not rejected by jes_load",
+                       jes_load(ctx, dup, strlen(dup)) == JES_NO_ERROR);
+    struct jes_element *v = jes_get_value(ctx, jes_get_root(ctx), "k");
+    /* G14-10 */ CHECK("G14-10 the first duplicate is found", v && v->length == 1 && jes_get_element_value(ctx, v)[0] == '1');
+
+    static uint64_t image[512];
+    jes_load(ctx, json, strlen(json));
+    size_t image_size = jes_save_image(ctx, image, sizeof(image));
+    /* G14-11 */ CHECK("G14-11 image of a deferred tree restores",
+                       image_size > 0 && jes_load_image(ctx, image, image_size) == JES_NO_ERROR &&
+                       jes_get_key(ctx, jes_get_root(ctx), "b.d") != NULL);
+
+    jes_load(ctx, json, strlen(json));
+    /* G14-12 */ CHECK("G14-12 jes_freeze builds the index",
+                       jes_freeze(ctx) == JES_NO_ERROR &&
+                       jes_get_workspace_stat(ctx).hash_table_entry_count == LAZY_ENTRIES);
+    /* G14-13 */ CHECK_NOTNULL("G14-13 frozen lookup", jes_get_key_r(ctx, jes_get_root(ctx), "b.d", NULL));
+
+#ifdef JES_ENABLE_WORKSPACE_GROW
+    test_lazy_hash_index_grow();
+#endif
+}
+#endif
+
 /* =========================================================================
  * main
  * ========================================================================= */
 
+/* =========================================================================
+ * Group 15 — clearing the hash table
+ * jes_reset() and jes_load() start a new generation of hash slots instead of
+ * emptying the whole table. Slots of older generations must never be found.
+ * ========================================================================= */
+
+static void test_hash_table_generations(void)
+{
+    printf("\nGroup 15: clearing the hash table\n");
+
+    static uint8_t ws_hashed[JES_REQUIRED_SIZE(256)];
+    static uint64_t image[1024];
+    static char docs[2][512];
+    static char names[2][20][8];
+    struct jes_context *ctx = jes_init(ws_hashed, sizeof(ws_hashed), JES_SEARCH_HASHED);
+    struct jes_element *root = NULL;
+    size_t round;
+    size_t i;
+    size_t pos;
+    int ok = 1;
+
+    if (!ctx) { fail("G15-setup", "ctx init failed"); return; }
+
+    for (round = 0; round < 2; round++) {
+        pos = sprintf(docs[round], "{");
+        for (i = 0; i < 20; i++) {
+            sprintf(names[round][i], "%c%d", round ? 'b' : 'a', (int)i);
+            pos += sprintf(&docs[round][pos], "%s\"%s\":%d", i ? "," : "", names[round][i], (int)i);
+        }
+        sprintf(&docs[round][pos], "}");
+    }
+
+    jes_load(ctx, docs[0], strlen(docs[0]));
+    jes_get_key(ctx, jes_get_root(ctx), names[0][0]);
+    jes_reset(ctx);
+    /* G15-01 */ CHECK("G15-01 reset empties the hash table",
+                       jes_get_workspace_stat(ctx).hash_table_entry_count == 0);
+
+    /* More loads than generations of a slot */
+    for (round = 0; ok && round < 300; round++) {
+        ok = jes_load(ctx, docs[round % 2], strlen(docs[round % 2])) == JES_NO_ERROR;
+        root = jes_get_root(ctx);
+        for (i = 0; ok && i < 20; i++) {
+            ok = jes_get_key(ctx, root, names[round % 2][i]) != NULL &&
+                 jes_get_key(ctx, root, names[(round + 1) % 2][i]) == NULL;
+        }
+    }
+    /* G15-02 */ CHECK("G15-02 only the keys of the last load are found", ok);
+
+    for (i = 0; ok && i < 15; i++) {
+        ok = jes_delete_element(ctx, jes_get_key(ctx, root, names[1][i])) == JES_NO_ERROR;
+    }
+    for (i = 0; ok && i < 20; i++) {
+        ok = (jes_get_key(ctx, root, names[1][i]) != NULL) == (i >= 15);
+    }
+    /* G15-03 */ CHECK("G15-03 deleting keys after many loads", ok);
+
+    {
+        size_t size = jes_save_image(ctx, image, sizeof(image));
+        size_t entry_count = jes_get_workspace_stat(ctx).hash_table_entry_count;
+        ok = size > 0 && jes_load_image(ctx, image, size) == JES_NO_ERROR;
+        /* G15-04 */ CHECK("G15-04 an image holds only the current entries",
+                           ok && jes_get_workspace_stat(ctx).hash_table_entry_count == entry_count &&
+                           jes_get_key(ctx, jes_get_root(ctx), names[1][19]) != NULL);
+    }
+}
+
 int main(void)
 {
     printf("=== JES Key API Tests ===\n");
@@ -612,6 +1108,16 @@ int main(void)
     test_delete_key();
     test_hashed_search();
     test_delete_key_with_multiple_values();
+    test_key_value_navigation();
+    test_order_after_edits();
+    test_hash_seed();
+#ifdef JES_ENABLE_HYBRID_SEARCH
+    test_hybrid_search();
+#endif
+#ifdef JES_ENABLE_LAZY_HASH_INDEX
+    test_lazy_hash_index();
+#endif
+    test_hash_table_generations();
 
     printf("\n=== Results: %d passed, %d failed ===\n", g_passed, g_failed);
     return g_failed == 0 ? 0 : 1;
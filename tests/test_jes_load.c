@@ -11,14 +11,24 @@
  *   4. Structural errors      — mismatched brackets, missing tokens, etc.
  *   5. Token-level errors     — bad literals, invalid escapes, invalid unicode
  *   6. Truncated input        — every prefix of a valid document must fail
+ *   7. Growable workspace     — loading and editing beyond the initial workspace
+ *                              (requires -DJES_ENABLE_WORKSPACE_GROW)
+ *   8. Workspace estimate     — jes_estimate() sizes a workspace that fits
+ *                              the document exactly, also for random
+ *                              documents; hash slot size with
+ *                              -DJES_USE_COMPACT_HASH_ENTRY
+ *   9. File mapping           — jes_load_file() parses a mapped file and keeps
+ *                              the mapping until the next load or reset
+ *                              (requires -DJES_ENABLE_FILE_MAPPING)
  *
  * Build (from repo root):
  *   gcc jes_load_test.c src/jes.c src/jes_tokenizer.c src/jes_parser.c \
  *       src/jes_serializer.c src/jes_tree.c src/jes_hash_table.c \
- *       src/jes_logger.c -std=c99 -DNDEBUG -o jes_load_test
+ *       src/jes_logger.c src/jes_file.c -std=c99 -DNDEBUG -o jes_load_test
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include "../src/jes.h"
@@ -443,6 +453,425 @@ static void test_group_truncated_input(void)
     }
 }
 
+/* =========================================================================
+ * Group 7 — Growable workspace
+ * ========================================================================= */
+
+static void check(const char *label, int cond)
+{
+    if (cond) pass(label); else fail(label, "condition was false");
+}
+
+#ifdef JES_ENABLE_WORKSPACE_GROW
+
+static int    g_grow_calls;
+static int    g_release_calls;
+static size_t g_grow_limit;
+
+static void *test_grow(void *buffer, size_t size)
+{
+    if (size == 0) {
+        g_release_calls++;
+        free(buffer);
+        return NULL;
+    }
+    if (size > g_grow_limit) return NULL;
+    g_grow_calls++;
+    return realloc(buffer, size);
+}
+
+static void test_group_workspace_grow(enum jes_search_mode mode)
+{
+    static uint8_t ws[JES_REQUIRED_SIZE(8)];
+    /* Keys added through the API must outlive the context */
+    static char names[500][8];
+    char json[4096];
+    char out[4096];
+    size_t pos = 0;
+    int i;
+
+    printf("\nGroup 7: Growable workspace (%s)\n",
+           mode == JES_SEARCH_HASHED ? "hashed" : "linear");
+
+    pos += sprintf(&json[pos], "{");
+    for (i = 0; i < 100; i++) {
+        pos += sprintf(&json[pos], "%s\"k%d\":{\"a\":[%d,true],\"b\":\"s\"}", i ? "," : "", i, i);
+    }
+    pos += sprintf(&json[pos], "}");
+
+    g_grow_calls = 0;
+    g_release_calls = 0;
+    g_grow_limit = (size_t)-1;
+
+    /* Without a grow callback the workspace is too small */
+    struct jes_context *ctx = jes_init(ws, sizeof(ws), mode);
+    check("G7-01 fixed workspace runs out of memory",
+          ctx && jes_load(ctx, json, pos) == JES_OUT_OF_MEMORY);
+
+    ctx = jes_init_growable(ws, sizeof(ws), mode, test_grow);
+    if (!ctx) { fail("G7-setup", "ctx init"); return; }
+
+    check("G7-02 load succeeds", jes_load(ctx, json, pos) == JES_NO_ERROR);
+    check("G7-03 workspace grew several times", g_grow_calls > 1);
+    check("G7-04 workspace size reports the grown buffer",
+          jes_get_workspace_size(ctx) > sizeof(ws));
+    check("G7-05 renders unchanged",
+          jes_render(ctx, out, sizeof(out), true) > 0 && strcmp(out, json) == 0);
+    check("G7-06 deep key found", jes_get_value(ctx, jes_get_root(ctx), "k57.b") != NULL);
+
+    /* Editing grows the workspace further. Values outside the JSON data
+       take an extra node in compact node mode. */
+    int calls = g_grow_calls;
+    int added = 0;
+    for (i = 0; i < 500; i++) {
+        snprintf(names[i], sizeof(names[i]), "n%d", i);
+        struct jes_element *key = jes_add_key(ctx, jes_get_root(ctx), names[i], strlen(names[i]));
+        if (key && jes_update_key_value(ctx, key, JES_STRING, "value", 5)) added++;
+    }
+    check("G7-07 edits succeed", added == 500);
+    check("G7-08 edits grew the workspace", g_grow_calls > calls);
+    check("G7-09 added key found", jes_get_value(ctx, jes_get_root(ctx), "n499") != NULL);
+    check("G7-10 loaded key found", jes_get_value(ctx, jes_get_root(ctx), "k99.a") != NULL);
+
+    /* The grown buffer is kept for the next document */
+    calls = g_grow_calls;
+    check("G7-11 reload succeeds", jes_load(ctx, json, pos) == JES_NO_ERROR);
+    check("G7-12 reload does not grow", g_grow_calls == calls);
+    check("G7-13 no buffer released", g_release_calls == 0);
+
+    check("G7-14 reset succeeds", jes_reset(ctx) == JES_NO_ERROR);
+    check("G7-15 reset releases the buffer", g_release_calls == 1);
+    check("G7-16 workspace size restored", jes_get_workspace_size(ctx) == sizeof(ws));
+
+    /* A refused request fails the load */
+    g_grow_limit = 2 * sizeof(ws);
+    check("G7-17 refused growth runs out of memory", jes_load(ctx, json, pos) == JES_OUT_OF_MEMORY);
+    jes_reset(ctx);
+}
+
+#endif
+
+/* =========================================================================
+ * Group 8 — Workspace estimate
+ * ========================================================================= */
+
+/* Loads json into a workspace of the given size. */
+static jes_status load_sized(const char *json, size_t length, size_t size,
+                             enum jes_search_mode mode, size_t *element_count)
+{
+    void *ws = malloc(size);
+    struct jes_context *ctx = jes_init(ws, size, mode);
+    jes_status st = JES_BUFFER_TOO_SMALL;
+
+    if (ctx) {
+        st = jes_load(ctx, json, length);
+        if (element_count) *element_count = jes_get_element_count(ctx);
+    }
+    free(ws);
+    return st;
+}
+
+/* Small pseudo-random generator, so every run checks the same documents */
+static uint32_t g_random = 1;
+
+static uint32_t next_random(void)
+{
+    g_random = g_random * 1103515245u + 12345u;
+    return (g_random >> 16) & 0x7FFF;
+}
+
+/* Writes a random value of nested objects, arrays and scalars. Returns its length. */
+static size_t random_value(char *out, int depth)
+{
+    static const char *scalars[] = { "null", "-12.5e3", "\"s\\\"x\\\\\"", "\"\"", "true" };
+    size_t pos = 0;
+    uint32_t kind = next_random() % (depth > 3 ? 5 : 8);
+    uint32_t count;
+    uint32_t i;
+
+    if (kind < 5) {
+        return (size_t)sprintf(out, "%s", scalars[kind]);
+    }
+    if (kind == 5) {
+        count = next_random() % (depth > 0 ? 6 : 12);
+        out[pos++] = '[';
+        for (i = 0; i < count; i++) {
+            if (i) out[pos++] = ',';
+            pos += random_value(&out[pos], depth + 1);
+        }
+        out[pos++] = ']';
+        return pos;
+    }
+    count = next_random() % (depth > 0 ? 5 : 25);
+    out[pos++] = '{';
+    for (i = 0; i < count; i++) {
+        pos += (size_t)sprintf(&out[pos], "%s\"k%u\":", i ? "," : "", (unsigned)i);
+        pos += random_value(&out[pos], depth + 1);
+    }
+    out[pos++] = '}';
+    return pos;
+}
+
+static void test_group_estimate(enum jes_search_mode mode)
+{
+    char json[4096];
+    char label[128];
+    size_t pos = 0;
+    size_t i;
+    int exact = 1;
+    int fits = 1;
+
+    printf("\nGroup 8: Workspace estimate (%s)\n",
+           mode == JES_SEARCH_HASHED ? "hashed" : "linear");
+
+    /* Every valid document loads into its estimate and allocates the
+       estimated node count. */
+    for (i = 0; i < sizeof(VALID) / sizeof(VALID[0]); i++) {
+        const char *doc = VALID[i].json;
+        struct jes_workspace_estimate est = jes_estimate(doc, strlen(doc), mode);
+        size_t count = 0;
+        if (load_sized(doc, strlen(doc), est.workspace_size, mode, &count) != JES_NO_ERROR) {
+            fits = 0;
+            snprintf(label, sizeof(label), "G8-01 \"%s\" fits its estimate", VALID[i].description);
+            fail(label, "load failed");
+        }
+        if (count != est.node_count) {
+            exact = 0;
+            snprintf(label, sizeof(label), "G8-02 \"%s\" node count", VALID[i].description);
+            fail(label, "estimated node count differs");
+        }
+    }
+    if (fits) pass("G8-01 valid documents fit their estimate");
+    if (exact) pass("G8-02 estimated node counts are exact");
+
+    /* Strings containing structural characters and escaped quotes */
+    {
+        const char *doc = "{\"a\\\":{\" : \"[1,\\\\\", \"b\":[\"x:\",-1.5e3,null]}";
+        struct jes_workspace_estimate est = jes_estimate(doc, strlen(doc), mode);
+        size_t count = 0;
+        check("G8-03 escaped quotes counted",
+              est.key_count == 2 &&
+              load_sized(doc, strlen(doc), est.workspace_size, mode, &count) == JES_NO_ERROR &&
+              count == est.node_count);
+    }
+
+    /* A larger object of nested members */
+    pos += sprintf(&json[pos], "{");
+    for (i = 0; i < 100; i++) {
+        pos += sprintf(&json[pos], "%s\"k%d\":{\"a\":[%d,true],\"b\":\"s\"}", i ? "," : "", (int)i, (int)i);
+    }
+    pos += sprintf(&json[pos], "}");
+    {
+        struct jes_workspace_estimate est = jes_estimate(json, pos, mode);
+        size_t count = 0;
+        check("G8-04 key count", est.key_count == 300);
+        check("G8-05 document fits its estimate",
+              load_sized(json, pos, est.workspace_size, mode, &count) == JES_NO_ERROR &&
+              count == est.node_count);
+#if defined(JES_ENABLE_HYBRID_SEARCH) || defined(JES_ENABLE_LAZY_HASH_INDEX) || defined(JES_USE_COMPACT_NODE)
+        /* The estimate hashes all keys. Small objects leave slack in the hash
+           table, a deferred index is not built by jes_load(). Small nodes let
+           the hash table share bound the estimate, a node less only trims its
+           alignment slack. */
+        if (mode == JES_SEARCH_LINEAR)
+#endif
+        check("G8-06 one node less runs out of memory",
+              load_sized(json, pos, est.workspace_size - jes_node_size(), mode, NULL) != JES_NO_ERROR);
+        if (mode == JES_SEARCH_LINEAR) {
+            check("G8-07 estimate is the minimal size",
+                  load_sized(json, pos, est.workspace_size - 1, mode, NULL) == JES_OUT_OF_MEMORY);
+        }
+    }
+
+    {
+        struct jes_workspace_estimate est = jes_estimate(json, 0, mode);
+        check("G8-08 empty input needs a minimal workspace",
+              est.node_count == 0 && est.workspace_size > jes_context_size());
+    }
+
+#ifdef JES_USE_COMPACT_HASH_ENTRY
+    if (mode == JES_SEARCH_HASHED) {
+        /* An 8-byte entry and a control byte per slot, in whole groups of 16 */
+        static uint64_t ws[4096];
+        struct jes_context *ctx = jes_init(ws, sizeof(ws), mode);
+        struct jes_workspace_stat stat = jes_get_workspace_stat(ctx);
+        check("G8-09 compact hash entries take 9 bytes per slot",
+              ctx != NULL && stat.hash_table_capacity * 9 <= stat.hash_table_size &&
+              (stat.hash_table_capacity + 16) * 9 > stat.hash_table_size);
+    }
+#endif
+
+    /* Random documents load into exactly their estimate. The node pool and an
+       adaptive hash table pass through many capacities on the way. */
+    {
+        static char doc[1 << 16];
+        int all_fit = 1;
+        g_random = 1;
+        for (i = 0; i < 1000; i++) {
+            size_t length = (size_t)sprintf(doc, "{\"root\":");
+            length += random_value(&doc[length], 0);
+            doc[length++] = '}';
+            struct jes_workspace_estimate est = jes_estimate(doc, length, mode);
+            if (load_sized(doc, length, est.workspace_size, mode, NULL) != JES_NO_ERROR) {
+                if (all_fit) fail("G8-10 random documents fit their estimate", doc);
+                all_fit = 0;
+            }
+        }
+        if (all_fit) pass("G8-10 random documents fit their estimate");
+    }
+}
+
+#ifdef JES_ENABLE_FILE_MAPPING
+
+/* =========================================================================
+ * Group 9 — File mapping
+ * ========================================================================= */
+
+static void test_group_file_mapping(void)
+{
+    static uint8_t ws[JES_REQUIRED_SIZE(64)];
+    static const char path[] = "jes_load_test.json";
+    const char *json = "{\"file\":[1,2,3],\"mapped\":true}";
+    char out[128];
+
+    printf("\nGroup 9: File mapping\n");
+
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) { fail("G9-setup", "can not write the test file"); return; }
+    fwrite(json, 1, strlen(json), fp);
+    fclose(fp);
+
+    struct jes_context *ctx = jes_init(ws, sizeof(ws), JES_SEARCH_HASHED);
+    check("G9-01 load file", jes_load_file(ctx, path) == JES_NO_ERROR);
+    check("G9-02 renders the file",
+          jes_render(ctx, out, sizeof(out), true) > 0 && strcmp(out, json) == 0);
+    check("G9-03 key lookup", jes_get_value(ctx, jes_get_root(ctx), "mapped") != NULL);
+
+    /* The previous tree stays intact when the new file can not be loaded */
+    check("G9-04 missing file", jes_load_file(ctx, "jes_load_test.missing") == JES_INVALID_PARAMETER &&
+                                jes_get_value(ctx, jes_get_root(ctx), "file") != NULL);
+    check("G9-05 NULL path", jes_load_file(ctx, NULL) == JES_INVALID_PARAMETER);
+    check("G9-06 NULL context", jes_load_file(NULL, path) == JES_INVALID_CONTEXT);
+
+    /* The mapping is released by the next load */
+    check("G9-07 load from memory", jes_load(ctx, "[true]", 6) == JES_NO_ERROR &&
+                                    jes_render(ctx, out, sizeof(out), true) > 0 && strcmp(out, "[true]") == 0);
+
+    fp = fopen(path, "wb");
+    if (fp != NULL) { fwrite("{\"a\":", 1, 5, fp); fclose(fp); }
+    check("G9-08 parse error", jes_load_file(ctx, path) == JES_UNEXPECTED_EOF);
+    check("G9-09 reset", jes_reset(ctx) == JES_NO_ERROR);
+
+    fp = fopen(path, "wb");
+    if (fp != NULL) { fclose(fp); }
+    check("G9-10 empty file", jes_load_file(ctx, path) == JES_INVALID_PARAMETER);
+
+    remove(path);
+}
+
+#endif
+
+#ifdef JES_ENABLE_ADAPTIVE_WORKSPACE
+
+/* =========================================================================
+ * Group 10 — Adaptive workspace
+ * ========================================================================= */
+
+static void test_group_adaptive_workspace(void)
+{
+    static uint64_t ws[6144];
+    static uint64_t ws2[6144];
+    static uint64_t image[8192];
+    static char json[16384];
+    static char names[200][8];
+    struct jes_context *ctx;
+    struct jes_workspace_stat stat;
+    struct jes_element *list;
+    size_t linear_capacity;
+    size_t pool_capacity;
+    size_t pos = 0;
+    size_t i;
+    int ok;
+
+    printf("\nGroup 10: Adaptive workspace\n");
+
+    ctx = jes_init(ws, sizeof(ws), JES_SEARCH_LINEAR);
+    linear_capacity = jes_get_workspace_stat(ctx).node_mng_capacity;
+
+    ctx = jes_init(ws, sizeof(ws), JES_SEARCH_HASHED);
+    stat = jes_get_workspace_stat(ctx);
+    check("G10-01 the hash table starts with a group",
+          ctx != NULL && stat.hash_table_capacity == 16 &&
+          stat.node_mng_size * 10 > (stat.workspace_size - stat.context_size) * 9);
+
+    /* An array of almost as many nodes as a linear workspace holds */
+    pos += sprintf(&json[pos], "[");
+    for (i = 0; i + 4 < linear_capacity; i++) {
+        pos += sprintf(&json[pos], "%s0", i ? "," : "");
+    }
+    pos += sprintf(&json[pos], "]");
+    check("G10-02 nodes take the memory of the hash table",
+          jes_load(ctx, json, pos) == JES_NO_ERROR &&
+          jes_get_workspace_stat(ctx).hash_table_capacity <= 16);
+
+    pos = 0;
+    pos += sprintf(&json[pos], "{\"list\":[]");
+    for (i = 1; i < 300; i++) {
+        pos += sprintf(&json[pos], ",\"k%d\":0", (int)i);
+    }
+    pos += sprintf(&json[pos], "}");
+    ok = jes_load(ctx, json, pos) == JES_NO_ERROR &&
+         jes_get_key(ctx, jes_get_root(ctx), "k1") != NULL &&
+         jes_get_key(ctx, jes_get_root(ctx), "k299") != NULL &&
+         jes_get_key(ctx, jes_get_root(ctx), "k300") == NULL;
+    stat = jes_get_workspace_stat(ctx);
+    check("G10-03 the hash table grows with the keys",
+          ok && stat.hash_table_entry_count == 300 && stat.hash_table_capacity >= 300);
+
+    pool_capacity = stat.node_mng_capacity;
+    ok = 1;
+    for (i = 1; i < 300; i++) {
+        snprintf(names[0], sizeof(names[0]), "k%d", (int)i);
+        ok = ok && jes_delete_element(ctx, jes_get_key(ctx, jes_get_root(ctx), names[0])) == JES_NO_ERROR;
+    }
+    /* Appends until the pool is full. Added values may need a holder node. */
+    list = jes_get_value(ctx, jes_get_root(ctx), "list");
+    while (ok && jes_append_array_value(ctx, list, JES_NUMBER, "1", 1) != NULL) {
+    }
+    stat = jes_get_workspace_stat(ctx);
+    check("G10-04 a full node pool takes unused slots back",
+          ok && stat.node_mng_node_count > pool_capacity && stat.hash_table_capacity < 16 &&
+          stat.node_mng_node_count + 4 > linear_capacity);
+
+    /* Released nodes return to the hash table once the pool is compacted */
+    ok = jes_delete_element(ctx, jes_get_key(ctx, jes_get_root(ctx), "list")) == JES_NO_ERROR &&
+         jes_compact(ctx) == JES_NO_ERROR;
+    for (i = 0; ok && i < 200; i++) {
+        snprintf(names[i], sizeof(names[i]), "n%d", (int)i);
+        ok = jes_add_key(ctx, jes_get_root(ctx), names[i], strlen(names[i])) != NULL;
+    }
+    for (i = 0; ok && i < 200; i++) {
+        ok = jes_get_key(ctx, jes_get_root(ctx), names[i]) != NULL;
+    }
+    stat = jes_get_workspace_stat(ctx);
+    check("G10-05 added keys grow the hash table again",
+          ok && stat.hash_table_entry_count == 200 && stat.hash_table_capacity >= 200);
+
+    /* A fresh workspace makes room for the entries of an image */
+    {
+        size_t size = jes_save_image(ctx, image, sizeof(image));
+        struct jes_context *ctx2 = jes_init(ws2, sizeof(ws2), JES_SEARCH_HASHED);
+        ok = size > 0 && jes_load_image(ctx2, image, size) == JES_NO_ERROR;
+        for (i = 0; ok && i < 200; i++) {
+            ok = jes_get_key(ctx2, jes_get_root(ctx2), names[i]) != NULL;
+        }
+        check("G10-06 image entries are loaded into a grown table",
+              ok && jes_get_workspace_stat(ctx2).hash_table_entry_count == 200);
+    }
+}
+
+#endif
+
 /* =========================================================================
  * main
  * ========================================================================= */
@@ -457,6 +886,18 @@ int main(void)
     test_group_structural_errors();
     test_group_token_errors();
     test_group_truncated_input();
+#ifdef JES_ENABLE_WORKSPACE_GROW
+    test_group_workspace_grow(JES_SEARCH_LINEAR);
+    test_group_workspace_grow(JES_SEARCH_HASHED);
+#endif
+    test_group_estimate(JES_SEARCH_LINEAR);
+    test_group_estimate(JES_SEARCH_HASHED);
+#ifdef JES_ENABLE_FILE_MAPPING
+    test_group_file_mapping();
+#endif
+#ifdef JES_ENABLE_ADAPTIVE_WORKSPACE
+    test_group_adaptive_workspace();
+#endif
 
     printf("\n=== Results: %d passed, %d failed ===\n", g_passed, g_failed);
     return g_failed == 0 ? 0 : 1;
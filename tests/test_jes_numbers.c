@@ -284,10 +284,10 @@ static void test_group_valid_numbers(void)
         /* ── stored token must match expected literal ────────────────── */
         size_t exp_len = strlen(tc->expected_token);
         if (val->length != (uint16_t)exp_len ||
-            memcmp(val->value, tc->expected_token, exp_len) != 0) {
+            memcmp(jes_get_element_value(ctx, val), tc->expected_token, exp_len) != 0) {
             char m[128];
             snprintf(m, sizeof(m), "value mismatch: got \"%.*s\", expected \"%s\"",
-                     (int)val->length, val->value, tc->expected_token);
+                     (int)val->length, jes_get_element_value(ctx, val), tc->expected_token);
             fail(label, m);
             continue;
         }
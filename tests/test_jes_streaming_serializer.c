@@ -371,7 +371,7 @@ static void test_group_roundtrip(void)
         struct jes_element *v = jes_get_key_value(ctx, k_val);
         CHECK("G6-04 value type == JES_NUMBER", v && v->type == JES_NUMBER);
         CHECK("G6-05 value data == \"23\"",
-              v && v->length == 2 && v->value[0] == '2' && v->value[1] == '3');
+              v && v->length == 2 && memcmp(jes_get_element_value(ctx, v), "23", 2) == 0);
     }
 }
 